@@ -0,0 +1,376 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    The throughput of the searchers, compared with std::search and (where
+    the C library has it) memmem, over a grid of cases:
+
+        * pattern lengths of 1 to 256 bytes
+        * random corpora over alphabets of 2, 4, 26 and 255 symbols
+        * corpus sizes from 1KB to 1GB (by factors of 32)
+        * the pattern at the begin, the middle or the end of the corpus,
+            or absent
+
+    Any files named on the command line are searched as well (at their own
+    size, with patterns cut from the file), for example
+        search_benchmark ../test/search_test_data/0001.corpus
+
+    Options:
+        --max-size=N    The largest random corpus, with a K, M or G suffix. The
+                        default is 32M; --max-size=1G runs the whole grid, which
+                        takes an hour or more
+        --min-time=S    The shortest time to measure each case for (default 0.05s)
+
+    The results are written to stdout as JSON, one object per case and
+    searcher. "bytes" is the number of bytes the search had to get
+    through: up to the end of the first match, or the whole corpus if
+    there isn't one. "cycles_per_byte" is measured with the time stamp
+    counter (which counts reference cycles, not core cycles), and is null
+    on machines that don't have one. Every searcher's result is checked
+    against std::search; the exit status is non-zero if any of them differ.
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt_dfa.hpp>
+#include <boost/algorithm/searching/two_way.hpp>
+#include <boost/algorithm/searching/shift_or.hpp>
+#include <boost/algorithm/searching/first_last_filter.hpp>
+#include <boost/algorithm/searching/hashed_boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/adaptive_search.hpp>
+#include <boost/algorithm/searching/rabin_karp.hpp>
+#include <boost/algorithm/searching/aho_corasick.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#include <string.h>     // for memmem
+#define BOOST_ALGORITHM_BENCHMARK_HAS_MEMMEM
+#endif
+
+#if defined(_MSC_VER) && ( defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BOOST_ALGORITHM_BENCHMARK_HAS_TSC
+#elif ( defined(__GNUC__) || defined(__clang__)) && ( defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BOOST_ALGORITHM_BENCHMARK_HAS_TSC
+#endif
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef const char *iter;
+
+//  Each searcher is built from the pattern outside the timed loop; the
+//  adaptors give std::search, memmem and the multi-pattern searchers the
+//  same shape as the others.
+    class std_search {
+    public:
+        std_search ( iter first, iter last ) : pat_first ( first ), pat_last ( last ) {}
+        iter operator () ( iter corpus_first, iter corpus_last ) const {
+            return std::search ( corpus_first, corpus_last, pat_first, pat_last );
+            }
+    private:
+        iter pat_first, pat_last;
+        };
+
+#ifdef BOOST_ALGORITHM_BENCHMARK_HAS_MEMMEM
+    class memmem_search {
+    public:
+        memmem_search ( iter first, iter last ) : pat_first ( first ), pat_last ( last ) {}
+        iter operator () ( iter corpus_first, iter corpus_last ) const {
+            const void *found = ::memmem ( corpus_first, corpus_last - corpus_first, pat_first, pat_last - pat_first );
+            return found == NULL ? corpus_last : static_cast<iter> ( found );
+            }
+    private:
+        iter pat_first, pat_last;
+        };
+#endif
+
+    template <typename MultiSearcher>
+    class single_pattern {
+    public:
+        single_pattern ( iter first, iter last ) : patterns_ ( 1, std::string ( first, last )),
+                searcher_ ( patterns_.begin (), patterns_.end ()) {}
+        iter operator () ( iter corpus_first, iter corpus_last ) const {
+            return searcher_ ( corpus_first, corpus_last ).first;
+            }
+    private:
+        std::vector<std::string> patterns_;
+        MultiSearcher searcher_;
+        };
+
+    struct one_case {
+        std::string corpus;         // "random", or the name of a file
+        std::size_t alphabet;       // the number of distinct bytes in the corpus
+        std::string position;       // where the pattern was put
+        iter corpus_first, corpus_last;
+        iter pat_first, pat_last;
+        };
+
+    struct measurement {
+        std::size_t iterations;
+        double seconds;
+        double cycles;              // negative if there is no cycle counter
+        };
+
+    double read_cycle_counter () {
+#ifdef BOOST_ALGORITHM_BENCHMARK_HAS_TSC
+        return static_cast<double> ( __rdtsc ());
+#else
+        return 0;
+#endif
+        }
+
+    double min_seconds = 0.05;
+    bool all_agree = true;
+    bool first_result = true;
+    volatile std::ptrdiff_t sink;   // so that the searches can't be optimized away
+
+    std::string json_string ( const std::string &s ) {
+        std::string retVal ( "\"" );
+        for ( std::string::const_iterator it = s.begin (); it != s.end (); ++it ) {
+            if ( *it == '"' || *it == '\\' )
+                retVal += '\\';
+            if ( static_cast<unsigned char> ( *it ) >= 0x20 )
+                retVal += *it;
+            }
+        return retVal + '"';
+        }
+
+//  Run the search often enough to take at least 'min_seconds'
+    template <typename Searcher>
+    measurement time_search ( const Searcher &s, iter corpus_first, iter corpus_last ) {
+        volatile std::ptrdiff_t offset = 0;   // keeps the search inside the loop
+        measurement retVal;
+        for ( std::size_t reps = 1; ; reps *= 2 ) {
+            const double start_cycles = read_cycle_counter ();
+            const std::clock_t start = std::clock ();
+            for ( std::size_t i = 0; i < reps; ++i )
+                sink = s ( corpus_first + offset, corpus_last ) - corpus_first;
+            retVal.seconds = ( 1.0 * ( std::clock () - start )) / CLOCKS_PER_SEC;
+            retVal.cycles = read_cycle_counter () - start_cycles;
+            retVal.iterations = reps;
+            if ( retVal.seconds >= min_seconds )
+                break;
+            }
+#ifndef BOOST_ALGORITHM_BENCHMARK_HAS_TSC
+        retVal.cycles = -1;
+#endif
+        return retVal;
+        }
+
+    template <typename Searcher>
+    void run ( const char *name, const one_case &c, iter expected ) {
+        const std::size_t pattern_length = c.pat_last - c.pat_first;
+        const Searcher s ( c.pat_first, c.pat_last );
+        if ( s ( c.corpus_first, c.corpus_last ) != expected ) {
+            std::cerr << name << " disagrees with std::search: " << c.corpus << ", pattern length "
+                      << pattern_length << ", " << c.position << std::endl;
+            all_agree = false;
+            }
+
+        const measurement m = time_search ( s, c.corpus_first, c.corpus_last );
+        const std::size_t bytes = expected == c.corpus_last
+                ? c.corpus_last - c.corpus_first : ( expected - c.corpus_first ) + pattern_length;
+        const double total_bytes = static_cast<double> ( bytes ) * m.iterations;
+
+        std::cout << ( first_result ? "\n" : ",\n" ) << "    { "
+                  << "\"searcher\": "       << json_string ( name )
+                  << ", \"corpus\": "       << json_string ( c.corpus )
+                  << ", \"corpus_size\": "  << c.corpus_last - c.corpus_first
+                  << ", \"alphabet\": "     << c.alphabet
+                  << ", \"pattern_length\": " << pattern_length
+                  << ", \"position\": "     << json_string ( c.position )
+                  << ", \"bytes\": "        << bytes
+                  << ", \"iterations\": "   << m.iterations
+                  << ", \"seconds\": "      << m.seconds
+                  << ", \"gb_per_s\": "     << ( m.seconds > 0 ? total_bytes / m.seconds / 1e9 : 0 )
+                  << ", \"cycles_per_byte\": ";
+        if ( m.cycles < 0 )
+            std::cout << "null";
+        else
+            std::cout << m.cycles / total_bytes;
+        std::cout << " }" << std::flush;
+        first_result = false;
+        }
+
+    void run_all ( const one_case &c ) {
+        const iter expected = std::search ( c.corpus_first, c.corpus_last, c.pat_first, c.pat_last );
+        run<std_search> ( "std::search", c, expected );
+#ifdef BOOST_ALGORITHM_BENCHMARK_HAS_MEMMEM
+        run<memmem_search> ( "memmem", c, expected );
+#endif
+        run<ba::boyer_moore<iter> >                 ( "boyer_moore", c, expected );
+        run<ba::boyer_moore_horspool<iter> >        ( "boyer_moore_horspool", c, expected );
+        run<ba::hashed_boyer_moore_horspool<iter> > ( "hashed_boyer_moore_horspool", c, expected );
+        run<ba::knuth_morris_pratt<iter> >          ( "knuth_morris_pratt", c, expected );
+        run<ba::knuth_morris_pratt_dfa<iter> >      ( "knuth_morris_pratt_dfa", c, expected );
+        run<ba::two_way<iter> >                     ( "two_way", c, expected );
+        if ( c.pat_last - c.pat_first <= 64 )
+            run<ba::shift_or<iter> >                ( "shift_or", c, expected );
+        run<ba::first_last_filter<iter> >           ( "first_last_filter", c, expected );
+        run<ba::adaptive_searcher<iter> >           ( "adaptive_searcher", c, expected );
+        run<single_pattern<ba::rabin_karp<std::string::const_iterator> > >   ( "rabin_karp", c, expected );
+        run<single_pattern<ba::aho_corasick<std::string::const_iterator> > > ( "aho_corasick", c, expected );
+        }
+
+    const std::size_t pattern_lengths [] = { 1, 2, 4, 8, 16, 32, 64, 256 };
+    const std::size_t alphabets [] = { 2, 4, 26, 255 };
+    const char *positions [] = { "begin", "middle", "end", "absent" };
+
+//  Where to put (or look for) the pattern; std::string::npos for "absent"
+    std::size_t pattern_offset ( std::size_t p, std::size_t corpus_size, std::size_t pattern_length ) {
+        switch ( p ) {
+            case 0: return 0;
+            case 1: return ( corpus_size - pattern_length ) / 2;
+            case 2: return corpus_size - pattern_length;
+            default: return std::string::npos;
+            }
+        }
+
+//  Random text over the bytes 1 .. alphabet; so zero never occurs, and a
+//  pattern with a zero in the middle is absent.
+    void random_cases ( std::size_t max_size ) {
+        for ( std::size_t size = 1024; size != 0 && size <= max_size; size = size > max_size / 32 ? 0 : size * 32 )
+            for ( std::size_t a = 0; a < sizeof ( alphabets ) / sizeof ( alphabets [ 0 ] ); ++a ) {
+                std::string corpus ( size, ' ' );
+                for ( std::size_t i = 0; i < size; ++i )
+                    corpus [ i ] = static_cast<char> ( 1 + std::rand () % alphabets [ a ] );
+
+                for ( std::size_t l = 0; l < sizeof ( pattern_lengths ) / sizeof ( pattern_lengths [ 0 ] ); ++l ) {
+                    const std::size_t m = pattern_lengths [ l ];
+                    std::string pattern ( m, ' ' );
+                    for ( std::size_t i = 0; i < m; ++i )
+                        pattern [ i ] = static_cast<char> ( 1 + std::rand () % alphabets [ a ] );
+
+                    for ( std::size_t p = 0; p < 4; ++p ) {
+                        const std::size_t where = pattern_offset ( p, size, m );
+                        std::string pat ( pattern );
+                        std::string saved;
+                        if ( where == std::string::npos )
+                            pat [ m / 2 ] = '\0';
+                        else {
+                            saved = corpus.substr ( where, m );
+                            corpus.replace ( where, m, pat );
+                            }
+
+                        one_case c;
+                        c.corpus = "random";
+                        c.alphabet = alphabets [ a ];
+                        c.position = positions [ p ];
+                        c.corpus_first = corpus.data ();
+                        c.corpus_last  = corpus.data () + corpus.size ();
+                        c.pat_first = pat.data ();
+                        c.pat_last  = pat.data () + pat.size ();
+                        run_all ( c );
+
+                        if ( where != std::string::npos )
+                            corpus.replace ( where, m, saved );
+                        }
+                    }
+                }
+        }
+
+//  Patterns cut from the file; the absent one has a byte that the file doesn't
+    void file_cases ( const std::string &name ) {
+        std::ifstream in ( name.c_str (), std::ios_base::binary | std::ios_base::in );
+        if ( !in ) {
+            std::cerr << "Can't open " << name << std::endl;
+            all_agree = false;
+            return;
+            }
+        std::istreambuf_iterator<char> in_first ( in ), in_last;
+        const std::string corpus ( in_first, in_last );
+
+        bool seen [ 256 ] = { false };
+        std::size_t alphabet = 0;
+        for ( std::size_t i = 0; i < corpus.size (); ++i )
+            if ( !seen [ static_cast<unsigned char> ( corpus [ i ] ) ] ) {
+                seen [ static_cast<unsigned char> ( corpus [ i ] ) ] = true;
+                ++alphabet;
+                }
+        const bool *missing = std::find ( seen, seen + 256, false );
+
+        for ( std::size_t l = 0; l < sizeof ( pattern_lengths ) / sizeof ( pattern_lengths [ 0 ] ); ++l ) {
+            const std::size_t m = pattern_lengths [ l ];
+            if ( m > corpus.size ())
+                break;
+            for ( std::size_t p = 0; p < 4; ++p ) {
+                const std::size_t where = pattern_offset ( p, corpus.size (), m );
+                std::string pat;
+                if ( where != std::string::npos )
+                    pat = corpus.substr ( where, m );
+                else if ( missing != seen + 256 ) {
+                    pat = corpus.substr ( pattern_offset ( 1, corpus.size (), m ), m );
+                    pat [ m / 2 ] = static_cast<char> ( missing - seen );
+                    }
+                else
+                    continue;   // every byte value occurs in the file
+
+                one_case c;
+                c.corpus = name;
+                c.alphabet = alphabet;
+                c.position = positions [ p ];
+                c.corpus_first = corpus.data ();
+                c.corpus_last  = corpus.data () + corpus.size ();
+                c.pat_first = pat.data ();
+                c.pat_last  = pat.data () + pat.size ();
+                run_all ( c );
+                }
+            }
+        }
+
+    std::size_t parse_size ( const std::string &s ) {
+        std::istringstream in ( s );
+        std::size_t retVal = 0;
+        char suffix = ' ';
+        in >> retVal >> suffix;
+        switch ( suffix ) {
+            case 'G': case 'g': retVal *= 1024;     // fall through
+            case 'M': case 'm': retVal *= 1024;     // fall through
+            case 'K': case 'k': retVal *= 1024;
+            default: break;
+            }
+        return retVal;
+        }
+    }
+
+int main ( int argc, char *argv [] ) {
+    std::size_t max_size = static_cast<std::size_t> ( 32 ) << 20;
+    std::vector<std::string> files;
+    for ( int i = 1; i < argc; ++i ) {
+        const std::string arg ( argv [ i ] );
+        if ( arg.compare ( 0, 11, "--max-size=" ) == 0 )
+            max_size = parse_size ( arg.substr ( 11 ));
+        else if ( arg.compare ( 0, 11, "--min-time=" ) == 0 )
+            min_seconds = std::atof ( arg.substr ( 11 ).c_str ());
+        else
+            files.push_back ( arg );
+        }
+
+    std::srand ( 1 );
+    std::cout << std::setprecision ( 6 );
+    std::cout << "{\n  \"benchmark\": \"search_benchmark\",\n  \"results\": [";
+    random_cases ( max_size );
+    for ( std::size_t i = 0; i < files.size (); ++i )
+        file_cases ( files [ i ] );
+    std::cout << "\n  ]\n}" << std::endl;
+    return all_agree ? 0 : 1;
+    }
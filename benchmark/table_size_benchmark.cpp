@@ -0,0 +1,114 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    How the size of the skip tables affects searching when many searchers
+    are in use at once. Each search uses the next searcher in the set, over
+    a short corpus of random bytes, so that the whole of each skip table is
+    used. Once the tables no longer fit in the L1 (or L2) cache, every
+    search starts with cache misses.
+
+    The compact tables (one byte per entry, for short patterns) are compared
+    with the same Boyer-Moore-Horspool searcher using a skip table of full
+    width entries (std::ptrdiff_t), which is supplied through the traits.
+*/
+
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <boost/array.hpp>
+#include <boost/shared_ptr.hpp>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  A skip table with a full difference_type in each entry;
+//  the layout the byte searchers used before the tables were compacted.
+    class wide_skip_table {
+    public:
+        wide_skip_table ( std::size_t, std::ptrdiff_t default_value ) { skip_.fill ( default_value ); }
+
+        void insert ( char key, std::ptrdiff_t val ) { skip_ [ static_cast<unsigned char> ( key ) ] = val; }
+
+        std::ptrdiff_t operator [] ( char key ) const { return skip_ [ static_cast<unsigned char> ( key ) ]; }
+
+    private:
+        boost::array<std::ptrdiff_t, 256> skip_;
+        };
+
+    struct wide_traits {
+        typedef wide_skip_table skip_table_t;
+        };
+
+    std::string random_string ( std::size_t len ) {
+        std::string retVal ( len, ' ' );
+        for ( std::size_t i = 0; i < len; ++i )
+            retVal [ i ] = static_cast<char> ( std::rand () % 256 );
+        return retVal;
+        }
+
+    const std::size_t k_pattern_length = 8;
+    const std::size_t k_corpus_length  = 512;
+    const std::size_t k_searches       = 1U << 22;
+
+//  Search the corpora round-robin, each with the next searcher
+    template <typename Searcher>
+    double run ( const std::vector<std::string> &patterns, const std::vector<std::string> &corpora, std::size_t &found ) {
+        std::vector<boost::shared_ptr<Searcher> > searchers;
+        for ( std::size_t i = 0; i < patterns.size (); ++i )
+            searchers.push_back ( boost::shared_ptr<Searcher> ( new Searcher ( patterns [ i ].begin (), patterns [ i ].end ())));
+
+        const std::clock_t start = std::clock ();
+        for ( std::size_t i = 0; i < k_searches; ++i ) {
+            const std::string &corpus = corpora [ i % corpora.size ()];
+            if ( (*searchers [ i % searchers.size ()]) ( corpus.begin (), corpus.end ()) != corpus.end ())
+                ++found;
+            }
+        return ( 1.0 * ( std::clock () - start )) / CLOCKS_PER_SEC;
+        }
+    }
+
+int main ( int, char ** ) {
+    typedef std::string::const_iterator iter;
+    typedef ba::boyer_moore_horspool<iter>              compact_bmh;
+    typedef ba::boyer_moore_horspool<iter, wide_traits> wide_bmh;
+
+    std::srand ( 1 );
+    std::vector<std::string> corpora;
+    for ( int i = 0; i < 61; ++i )
+        corpora.push_back ( random_string ( k_corpus_length ));
+
+    std::cout << "Pattern length " << k_pattern_length << ", corpus length " << k_corpus_length
+              << ", " << k_searches << " searches" << std::endl;
+    std::cout << std::setw(10) << "searchers"
+              << std::setw(14) << "compact KB" << std::setw(12) << "seconds"
+              << std::setw(14) << "wide KB"    << std::setw(12) << "seconds" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    std::size_t found = 0;  // so that the searches can't be optimized away
+    for ( std::size_t count = 1; count <= 4096; count *= 4 ) {
+        std::vector<std::string> patterns;
+        for ( std::size_t i = 0; i < count; ++i )
+            patterns.push_back ( random_string ( k_pattern_length ));
+
+        const double compact_time = run<compact_bmh> ( patterns, corpora, found );
+        const double wide_time    = run<wide_bmh>    ( patterns, corpora, found );
+        std::cout << std::setw(10) << count
+                  << std::setw(14) << count * 256 * 1 / 1024.0 << std::setw(12) << compact_time
+                  << std::setw(14) << count * 256 * sizeof ( std::ptrdiff_t ) / 1024.0 << std::setw(12) << wide_time
+                  << std::endl;
+        }
+    std::cout << found << " matches" << std::endl;
+    return 0;
+    }
@@ -0,0 +1,367 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_ADAPTIVE_SEARCH_HPP
+#define BOOST_ALGORITHM_ADAPTIVE_SEARCH_HPP
+
+#include <cstddef>      // for std::size_t
+#include <cstring>      // for std::memchr, std::memcpy
+#include <algorithm>    // for std::find, std::search
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/optional.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/utility/in_place_factory.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/size.hpp>
+
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+#include <boost/algorithm/searching/two_way.hpp>
+#include <boost/algorithm/searching/detail/simd.hpp>
+
+/*! \file
+    Defines a searcher that looks at the pattern (and, optionally, the
+    length of the corpus) and picks the searching algorithm to use.
+*/
+
+namespace boost { namespace algorithm {
+
+/// \enum search_kernel
+/// \brief The algorithms that an adaptive_searcher can choose between
+///
+    enum search_kernel {
+        kernel_naive,                   ///< A plain std::search; no tables
+        kernel_element,                 ///< A one-element pattern; memchr or std::find
+        kernel_word,                    ///< A 2-4 byte pattern, compared as one word
+        kernel_boyer_moore_horspool,    ///< boyer_moore_horspool
+        kernel_boyer_moore,             ///< boyer_moore
+        kernel_knuth_morris_pratt       ///< knuth_morris_pratt
+        };
+
+namespace detail {
+/// \cond DOXYGEN_HIDE
+
+//  Is 'T' a one-byte integral type? Patterns of those get the word kernel,
+//  and their alphabet and period are measured.
+    template <typename T>
+    struct is_byte_value : public boost::integral_constant<bool,
+            boost::is_integral<T>::value && sizeof(T) == 1> {};
+
+//  The thresholds used to pick a kernel.
+    const std::size_t k_naive_corpus_limit    = 256;    // below this, no table pays for itself
+    const std::size_t k_small_alphabet        = 4;      // DNA, and similar
+    const std::size_t k_small_alphabet_length = 16;     // patterns long enough for BM's suffix table to help
+    const std::size_t k_long_pattern          = 64;     // where BM pays off for hashed skip tables
+
+//  Choose a kernel. 'alphabet' is the number of distinct elements in the
+//  pattern, 'period' its smallest period; both are zero if unknown.
+//  'expected' is the expected length of the corpus; zero if unknown.
+    inline search_kernel choose_search_kernel ( std::size_t length, bool bytes,
+            std::size_t alphabet, std::size_t period, std::size_t expected ) {
+        if ( length == 0 )                      return kernel_naive;
+        if ( length == 1 )                      return kernel_element;
+        if ( bytes && length <= 4 )             return kernel_word;
+        if ( expected != 0 && expected < k_naive_corpus_limit )
+                                                return kernel_naive;
+    //  A pattern that repeats itself gives BMH short shifts; KMP stays linear.
+        if ( period != 0 && 2 * period <= length )
+                                                return kernel_knuth_morris_pratt;
+        if ( alphabet != 0 && alphabet <= k_small_alphabet && length >= k_small_alphabet_length )
+                                                return kernel_boyer_moore;
+        if ( !bytes && length >= k_long_pattern )
+                                                return kernel_boyer_moore;
+        return kernel_boyer_moore_horspool;
+        }
+
+/// \endcond
+}
+
+/*
+    A searcher that chooses its algorithm.
+
+    The constructor looks at the pattern: its length and, for patterns of
+    bytes, the number of distinct values in it and whether it is periodic.
+    If the caller knows roughly how long the corpora will be, it can say so.
+    Then it picks one of:
+        * a one-element search (memchr for byte pointers),
+        * a 2-4 byte search that compares whole 16 or 32 bit words,
+        * a naive search (std::search),
+        * boyer_moore_horspool, boyer_moore or knuth_morris_pratt,
+    and builds the tables for that one only.
+
+    Requirements:
+        * Random access iterators
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type.
+        * Whatever the chosen searcher requires; the value type must be
+            usable by all of them (hashable, for non-byte types).
+*/
+
+    template <typename patIter>
+    class adaptive_searcher {
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef detail::is_byte_value<value_type> is_bytes;
+    public:
+        /// \param first                  The start of the pattern
+        /// \param last                   One past the end of the pattern
+        /// \param expected_corpus_length The expected length of the corpora; zero if unknown
+        adaptive_searcher ( patIter first, patIter last, std::size_t expected_corpus_length = 0 )
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  word_ ( 0 ), mask_ ( 0 ), packed_ ( 0 ) {
+            std::size_t alphabet = 0, period = 0;
+            if ( is_bytes::value && k_pattern_length > 4 )
+                this->measure_pattern ( alphabet, period );
+            kernel_ = detail::choose_search_kernel ( static_cast<std::size_t> ( k_pattern_length ), is_bytes::value,
+                                                     alphabet, period, expected_corpus_length );
+            this->build ();
+            }
+
+        ~adaptive_searcher () {}
+
+        /// \fn kernel () const
+        /// \brief Returns the algorithm that was chosen
+        search_kernel kernel () const { return kernel_; }
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            switch ( kernel_ ) {
+                case kernel_element:
+                    return this->find_element ( corpus_first, corpus_last, detail::is_byte_pointer<corpusIter> ());
+                case kernel_word:
+                    return this->find_word ( corpus_first, corpus_last, is_bytes (), detail::is_byte_pointer<corpusIter> ());
+                case kernel_boyer_moore_horspool:
+                    return (*bmh_) ( corpus_first, corpus_last );
+                case kernel_boyer_moore:
+                    return (*bm_) ( corpus_first, corpus_last );
+                case kernel_knuth_morris_pratt:
+                    return (*kmp_) ( corpus_first, corpus_last );
+                case kernel_naive:
+                default:
+                    break;
+                }
+        //  Same conventions as the other searchers
+            if ( corpus_first == corpus_last ) return corpus_last;
+            if (    pat_first ==    pat_last ) return corpus_first;
+            return std::search ( corpus_first, corpus_last, pat_first, pat_last );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+        search_kernel kernel_;
+        boost::uint32_t word_;      // the pattern, for kernel_word, first byte highest
+        boost::uint32_t mask_;      // the bits of word_ that are used
+        boost::uint32_t packed_;    // the pattern as load_word reads it from memory
+        boost::optional<boyer_moore_horspool<patIter> > bmh_;
+        boost::optional<boyer_moore<patIter> >          bm_;
+        boost::optional<knuth_morris_pratt<patIter> >   kmp_;
+
+    //  Count the distinct values in the pattern, and find its period if it is periodic.
+        void measure_pattern ( std::size_t &alphabet, std::size_t &period ) const {
+            bool seen [ 256 ] = { false };
+            for ( patIter it = pat_first; it != pat_last; ++it ) {
+                const unsigned char c = static_cast<unsigned char> ( *it );
+                if ( !seen [ c ] ) { seen [ c ] = true; ++alphabet; }
+                }
+
+            difference_type p;
+            const difference_type suffix = detail::critical_factorization ( pat_first, k_pattern_length, p );
+            if ( detail::is_periodic ( pat_first, k_pattern_length, suffix, p ))
+                period = static_cast<std::size_t> ( p );
+            }
+
+        void build () {
+            switch ( kernel_ ) {
+                case kernel_word: {
+                    unsigned char bytes [ 4 ] = { 0 };
+                    for ( difference_type i = 0; i < k_pattern_length; ++i ) {
+                        bytes [ i ] = static_cast<unsigned char> ( pat_first [ i ] );
+                        word_ = ( word_ << 8 ) | bytes [ i ];
+                        }
+                    mask_ = k_pattern_length == 4 ? 0xFFFFFFFFU : ( 1U << ( 8 * k_pattern_length )) - 1U;
+                    packed_ = this->load_word ( bytes );
+                    }
+                    break;
+                case kernel_boyer_moore_horspool:
+                    bmh_ = boost::in_place ( pat_first, pat_last );
+                    break;
+                case kernel_boyer_moore:
+                    bm_ = boost::in_place ( pat_first, pat_last );
+                    break;
+                case kernel_knuth_morris_pratt:
+                    kmp_ = boost::in_place ( pat_first, pat_last );
+                    break;
+                default:
+                    break;
+                }
+            }
+
+    //  One-element pattern, general iterators
+        template <typename corpusIter>
+        corpusIter find_element ( corpusIter corpus_first, corpusIter corpus_last, boost::false_type ) const {
+            return std::find ( corpus_first, corpus_last, *pat_first );
+            }
+
+    //  One-element pattern, byte pointers
+        template <typename corpusIter>
+        corpusIter find_element ( corpusIter corpus_first, corpusIter corpus_last, boost::true_type ) const {
+            const void *p = std::memchr ( corpus_first, static_cast<unsigned char> ( *pat_first ),
+                                          static_cast<std::size_t> ( corpus_last - corpus_first ));
+            return p == NULL ? corpus_last : corpus_first + ( static_cast<const unsigned char *> ( p ) -
+                                                              reinterpret_cast<const unsigned char *> ( corpus_first ));
+            }
+
+        template <typename corpusIter, typename BytePointer>
+        corpusIter find_word ( corpusIter, corpusIter corpus_last, boost::false_type, BytePointer ) const {
+            BOOST_ASSERT ( false );     // only chosen for byte patterns
+            return corpus_last;
+            }
+
+    //  The 2-4 bytes at 'p', read with fixed-size copies that the compiler
+    //  turns into one 16 or 32 bit load (two for three bytes).
+        boost::uint32_t load_word ( const unsigned char *p ) const {
+            boost::uint16_t half;
+            boost::uint32_t word;
+            switch ( k_pattern_length ) {
+                case 2:
+                    std::memcpy ( &half, p, 2 );
+                    return half;
+                case 3:
+                    std::memcpy ( &half, p, 2 );
+                    return half | ( static_cast<boost::uint32_t> ( p [ 2 ] ) << 16 );
+                default:
+                    std::memcpy ( &word, p, 4 );
+                    return word;
+                }
+            }
+
+    //  2-4 byte pattern, general iterators: shift each corpus byte into a
+    //  word, and compare the word against the pattern.
+        template <typename corpusIter>
+        corpusIter find_word ( corpusIter corpus_first, corpusIter corpus_last, boost::true_type, boost::false_type ) const {
+            const difference_type k_corpus_length = std::distance ( corpus_first, corpus_last );
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+            boost::uint32_t window = 0;
+            for ( difference_type i = 0; i < k_pattern_length - 1; ++i )
+                window = ( window << 8 ) | static_cast<unsigned char> ( corpus_first [ i ] );
+            for ( difference_type i = k_pattern_length - 1; i < k_corpus_length; ++i ) {
+                window = ( window << 8 ) | static_cast<unsigned char> ( corpus_first [ i ] );
+                if (( window & mask_ ) == word_ )
+                    return corpus_first + ( i - ( k_pattern_length - 1 ));
+                }
+            return corpus_last;
+            }
+
+    //  2-4 byte pattern, byte pointers: memchr to each candidate first byte,
+    //  then compare the whole word there against the pattern.
+        template <typename corpusIter>
+        corpusIter find_word ( corpusIter corpus_first, corpusIter corpus_last, boost::true_type, boost::true_type ) const {
+            const difference_type k_corpus_length = corpus_last - corpus_first;
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+            const unsigned char *first = reinterpret_cast<const unsigned char *> ( corpus_first );
+            const unsigned char *p = first;
+            const unsigned char *last_start = first + ( k_corpus_length - k_pattern_length );
+            const unsigned char lead = static_cast<unsigned char> ( *pat_first );
+            while ( p <= last_start ) {
+                p = static_cast<const unsigned char *> ( std::memchr ( p, lead, static_cast<std::size_t> ( last_start - p + 1 )));
+                if ( p == NULL )
+                    break;
+                if ( this->load_word ( p ) == packed_ )
+                    return corpus_first + ( p - first );
+                ++p;
+                }
+            return corpus_last;
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    The procedural versions know how long the corpus is, and pass that along. */
+
+/// \fn adaptive_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern, with the algorithm best suited to them.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter adaptive_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        adaptive_searcher<patIter> as ( pat_first, pat_last,
+                                        static_cast<std::size_t> ( std::distance ( corpus_first, corpus_last )));
+        return as ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    adaptive_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        adaptive_searcher<pattern_iterator> as ( boost::begin(pattern), boost::end (pattern),
+                                                 static_cast<std::size_t> ( boost::size ( corpus )));
+        return as (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::adaptive_searcher<typename boost::range_iterator<const Range>::type>
+    make_searcher ( const Range &r, std::size_t expected_corpus_length = 0 ) {
+        return boost::algorithm::adaptive_searcher
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r), expected_corpus_length);
+        }
+
+    template <typename Range>
+    boost::algorithm::adaptive_searcher<typename boost::range_iterator<Range>::type>
+    make_searcher ( Range &r, std::size_t expected_corpus_length = 0 ) {
+        return boost::algorithm::adaptive_searcher
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r), expected_corpus_length);
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_ADAPTIVE_SEARCH_HPP
@@ -0,0 +1,275 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_AHO_CORASICK_SEARCH_HPP
+#define BOOST_ALGORITHM_AHO_CORASICK_SEARCH_HPP
+
+#include <vector>
+#include <utility>      // for std::pair
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/value_type.hpp>
+
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/detail/ac_traits.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A templated version of the Aho-Corasick multiple pattern searching algorithm.
+
+    The patterns are compiled into a single automaton (a trie of the patterns,
+    plus "failure" links), and then the corpus is scanned once, reporting
+    every occurrence of every pattern.
+
+References:
+    http://cr.yp.to/bib/1975/aho.pdf
+
+Explanations:
+    http://en.wikipedia.org/wiki/Aho%E2%80%93Corasick_string_matching_algorithm
+
+Requirements:
+        * Random access iterators for the corpus
+        * The patterns and the corpus must "point to" the same underlying type.
+        * Additional requirements may be imposed by the transition table, such as:
+        ** Numeric type (array-based transition table)
+        ** Hashable type (map-based transition table)
+
+    Patterns are identified by their position in the range of patterns passed
+    to the constructor. Empty patterns are accepted, but never match.
+*/
+
+    template <typename patIter, typename traits = detail::AC_traits<patIter> >
+    class aho_corasick {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef typename traits::state_type state_type;
+    public:
+        /// The pattern id returned when nothing is found
+        static const std::size_t npos = static_cast<std::size_t> ( -1 );
+
+        template <typename PatternsIter>
+        aho_corasick ( PatternsIter first, PatternsIter last ) : k_max_length ( 0 ) {
+            this->build_automaton ( first, last );
+            }
+
+        ~aho_corasick () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the leftmost occurrence of any of the patterns
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \return             The start of the match and the id of the pattern; if
+        ///                     nothing is found, (corpus_last, npos). If several patterns
+        ///                     start at the same place, the shortest one is reported.
+        ///
+        template <typename corpusIter>
+        std::pair<corpusIter, std::size_t> operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            difference_type best = -1;      // start of the best match so far
+            std::size_t best_id = npos;
+            difference_type pos = 0;        // number of corpus elements consumed
+            state_type state = 0;
+            for ( corpusIter curPos = corpus_first; curPos != corpus_last; ++curPos ) {
+                state = table_.next ( state, *curPos, fail_ );
+                ++pos;
+            //  No match ending here or later can start before the one we've got
+                if ( best >= 0 && pos - k_max_length >= best )
+                    break;
+                for ( state_type out = first_output ( state ); out != 0; out = output_ [ out ] )
+                    for ( std::size_t id = terminal_ [ out ]; id != npos; id = next_id_ [ id ] )
+                        if ( best < 0 || pos - lengths_ [ id ] < best ) {
+                            best    = pos - lengths_ [ id ];
+                            best_id = id;
+                            }
+                }
+
+            if ( best < 0 )
+                return std::make_pair ( corpus_last, npos );
+            return std::make_pair ( corpus_first + best, best_id );
+            }
+
+        template <typename Range>
+        std::pair<typename boost::range_iterator<Range>::type, std::size_t> operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f )
+        /// \brief Reports every occurrence of every pattern in the corpus, in one pass
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param f            Called as f ( pattern_id, match_start ) for each match.
+        ///                     Matches are reported in order of their end position;
+        ///                     matches that end at the same place, longest first.
+        /// \return             f
+        ///
+        template <typename corpusIter, typename Func>
+        Func for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            state_type state = 0;
+            for ( corpusIter curPos = corpus_first; curPos != corpus_last; ) {
+                state = table_.next ( state, *curPos, fail_ );
+                ++curPos;
+                for ( state_type out = first_output ( state ); out != 0; out = output_ [ out ] )
+                    for ( std::size_t id = terminal_ [ out ]; id != npos; id = next_id_ [ id ] )
+                        f ( id, curPos - lengths_ [ id ] );
+                }
+            return f;
+            }
+
+        template <typename Range, typename Func>
+        Func for_each_match ( Range &r, Func f ) const {
+            return this->for_each_match (boost::begin(r), boost::end(r), f);
+            }
+
+        /// The number of patterns the automaton was built from
+        std::size_t pattern_count () const { return lengths_.size (); }
+
+        /// The length of the pattern with the id 'id'
+        difference_type pattern_length ( std::size_t id ) const { return lengths_ [ id ]; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        typename traits::transition_table_t table_;
+        std::vector<state_type> fail_;          // the failure link of each state
+        std::vector<state_type> output_;        // next state on the failure chain that ends a pattern
+        std::vector<std::size_t> terminal_;     // first pattern ending at each state, or npos
+        std::vector<std::size_t> next_id_;      // next pattern ending at the same state, or npos
+        std::vector<difference_type> lengths_;  // the length of each pattern
+        difference_type k_max_length;
+
+        state_type first_output ( state_type state ) const {
+            return terminal_ [ state ] != npos ? state : output_ [ state ];
+            }
+
+        template <typename PatternsIter>
+        void build_automaton ( PatternsIter first, PatternsIter last ) {
+            typedef typename traits::key_type key_type;
+            std::vector<state_type> parent ( 1, 0 );    // the root is its own parent
+            std::vector<key_type>   key    ( 1 );       // the element leading to each state
+            std::vector<difference_type> depth ( 1, 0 );
+            std::vector<state_type> ends;               // the state where each pattern ends
+
+        //  Build the trie
+            for ( ; first != last; ++first ) {
+                state_type state = 0;
+                difference_type len = 0;
+                for ( typename boost::range_iterator<const typename std::iterator_traits<PatternsIter>::value_type>::type
+                        it = boost::begin ( *first ); it != boost::end ( *first ); ++it, ++len ) {
+                    state_type target = table_.child ( state, *it );
+                    if ( target == traits::transition_table_t::k_no_state ) {
+                        target = table_.add_state ();
+                        table_.set_child ( state, *it, target );
+                        parent.push_back ( state );
+                        key.push_back ( *it );
+                        depth.push_back ( len + 1 );
+                        }
+                    state = target;
+                    }
+                ends.push_back ( state );
+                lengths_.push_back ( len );
+                if ( len > k_max_length )
+                    k_max_length = len;
+                }
+
+        //  Chain the patterns by the state where they end, lowest id first.
+            const std::size_t k_states = parent.size ();
+            terminal_.assign ( k_states, npos );
+            next_id_.assign  ( ends.size (), npos );
+            for ( std::size_t id = ends.size (); id-- > 0; )
+                if ( lengths_ [ id ] > 0 ) {
+                    next_id_ [ id ] = terminal_ [ ends [ id ]];
+                    terminal_ [ ends [ id ]] = id;
+                    }
+
+        //  Sort the states by depth (breadth-first order); a failure link
+        //  always points to a shallower state.
+            std::vector<std::size_t> by_depth ( k_max_length + 2, 0 );
+            for ( std::size_t s = 0; s < k_states; ++s )
+                ++by_depth [ depth [ s ] + 1 ];
+            for ( std::size_t d = 1; d < by_depth.size (); ++d )
+                by_depth [ d ] += by_depth [ d - 1 ];
+            std::vector<state_type> order ( k_states );
+            for ( std::size_t s = 0; s < k_states; ++s )
+                order [ by_depth [ depth [ s ]] ++ ] = static_cast<state_type> ( s );
+
+        //  Compute the failure and output links
+            fail_.assign   ( k_states, 0 );
+            output_.assign ( k_states, 0 );
+            table_.complete ( 0, 0 );
+            for ( std::size_t i = 1; i < k_states; ++i ) {
+                const state_type s = order [ i ];
+                const state_type f = parent [ s ] == 0 ? 0 : table_.next ( fail_ [ parent [ s ]], key [ s ], fail_ );
+                fail_   [ s ] = f;
+                output_ [ s ] = first_output ( f );
+                table_.complete ( s, f );
+                }
+            }
+/// \endcond
+        };
+
+    template <typename patIter, typename traits>
+    const std::size_t aho_corasick<patIter, traits>::npos;
+
+
+/// \fn aho_corasick_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       const PatternsRange &patterns )
+/// \brief Searches the corpus for the leftmost occurrence of any of the patterns.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param patterns     A range of patterns to search for
+///
+    template <typename PatternsRange, typename corpusIter>
+    std::pair<corpusIter, std::size_t> aho_corasick_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternsRange &patterns )
+    {
+        typedef typename boost::range_value<const PatternsRange>::type pattern_type;
+        typedef typename boost::range_iterator<const pattern_type>::type pattern_iterator;
+        aho_corasick<pattern_iterator> ac ( boost::begin(patterns), boost::end (patterns));
+        return ac ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternsRange, typename CorpusRange>
+    std::pair<typename boost::range_iterator<CorpusRange>::type, std::size_t>
+    aho_corasick_search ( CorpusRange &corpus, const PatternsRange &patterns )
+    {
+        typedef typename boost::range_value<const PatternsRange>::type pattern_type;
+        typedef typename boost::range_iterator<const pattern_type>::type pattern_iterator;
+        aho_corasick<pattern_iterator> ac ( boost::begin(patterns), boost::end (patterns));
+        return ac (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator function -- take a range of patterns, return an object
+    template <typename PatternsRange>
+    boost::algorithm::aho_corasick<typename boost::range_iterator<
+        const typename boost::range_value<const PatternsRange>::type>::type>
+    make_aho_corasick ( const PatternsRange &patterns ) {
+        return boost::algorithm::aho_corasick<typename boost::range_iterator<
+            const typename boost::range_value<const PatternsRange>::type>::type>
+                (boost::begin(patterns), boost::end(patterns));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_AHO_CORASICK_SEARCH_HPP
@@ -10,22 +10,114 @@
 #ifndef BOOST_ALGORITHM_BOYER_MOORE_SEARCH_HPP
 #define BOOST_ALGORITHM_BOYER_MOORE_SEARCH_HPP
 
-#include <iterator>     // for std::iterator_traits
+#include <memory>       // for std::allocator
+#include <iterator>     // for std::iterator_traits, std::reverse_iterator
 
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/container/allocator_traits.hpp>
+#include <boost/core/pointer_traits.hpp>
+#include <boost/mpl/bool.hpp>
 #include <boost/static_assert.hpp>
 
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
 
 #include <boost/utility/enable_if.hpp>
 #include <boost/type_traits/is_same.hpp>
 
 #include <boost/algorithm/searching/detail/bm_traits.hpp>
+#include <boost/algorithm/searching/detail/compact_table.hpp>
 #include <boost/algorithm/searching/detail/debugging.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/match_count.hpp>
 
 namespace boost { namespace algorithm {
 
+namespace detail {
+/// \cond DOXYGEN_HIDE
+
+//  prefix [ i ] is the length of the longest proper prefix of the
+//  pattern that is also a suffix of [ pat_first, pat_first + i ]
+    template<typename Iter, typename Out>
+    void compute_bm_prefix ( Iter pat_first, Iter pat_last, Out prefix ) {
+        const std::size_t count = std::distance ( pat_first, pat_last );
+        BOOST_ASSERT ( count > 0 );
+                        
+        prefix[0] = 0;
+        std::size_t k = 0;
+        for ( std::size_t i = 1; i < count; ++i ) {
+            BOOST_ASSERT ( k < count );
+            while ( k > 0 && ( pat_first[k] != pat_first[i] )) {
+                BOOST_ASSERT ( k < count );
+                k = prefix [ k - 1 ];
+                }
+                
+            if ( pat_first[k] == pat_first[i] )
+                k++;
+            prefix [ i ] = k;
+            }
+        }
+
+//  The "good suffix" table; 'suffix' has (pattern length + 1) entries.
+//  'scratch' has room for (2 * pattern length) entries; the prefix
+//  tables of the pattern and of the reversed pattern go there.
+    template<typename Iter, typename Table>
+    void build_bm_suffix_table ( Iter pat_first, Iter pat_last, Table &suffix,
+                                 typename std::iterator_traits<Iter>::difference_type *scratch ) {
+        typedef typename std::iterator_traits<Iter>::difference_type difference_type;
+        const std::size_t count = (std::size_t) std::distance ( pat_first, pat_last );
+        
+        if ( count > 0 ) {  // empty pattern
+            difference_type *prefix          = scratch;
+            difference_type *prefix_reversed = scratch + count;
+            compute_bm_prefix ( pat_first, pat_last, prefix );
+            compute_bm_prefix ( std::reverse_iterator<Iter> ( pat_last ),
+                                std::reverse_iterator<Iter> ( pat_first ), prefix_reversed );
+            
+            suffix.fill ( count - prefix [count-1] );
+     
+            for ( std::size_t i = 0; i < count; i++ ) {
+                const std::size_t     j = count - prefix_reversed[i];
+                const difference_type k = i -     prefix_reversed[i] + 1;
+     
+                if (suffix[j] > k)
+                    suffix.set ( j, k );
+                }
+            }
+        }
+
+//  The same, with the scratch space from an allocator
+    template<typename Iter, typename Table, typename Allocator>
+    void build_bm_suffix_table ( Iter pat_first, Iter pat_last, Table &suffix, const Allocator &alloc ) {
+        typedef typename std::iterator_traits<Iter>::difference_type difference_type;
+        typedef typename rebind_alloc<Allocator, difference_type>::type scratch_allocator;
+        typedef boost::container::allocator_traits<scratch_allocator> scratch_traits;
+        const std::size_t count = 2 * (std::size_t) std::distance ( pat_first, pat_last );
+        if ( count == 0 )
+            return;
+
+        scratch_allocator a ( alloc );
+        const typename scratch_traits::pointer scratch = scratch_traits::allocate ( a, count );
+        try {
+            build_bm_suffix_table ( pat_first, pat_last, suffix, boost::to_address ( scratch ));
+            }
+        catch ( ... ) {
+            scratch_traits::deallocate ( a, scratch, count );
+            throw;
+            }
+        scratch_traits::deallocate ( a, scratch, count );
+        }
+
+    template<typename Iter, typename Table>
+    void build_bm_suffix_table ( Iter pat_first, Iter pat_last, Table &suffix ) {
+        build_bm_suffix_table ( pat_first, pat_last, suffix, std::allocator<char> ());
+        }
+
+/// \endcond
+}
+
 /*
     A templated version of the boyer-moore searching algorithm.
     
@@ -50,20 +142,48 @@ Requirements:
         * Additional requirements may be imposed but the skip table, such as:
         ** Numeric type (array-based skip table)
         ** Hashable type (map-based skip table)
+
+The tables come from the allocator of the traits class (std::allocator<char>
+by default). The construction of the good suffix table needs (temporarily)
+2 * pattern length difference_types; these also come from the allocator,
+unless the caller provides them.
 */
 
     template <typename patIter, typename traits = detail::BM_traits<patIter> >
     class boyer_moore {
         typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef detail::traits_allocator<traits> traits_allocator;
+        typedef typename traits::skip_table_t skip_table_t;
+        typedef detail::compact_table<difference_type,
+                    typename detail::rebind_alloc<typename traits_allocator::type, difference_type>::type> suffix_table_t;
     public:
-        boyer_moore ( patIter first, patIter last ) 
+        typedef typename traits_allocator::type allocator_type;
+        typedef difference_type scratch_type;
+
+    //  The number of scratch_types that construction needs
+        static std::size_t scratch_size ( std::size_t pattern_length ) { return 2 * pattern_length; }
+
+        boyer_moore ( patIter first, patIter last, const allocator_type &alloc = allocator_type ())
                 : pat_first ( first ), pat_last ( last ),
                   k_pattern_length ( std::distance ( pat_first, pat_last )),
-                  skip_ ( k_pattern_length, -1 ),
-                  suffix_ ( k_pattern_length + 1 )
+                  skip_ ( traits_allocator::template make_table<skip_table_t> ( k_pattern_length, difference_type ( -1 ), alloc )),
+                  suffix_ ( k_pattern_length + 1, -1, k_pattern_length, alloc )
             {
             this->build_skip_table   ( first, last );
-            this->build_suffix_table ( first, last );
+            detail::build_bm_suffix_table ( first, last, suffix_, alloc );
+            }
+
+    //  'scratch' has room for scratch_size ( last - first ) elements;
+    //  it is only used during construction.
+        boyer_moore ( patIter first, patIter last, scratch_type *scratch,
+                      const allocator_type &alloc = allocator_type ())
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  skip_ ( traits_allocator::template make_table<skip_table_t> ( k_pattern_length, difference_type ( -1 ), alloc )),
+                  suffix_ ( k_pattern_length + 1, -1, k_pattern_length, alloc )
+            {
+            this->build_skip_table   ( first, last );
+            detail::build_bm_suffix_table ( first, last, suffix_, scratch );
             }
             
         ~boyer_moore () {}
@@ -89,7 +209,7 @@ Requirements:
                 return corpus_last;
 
         //  Do the search 
-            return this->do_search   ( corpus_first, corpus_last );
+            return this->dispatch_search ( corpus_first, corpus_last, 0 );
             }
             
         template <typename Range>
@@ -97,22 +217,119 @@ Requirements:
             return (*this) (boost::begin(r), boost::end(r));
             }
 
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        /// 
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+        //  After a full match, suffix_ [ 0 ] is the period of the pattern
+            const difference_type shift = mode == search_overlapping ? suffix_ [ 0 ] : k_pattern_length;
+            if ( pat_first == pat_last || std::distance ( match, corpus_last ) - shift < k_pattern_length )
+                return corpus_last;
+        //  Galil's rule: after a shift by the period, the first (length - period)
+        //  elements are already known to match, and are not compared again.
+            return this->dispatch_search ( match + shift, corpus_last,
+                                           mode == search_overlapping ? k_pattern_length - shift : 0 );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        /// 
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<boyer_moore, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<boyer_moore, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<boyer_moore, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// \fn count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Counts the matches of the pattern in the corpus, without visiting them one by one
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        std::size_t count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            return detail::count_matches ( *this, pat_first, pat_last, corpus_first, corpus_last, mode );
+            }
+
+        template <typename Range>
+        std::size_t count ( const Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->count (boost::begin(r), boost::end(r), mode);
+            }
+
     private:
 /// \cond DOXYGEN_HIDE
         patIter pat_first, pat_last;
         const difference_type k_pattern_length;
-        typename traits::skip_table_t skip_;
-        std::vector <difference_type> suffix_;
+        skip_table_t skip_;
+        suffix_table_t suffix_;
+
+    //  Pick the entry type of the tables once, rather than on every lookup.
+    //  Both tables hold values from -1 to the pattern length, so (unless the
+    //  traits supply a different skip table) they have the same width.
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory ) const {
+            return this->dispatch_search ( corpus_first, corpus_last, memory, boost::mpl::bool_<detail::has_view_tag<skip_table_t>::value> ());
+            }
+
+    //  A skip table without views is indexed directly
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory, boost::mpl::false_ ) const {
+            switch ( suffix_.width ()) {
+                case 1:  return this->do_search ( corpus_first, corpus_last, memory, skip_, suffix_.template view<boost::int8_t>  ());
+                case 2:  return this->do_search ( corpus_first, corpus_last, memory, skip_, suffix_.template view<boost::int16_t> ());
+                case 4:  return this->do_search ( corpus_first, corpus_last, memory, skip_, suffix_.template view<boost::int32_t> ());
+                default: return this->do_search ( corpus_first, corpus_last, memory, skip_, suffix_.template view<difference_type> ());
+                }
+            }
+
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory, boost::mpl::true_ ) const {
+            switch ( suffix_.width ()) {
+                case 1:  return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<boost::int8_t>  (), suffix_.template view<boost::int8_t>  ());
+                case 2:  return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<boost::int16_t> (), suffix_.template view<boost::int16_t> ());
+                case 4:  return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<boost::int32_t> (), suffix_.template view<boost::int32_t> ());
+                default: return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<difference_type> (), suffix_.template view<difference_type> ());
+                }
+            }
 
-        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last, Pred p )
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory, const SkipView &skip, const SuffixView &suffix )
         /// \brief Searches the corpus for the pattern that was passed into the constructor
         /// 
         /// \param corpus_first The start of the data to search (Random Access Iterator)
         /// \param corpus_last  One past the end of the data to search
-        /// \param p            A predicate used for the search comparisons.
+        /// \param memory       The number of pattern elements already known to
+        ///                     match at the start of the corpus
+        /// \param skip         The bad character table
+        /// \param suffix       The good suffix table
         ///
-        template <typename corpusIter>
-        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last ) const {
+        template <typename corpusIter, typename SkipView, typename SuffixView>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory,
+                               const SkipView &skip, const SuffixView &suffix ) const {
         /*  ---- Do the matching ---- */
             corpusIter curPos = corpus_first;
             const corpusIter lastPos = corpus_last - k_pattern_length;
@@ -125,17 +342,18 @@ Requirements:
                 while ( pat_first [j-1] == curPos [j-1] ) {
                     j--;
                 //  We matched - we're done!
-                    if ( j == 0 )
+                    if ( j == memory )
                         return curPos;
                     }
                 
             //  Since we didn't match, figure out how far to skip forward
-                k = skip_ [ curPos [ j - 1 ]];
+                k = skip [ curPos [ j - 1 ]];
                 m = j - k - 1;
-                if ( k < j && m > suffix_ [ j ] )
+                if ( k < j && m > suffix [ j ] )
                     curPos += m;
                 else
-                    curPos += suffix_ [ j ];
+                    curPos += suffix [ j ];
+                memory = 0;
                 }
         
             return corpus_last;     // We didn't find anything
@@ -146,54 +364,6 @@ Requirements:
             for ( std::size_t i = 0; first != last; ++first, ++i )
                 skip_.insert ( *first, i );
             }
-        
-
-        template<typename Iter, typename Container>
-        void compute_bm_prefix ( Iter pat_first, Iter pat_last, Container &prefix ) {
-            const std::size_t count = std::distance ( pat_first, pat_last );
-            BOOST_ASSERT ( count > 0 );
-            BOOST_ASSERT ( prefix.size () == count );
-                            
-            prefix[0] = 0;
-            std::size_t k = 0;
-            for ( std::size_t i = 1; i < count; ++i ) {
-                BOOST_ASSERT ( k < count );
-                while ( k > 0 && ( pat_first[k] != pat_first[i] )) {
-                    BOOST_ASSERT ( k < count );
-                    k = prefix [ k - 1 ];
-                    }
-                    
-                if ( pat_first[k] == pat_first[i] )
-                    k++;
-                prefix [ i ] = k;
-                }
-            }
-
-        void build_suffix_table ( patIter pat_first, patIter pat_last ) {
-            const std::size_t count = (std::size_t) std::distance ( pat_first, pat_last );
-            
-            if ( count > 0 ) {  // empty pattern
-                std::vector<typename std::iterator_traits<patIter>::value_type> reversed(count);
-                (void) std::reverse_copy ( pat_first, pat_last, reversed.begin ());
-                
-                std::vector<difference_type> prefix (count);
-                compute_bm_prefix ( pat_first, pat_last, prefix );
-        
-                std::vector<difference_type> prefix_reversed (count);
-                compute_bm_prefix ( reversed.begin (), reversed.end (), prefix_reversed );
-                
-                for ( std::size_t i = 0; i <= count; i++ )
-                    suffix_[i] = count - prefix [count-1];
-         
-                for ( std::size_t i = 0; i < count; i++ ) {
-                    const std::size_t     j = count - prefix_reversed[i];
-                    const difference_type k = i -     prefix_reversed[i] + 1;
-         
-                    if (suffix_[j] > k)
-                        suffix_[j] = k;
-                    }
-                }
-            }
 /// \endcond
         };
 
@@ -230,7 +400,8 @@ Requirements:
     
     template <typename patIter, typename CorpusRange>
     typename boost::lazy_disable_if_c<
-        boost::is_same<CorpusRange, patIter>::value, typename boost::range_iterator<CorpusRange> >
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
     ::type
     boyer_moore_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
     {
@@ -263,6 +434,25 @@ Requirements:
             <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
         }
 
+    //  The same, with the tables from an allocator
+    template <typename Range, typename Allocator>
+    boost::algorithm::boyer_moore<typename boost::range_iterator<const Range>::type,
+        detail::BM_traits<typename boost::range_iterator<const Range>::type, Allocator> >
+    make_boyer_moore ( const Range &r, const Allocator &alloc ) {
+        typedef typename boost::range_iterator<const Range>::type pattern_iterator;
+        return boost::algorithm::boyer_moore<pattern_iterator, detail::BM_traits<pattern_iterator, Allocator> >
+            (boost::begin(r), boost::end(r), alloc);
+        }
+
+    template <typename Range, typename Allocator>
+    boost::algorithm::boyer_moore<typename boost::range_iterator<Range>::type,
+        detail::BM_traits<typename boost::range_iterator<Range>::type, Allocator> >
+    make_boyer_moore ( Range &r, const Allocator &alloc ) {
+        typedef typename boost::range_iterator<Range>::type pattern_iterator;
+        return boost::algorithm::boyer_moore<pattern_iterator, detail::BM_traits<pattern_iterator, Allocator> >
+            (boost::begin(r), boost::end(r), alloc);
+        }
+
 }}
 
 #endif  //  BOOST_ALGORITHM_BOYER_MOORE_SEARCH_HPP
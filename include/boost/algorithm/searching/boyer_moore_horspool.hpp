@@ -10,19 +10,26 @@
 #ifndef BOOST_ALGORITHM_BOYER_MOORE_HORSPOOOL_SEARCH_HPP
 #define BOOST_ALGORITHM_BOYER_MOORE_HORSPOOOL_SEARCH_HPP
 
+#include <vector>
+#include <algorithm>    // for std::min
 #include <iterator>     // for std::iterator_traits
 
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/mpl/bool.hpp>
 #include <boost/static_assert.hpp>
 
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
 
 #include <boost/utility/enable_if.hpp>
 #include <boost/type_traits/is_same.hpp>
 
 #include <boost/algorithm/searching/detail/bm_traits.hpp>
 #include <boost/algorithm/searching/detail/debugging.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/match_count.hpp>
 
 // #define  BOOST_ALGORITHM_BOYER_MOORE_HORSPOOL_DEBUG_HPP
 
@@ -39,18 +46,28 @@ namespace boost { namespace algorithm {
         ** Numeric type (array-based skip table)
         ** Hashable type (map-based skip table)
 
+The skip table comes from the allocator of the traits class
+(std::allocator<char> by default).
+
 http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
 
 */
 
+    template <typename patIter, typename traits> class boyer_moore_horspool_session;
+
     template <typename patIter, typename traits = detail::BM_traits<patIter> >
     class boyer_moore_horspool {
+        template <typename, typename> friend class boyer_moore_horspool_session;
         typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef detail::traits_allocator<traits> traits_allocator;
+        typedef typename traits::skip_table_t skip_table_t;
     public:
-        boyer_moore_horspool ( patIter first, patIter last ) 
+        typedef typename traits_allocator::type allocator_type;
+
+        boyer_moore_horspool ( patIter first, patIter last, const allocator_type &alloc = allocator_type ())
                 : pat_first ( first ), pat_last ( last ),
                   k_pattern_length ( std::distance ( pat_first, pat_last )),
-                  skip_ ( k_pattern_length, k_pattern_length ) {
+                  skip_ ( traits_allocator::template make_table<skip_table_t> ( k_pattern_length, k_pattern_length, alloc )) {
                   
         //  Build the skip table
             std::size_t i = 0;
@@ -86,7 +103,7 @@ http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
                 return corpus_last;
     
         //  Do the search 
-            return this->do_search ( corpus_first, corpus_last );
+            return this->dispatch_search ( corpus_first, corpus_last );
             }
             
         template <typename Range>
@@ -94,21 +111,104 @@ http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
             return (*this) (boost::begin(r), boost::end(r));
             }
 
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        /// 
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( pat_first == pat_last )
+                return corpus_last;
+        //  After a full match, the usual Horspool shift is the distance to
+        //  the previous occurrence of the last element of the pattern.
+            const difference_type shift = mode == search_overlapping ?
+                    skip_ [ pat_first [ k_pattern_length - 1 ]] : k_pattern_length;
+            if ( std::distance ( match, corpus_last ) - shift < k_pattern_length )
+                return corpus_last;
+            return this->dispatch_search ( match + shift, corpus_last );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        /// 
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<boyer_moore_horspool, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<boyer_moore_horspool, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<boyer_moore_horspool, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// \fn count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Counts the matches of the pattern in the corpus, without visiting them one by one
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        std::size_t count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            return detail::count_matches ( *this, pat_first, pat_last, corpus_first, corpus_last, mode );
+            }
+
+        template <typename Range>
+        std::size_t count ( const Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->count (boost::begin(r), boost::end(r), mode);
+            }
+
     private:
 /// \cond DOXYGEN_HIDE
         patIter pat_first, pat_last;
         const difference_type k_pattern_length;
-        typename traits::skip_table_t skip_;
+        skip_table_t skip_;
 
-        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last )
+    //  Pick the entry type of the skip table once, rather than on every lookup
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            return this->dispatch_search ( corpus_first, corpus_last, boost::mpl::bool_<detail::has_view_tag<typename traits::skip_table_t>::value> ());
+            }
+
+    //  A skip table without views is indexed directly
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, boost::mpl::false_ ) const {
+            return this->do_search ( corpus_first, corpus_last, skip_ );
+            }
+
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, boost::mpl::true_ ) const {
+            switch ( skip_.width ()) {
+                case 1:  return this->do_search ( corpus_first, corpus_last, skip_.template view<boost::int8_t>  ());
+                case 2:  return this->do_search ( corpus_first, corpus_last, skip_.template view<boost::int16_t> ());
+                case 4:  return this->do_search ( corpus_first, corpus_last, skip_.template view<boost::int32_t> ());
+                default: return this->do_search ( corpus_first, corpus_last, skip_.template view<difference_type> ());
+                }
+            }
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, const SkipView &skip )
         /// \brief Searches the corpus for the pattern that was passed into the constructor
         /// 
         /// \param corpus_first The start of the data to search (Random Access Iterator)
         /// \param corpus_last  One past the end of the data to search
-        /// \param k_corpus_length The length of the corpus to search
+        /// \param skip         The skip table
         ///
-        template <typename corpusIter>
-        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last ) const {
+        template <typename corpusIter, typename SkipView>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, const SkipView &skip ) const {
             corpusIter curPos = corpus_first;
             const corpusIter lastPos = corpus_last - k_pattern_length;
             while ( curPos <= lastPos ) {
@@ -121,7 +221,7 @@ http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
                     j--;
                     }
         
-                curPos += skip_ [ curPos [ k_pattern_length - 1 ]];
+                curPos += skip [ curPos [ k_pattern_length - 1 ]];
                 }
             
             return corpus_last;
@@ -129,6 +229,99 @@ http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
 // \endcond
         };
 
+
+/*
+    A resumable search over a corpus that arrives in pieces (chunks).
+
+    The session reports every (possibly overlapping) match, with its offset
+    from the start of the stream. Between chunks it keeps only the last
+    (pattern length - 1) elements of the stream, which is what is needed
+    to find the matches that span a chunk boundary.
+*/
+
+    template <typename patIter, typename traits = detail::BM_traits<patIter> >
+    class boyer_moore_horspool_session {
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef typename std::vector<value_type>::const_iterator tail_iterator;
+    public:
+        typedef boost::uintmax_t offset_type;
+
+        explicit boyer_moore_horspool_session ( const boyer_moore_horspool<patIter, traits> &searcher )
+                : searcher_ ( searcher ), offset_ ( 0 ) {
+            if ( searcher_.k_pattern_length > 1 )
+                tail_.reserve ( 2 * ( searcher_.k_pattern_length - 1 ));
+            }
+
+        ~boyer_moore_horspool_session () {}
+
+        /// \fn push ( corpusIter chunk_first, corpusIter chunk_last, Func f )
+        /// \brief Searches the next chunk of the stream
+        ///
+        /// \param chunk_first The start of the chunk (Random Access Iterator)
+        /// \param chunk_last  One past the end of the chunk
+        /// \param f           Called as f ( offset ) for each match, in order;
+        ///                    offset is the position of the match in the whole stream.
+        /// \return            f
+        ///
+        template <typename corpusIter, typename Func>
+        Func push ( corpusIter chunk_first, corpusIter chunk_last, Func f ) {
+            BOOST_STATIC_ASSERT (( boost::is_same<value_type,
+                typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            const difference_type k_pattern_length = searcher_.k_pattern_length;
+            const difference_type k_chunk_length = std::distance ( chunk_first, chunk_last );
+            if ( k_pattern_length == 0 ) {  // empty pattern; nothing to report
+                offset_ += k_chunk_length;
+                return f;
+                }
+
+        //  Matches that start in the tail of the previous chunks; they can
+        //  only end in the first (pattern length - 1) elements of this one.
+            const difference_type k_tail_length = tail_.size ();
+            if ( k_tail_length > 0 && k_chunk_length > 0 ) {
+                tail_.insert ( tail_.end (), chunk_first,
+                        chunk_first + (std::min) ( k_chunk_length, k_pattern_length - 1 ));
+                const tail_iterator tail_first = tail_.begin (), tail_last = tail_.end ();
+                for ( tail_iterator curPos = searcher_ ( tail_first, tail_last );
+                        curPos != tail_last && curPos - tail_first < k_tail_length;
+                            curPos = searcher_.find_next ( curPos, tail_last, search_overlapping ))
+                    f ( offset_ - k_tail_length + ( curPos - tail_first ));
+                tail_.resize ( k_tail_length );
+                }
+
+        //  Matches inside this chunk
+            for ( corpusIter curPos = searcher_ ( chunk_first, chunk_last ); curPos != chunk_last;
+                    curPos = searcher_.find_next ( curPos, chunk_last, search_overlapping ))
+                f ( offset_ + ( curPos - chunk_first ));
+
+        //  Keep the last (pattern length - 1) elements for next time
+            if ( k_chunk_length >= k_pattern_length - 1 )
+                tail_.assign ( chunk_last - ( k_pattern_length - 1 ), chunk_last );
+            else {
+                tail_.insert ( tail_.end (), chunk_first, chunk_last );
+                if ( tail_.size () > static_cast<std::size_t> ( k_pattern_length - 1 ))
+                    tail_.erase ( tail_.begin (), tail_.end () - ( k_pattern_length - 1 ));
+                }
+
+            offset_ += k_chunk_length;
+            return f;
+            }
+
+        /// The number of elements pushed so far
+        offset_type offset () const { return offset_; }
+
+        /// Start over, at the beginning of a new stream
+        void reset () { tail_.clear (); offset_ = 0; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        const boyer_moore_horspool<patIter, traits> &searcher_;
+        std::vector<value_type> tail_;
+        offset_type offset_;
+/// \endcond
+        };
+
 /*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
     Use a bit of TMP to disambiguate the 3-argument templates */
 
@@ -161,12 +354,13 @@ http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
     
     template <typename patIter, typename CorpusRange>
     typename boost::lazy_disable_if_c<
-        boost::is_same<CorpusRange, patIter>::value, typename boost::range_iterator<CorpusRange> >
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
     ::type
     boyer_moore_horspool_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
     {
         boyer_moore_horspool<patIter> bmh ( pat_first, pat_last );
-        return bm (boost::begin (corpus), boost::end (corpus));
+        return bmh (boost::begin (corpus), boost::end (corpus));
     }
     
     template <typename PatternRange, typename CorpusRange>
@@ -194,6 +388,25 @@ http://www-igm.univ-mlv.fr/%7Elecroq/string/node18.html
             <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
         }
 
+    //  The same, with the tables from an allocator
+    template <typename Range, typename Allocator>
+    boost::algorithm::boyer_moore_horspool<typename boost::range_iterator<const Range>::type,
+        detail::BM_traits<typename boost::range_iterator<const Range>::type, Allocator> >
+    make_boyer_moore_horspool ( const Range &r, const Allocator &alloc ) {
+        typedef typename boost::range_iterator<const Range>::type pattern_iterator;
+        return boost::algorithm::boyer_moore_horspool<pattern_iterator, detail::BM_traits<pattern_iterator, Allocator> >
+            (boost::begin(r), boost::end(r), alloc);
+        }
+
+    template <typename Range, typename Allocator>
+    boost::algorithm::boyer_moore_horspool<typename boost::range_iterator<Range>::type,
+        detail::BM_traits<typename boost::range_iterator<Range>::type, Allocator> >
+    make_boyer_moore_horspool ( Range &r, const Allocator &alloc ) {
+        typedef typename boost::range_iterator<Range>::type pattern_iterator;
+        return boost::algorithm::boyer_moore_horspool<pattern_iterator, detail::BM_traits<pattern_iterator, Allocator> >
+            (boost::begin(r), boost::end(r), alloc);
+        }
+
 }}
 
 #endif  //  BOOST_ALGORITHM_BOYER_MOORE_HORSPOOOL_SEARCH_HPP
@@ -0,0 +1,140 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_DETAIL_AC_TRAITS_HPP
+#define BOOST_ALGORITHM_SEARCH_DETAIL_AC_TRAITS_HPP
+
+#include <climits>      // for CHAR_BIT
+#include <vector>
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/cstdint.hpp>
+#include <boost/integer_traits.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+#include <boost/type_traits/is_integral.hpp>
+
+#ifdef BOOST_NO_CXX11_HDR_UNORDERED_MAP
+#include <boost/tr1/tr1/unordered_map>
+#else
+#include <unordered_map>
+#endif
+
+namespace boost { namespace algorithm { namespace detail {
+
+//
+//  Default implementations of the transition tables for Aho-Corasick.
+//  The same trade-off as the B-M skip tables: small alphabets get a
+//  dense array, everything else gets a map.
+//
+    template<typename key_type, typename state_type, bool /*useArray*/> class ac_transition_table;
+
+//  General case for data searching other than bytes; one map of "goto"
+//  transitions per state. Failure links are followed during the search.
+    template<typename key_type, typename state_type>
+    class ac_transition_table<key_type, state_type, false> {
+    private:
+#ifdef BOOST_NO_CXX11_HDR_UNORDERED_MAP
+        typedef std::tr1::unordered_map<key_type, state_type> goto_map;
+#else
+        typedef std::unordered_map<key_type, state_type> goto_map;
+#endif
+        std::vector<goto_map> goto_;
+
+    public:
+        static const state_type k_no_state = boost::integer_traits<state_type>::const_max;
+
+        ac_transition_table () : goto_ ( 1 ) {}     // just the root
+
+        state_type add_state () {
+            goto_.push_back ( goto_map ());
+            return static_cast<state_type> ( goto_.size () - 1 );
+            }
+
+        state_type child ( state_type state, key_type key ) const {
+            typename goto_map::const_iterator it = goto_ [ state ].find ( key );
+            return it == goto_ [ state ].end () ? k_no_state : it->second;
+            }
+
+        void set_child ( state_type state, key_type key, state_type target ) {
+            goto_ [ state ] [ key ] = target;
+            }
+
+    //  Nothing to do; 'next' walks the failure links instead.
+        void complete ( state_type /*state*/, state_type /*fail*/ ) {}
+
+        state_type next ( state_type state, key_type key, const std::vector<state_type> &fail ) const {
+            for ( ;; ) {
+                const state_type target = child ( state, key );
+                if ( target != k_no_state ) return target;
+                if ( state == 0 )           return 0;
+                state = fail [ state ];
+                }
+            }
+        };
+
+
+//  Special case small numeric values; a full DFA, one row of the alphabet
+//  size per state, so that each corpus element costs a single lookup.
+    template<typename key_type, typename state_type>
+    class ac_transition_table<key_type, state_type, true> {
+    private:
+        typedef typename boost::make_unsigned<key_type>::type unsigned_key_type;
+        static const std::size_t k_alphabet = 1U << (CHAR_BIT * sizeof(key_type));
+        std::vector<state_type> table_;
+
+    public:
+        static const state_type k_no_state = boost::integer_traits<state_type>::const_max;
+
+        ac_transition_table () : table_ ( k_alphabet, k_no_state ) {}
+
+        state_type add_state () {
+            table_.resize ( table_.size () + k_alphabet, k_no_state );
+            return static_cast<state_type> ( table_.size () / k_alphabet - 1 );
+            }
+
+        state_type child ( state_type state, key_type key ) const {
+            return table_ [ state * k_alphabet + static_cast<unsigned_key_type> ( key ) ];
+            }
+
+        void set_child ( state_type state, key_type key, state_type target ) {
+            table_ [ state * k_alphabet + static_cast<unsigned_key_type> ( key ) ] = target;
+            }
+
+    //  Fill in the missing transitions of 'state' from the (already complete)
+    //  row of its failure state; missing transitions out of the root go to the root.
+        void complete ( state_type state, state_type fail ) {
+            state_type *row = &table_ [ state * k_alphabet ];
+            const state_type *fail_row = &table_ [ fail * k_alphabet ];
+            for ( std::size_t i = 0; i < k_alphabet; ++i )
+                if ( row [ i ] == k_no_state )
+                    row [ i ] = state == 0 ? 0 : fail_row [ i ];
+            }
+
+        state_type next ( state_type state, key_type key, const std::vector<state_type> &/*fail*/ ) const {
+            return table_ [ state * k_alphabet + static_cast<unsigned_key_type> ( key ) ];
+            }
+        };
+
+    template<typename key_type, typename state_type>
+    const state_type ac_transition_table<key_type, state_type, false>::k_no_state;
+
+    template<typename key_type, typename state_type>
+    const state_type ac_transition_table<key_type, state_type, true>::k_no_state;
+
+    template<typename Iterator>
+    struct AC_traits {
+        typedef typename std::iterator_traits<Iterator>::value_type key_type;
+        typedef boost::uint32_t state_type;
+        typedef boost::algorithm::detail::ac_transition_table<key_type, state_type,
+                boost::is_integral<key_type>::value && (sizeof(key_type)==1)> transition_table_t;
+        };
+
+}}} // namespaces
+
+#endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_AC_TRAITS_HPP
@@ -11,21 +11,28 @@
 #define BOOST_ALGORITHM_SEARCH_DETAIL_BM_TRAITS_HPP
 
 #include <climits>      // for CHAR_BIT
+#include <memory>       // for std::allocator
 #include <vector>
 #include <iterator>     // for std::iterator_traits
 
+#include <boost/array.hpp>
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/has_xxx.hpp>
+#include <boost/mpl/if.hpp>
 #include <boost/type_traits/make_unsigned.hpp>
 #include <boost/type_traits/is_integral.hpp>
 #include <boost/type_traits/remove_pointer.hpp>
 #include <boost/type_traits/remove_const.hpp>
 
-#include <boost/array.hpp>
 #ifdef BOOST_NO_CXX11_HDR_UNORDERED_MAP
 #include <boost/tr1/tr1/unordered_map>
 #else
 #include <unordered_map>
 #endif
 
+#include <boost/algorithm/searching/detail/compact_table.hpp>
 #include <boost/algorithm/searching/detail/debugging.hpp>
 
 namespace boost { namespace algorithm { namespace detail {
@@ -33,23 +40,41 @@ namespace boost { namespace algorithm { namespace detail {
 //
 //  Default implementations of the skip tables for B-M and B-M-H
 //
-    template<typename key_type, typename value_type, bool /*useArray*/> class skip_table;
+//  Besides insert and operator [], a skip table provides width (), the
+//  number of bytes in each entry, and view<Entry> (), which the searchers
+//  call once per search with the entry type that width () calls for
+//  (int8_t, int16_t, int32_t or value_type). The view is what the
+//  inner loop indexes. A table says that it has them with a nested
+//  view_tag; the searchers index any other table directly.
+//
+//  The tables take their memory from an Allocator (std::allocator<char>
+//  by default, or a std::pmr::polymorphic_allocator, for example), which
+//  they rebind to whatever they store.
+//
+    template<typename key_type, typename value_type, bool /*useArray*/,
+             typename Allocator = std::allocator<char> > class skip_table;
 
 //  General case for data searching other than bytes; use a map
-    template<typename key_type, typename value_type>
-    class skip_table<key_type, value_type, false> {
+    template<typename key_type, typename value_type, typename Allocator>
+    class skip_table<key_type, value_type, false, Allocator> {
     private:
+        typedef typename rebind_alloc<Allocator, std::pair<const key_type, value_type> >::type node_allocator;
 #ifdef BOOST_NO_CXX11_HDR_UNORDERED_MAP
-        typedef std::tr1::unordered_map<key_type, value_type> skip_map;
+        typedef std::tr1::unordered_map<key_type, value_type,
+                    std::tr1::hash<key_type>, std::equal_to<key_type>, node_allocator> skip_map;
+        typedef std::tr1::hash<key_type> hasher;
 #else
-        typedef std::unordered_map<key_type, value_type> skip_map;
+        typedef std::unordered_map<key_type, value_type,
+                    std::hash<key_type>, std::equal_to<key_type>, node_allocator> skip_map;
+        typedef std::hash<key_type> hasher;
 #endif
         const value_type k_default_value;
         skip_map skip_;
         
     public:
-        skip_table ( std::size_t patSize, value_type default_value ) 
-            : k_default_value ( default_value ), skip_ ( patSize ) {}
+        skip_table ( std::size_t patSize, value_type default_value, const Allocator &alloc = Allocator ())
+            : k_default_value ( default_value ),
+              skip_ ( patSize, hasher (), std::equal_to<key_type> (), node_allocator ( alloc )) {}
         
         void insert ( key_type key, value_type val ) {
             skip_ [ key ] = val;    // Would skip_.insert (val) be better here?
@@ -59,6 +84,13 @@ namespace boost { namespace algorithm { namespace detail {
             typename skip_map::const_iterator it = skip_.find ( key );
             return it == skip_.end () ? k_default_value : it->second;
             }
+
+    //  The map is not compacted; it is its own view
+        typedef void view_tag;
+        std::size_t width () const { return sizeof ( value_type ); }
+
+        template <typename Entry>
+        const skip_table &view () const { return *this; }
             
         void PrintSkipTable () const {
             std::cout << "BM(H) Skip Table <unordered_map>:" << std::endl;
@@ -70,44 +102,239 @@ namespace boost { namespace algorithm { namespace detail {
         };
         
     
-//  Special case small numeric values; use an array
-    template<typename key_type, typename value_type>
-    class skip_table<key_type, value_type, true> {
+//  Special case small numeric values; use an array, with entries
+//  just wide enough for the pattern length.
+    template<typename key_type, typename value_type, typename Allocator>
+    class skip_table<key_type, value_type, true, Allocator> {
     private:
         typedef typename boost::make_unsigned<key_type>::type unsigned_key_type;
-        typedef boost::array<value_type, 1U << (CHAR_BIT * sizeof(key_type))> skip_map;
+        typedef compact_table<value_type, typename rebind_alloc<Allocator, value_type>::type> skip_map;
+        static const std::size_t k_table_size = 1U << (CHAR_BIT * sizeof(key_type));
         skip_map skip_;
         const value_type k_default_value;
     public:
-        skip_table ( std::size_t patSize, value_type default_value ) : k_default_value ( default_value ) {
-            std::fill_n ( skip_.begin(), skip_.size(), default_value );
+    //  The searchers store values from -1 (B-M) up to the pattern length (B-M-H)
+        skip_table ( std::size_t patSize, value_type default_value, const Allocator &alloc = Allocator ())
+                : skip_ ( k_table_size, -1, static_cast<value_type> ( patSize ),
+                          typename rebind_alloc<Allocator, value_type>::type ( alloc )),
+                  k_default_value ( default_value ) {
+            skip_.fill ( default_value );
             }
         
         void insert ( key_type key, value_type val ) {
-            skip_ [ static_cast<unsigned_key_type> ( key ) ] = val;
+            skip_.set ( static_cast<unsigned_key_type> ( key ), val );
             }
 
         value_type operator [] ( key_type key ) const {
             return skip_ [ static_cast<unsigned_key_type> ( key ) ];
             }
 
+        template <typename Entry>
+        class view_type {
+        public:
+            explicit view_type ( const compact_view<Entry, value_type> &v ) : view_ ( v ) {}
+            value_type operator [] ( key_type key ) const {
+                return view_ [ static_cast<unsigned_key_type> ( key ) ];
+                }
+        private:
+            compact_view<Entry, value_type> view_;
+            };
+
+        typedef void view_tag;
+        std::size_t width () const { return skip_.width (); }
+
+        template <typename Entry>
+        view_type<Entry> view () const { return view_type<Entry> ( skip_.template view<Entry> ()); }
+
         void PrintSkipTable () const {
-            std::cout << "BM(H) Skip Table <boost:array>:" << std::endl;
-            for ( typename skip_map::const_iterator it = skip_.begin (); it != skip_.end (); ++it )
-                if ( *it != k_default_value )
-                    std::cout << "  " << std::distance (skip_.begin (), it) << ": " << *it << std::endl;
+            std::cout << "BM(H) Skip Table <compact_table>:" << std::endl;
+            for ( std::size_t i = 0; i < k_table_size; ++i )
+                if ( skip_ [ i ] != k_default_value )
+                    std::cout << "  " << i << ": " << skip_ [ i ] << std::endl;
             std::cout << std::endl;
             }
         };
 
-    template<typename Iterator>
+//  Integral keys of up to 16 bits (char16_t, UTF-16 text, 16-bit samples);
+//  use a two-level array. The high byte of the key picks a page of 256
+//  entries, and the low byte an entry in the page. Pages are only allocated
+//  for the high bytes that occur in the pattern; all the other high bytes
+//  share a single page of default values.
+    template<typename key_type, typename value_type, typename Allocator = std::allocator<char> >
+    class paged_skip_table {
+    private:
+        typedef typename boost::make_unsigned<key_type>::type unsigned_key_type;
+        static const std::size_t k_page_size = 256;
+        boost::array<boost::uint16_t, 256> pages_;  // the page for each high byte
+        std::vector<value_type, typename rebind_alloc<Allocator, value_type>::type> skip_;  // the pages; page 0 is the default
+        const value_type k_default_value;
+    public:
+        paged_skip_table ( std::size_t, value_type default_value, const Allocator &alloc = Allocator ())
+                : skip_ ( k_page_size, default_value, typename rebind_alloc<Allocator, value_type>::type ( alloc )),
+                  k_default_value ( default_value ) {
+            pages_.fill ( 0 );
+            }
+
+        void insert ( key_type key, value_type val ) {
+            const unsigned_key_type k = static_cast<unsigned_key_type> ( key );
+            boost::uint16_t &page = pages_ [ k >> 8 ];
+            if ( page == 0 ) {
+                page = static_cast<boost::uint16_t> ( skip_.size () / k_page_size );
+                skip_.resize ( skip_.size () + k_page_size, k_default_value );
+                }
+            skip_ [ page * k_page_size + ( k & 0xFF ) ] = val;
+            }
+
+        value_type operator [] ( key_type key ) const {
+            const unsigned_key_type k = static_cast<unsigned_key_type> ( key );
+            return skip_ [ pages_ [ k >> 8 ] * k_page_size + ( k & 0xFF ) ];
+            }
+
+        typedef void view_tag;
+        std::size_t width () const { return sizeof ( value_type ); }
+
+        template <typename Entry>
+        const paged_skip_table &view () const { return *this; }
+
+        void PrintSkipTable () const {
+            std::cout << "BM(H) Skip Table <paged>:" << std::endl;
+            for ( std::size_t hi = 0; hi < pages_.size (); ++hi )
+                if ( pages_ [ hi ] != 0 )
+                    for ( std::size_t lo = 0; lo < k_page_size; ++lo )
+                        if ( skip_ [ pages_ [ hi ] * k_page_size + lo ] != k_default_value )
+                            std::cout << "  " << ( hi * k_page_size + lo ) << ": "
+                                      << skip_ [ pages_ [ hi ] * k_page_size + lo ] << std::endl;
+            std::cout << std::endl;
+            }
+        };
+
+
+//  Wider integral keys (wchar_t, char32_t, UTF-32 text); use a flat
+//  open-addressing hash table, with a power-of-two number of slots, at
+//  most half full, and linear probing. A slot holding the default value
+//  is empty, so a lookup stops at the first slot that either is empty or
+//  holds the key; either way, the value in that slot is the answer.
+//  (The searchers never insert the default value.)
+    template<typename key_type, typename value_type, typename Allocator = std::allocator<char> >
+    class flat_skip_table {
+    private:
+        struct slot {
+            key_type   key;
+            value_type value;
+            };
+
+        static const std::size_t k_sparse_limit = 256;
+        std::vector<slot, typename rebind_alloc<Allocator, slot>::type> skip_;
+        std::size_t mask_;
+        unsigned shift_;
+        const value_type k_default_value;
+
+        std::size_t home ( key_type key ) const {
+        //  Fibonacci hashing; the high bits of the product are the best mixed
+            const boost::uint64_t k_golden = ( static_cast<boost::uint64_t> ( 0x9E3779B9U ) << 32 ) | 0x7F4A7C15U;
+            return static_cast<std::size_t> (( static_cast<boost::uint64_t> ( key ) * k_golden ) >> shift_ );
+            }
+
+    public:
+        flat_skip_table ( std::size_t patSize, value_type default_value, const Allocator &alloc = Allocator ())
+                : skip_ ( typename rebind_alloc<Allocator, slot>::type ( alloc )),
+                  mask_ ( 0 ), shift_ ( 64 ), k_default_value ( default_value ) {
+        //  Most corpus elements are not in the pattern; the emptier the table,
+        //  the more often a lookup stops at the first slot. Short patterns get
+        //  a sparse table, long ones one that is at most half full.
+            const std::size_t wanted = patSize <= k_sparse_limit ? 8 * patSize : 2 * patSize;
+            std::size_t slots = 16;
+            unsigned bits = 4;
+            while ( slots < wanted ) { slots *= 2; ++bits; }
+            const slot empty = { key_type (), default_value };
+            skip_.assign ( slots, empty );
+            mask_  = slots - 1;
+            shift_ = 64 - bits;
+            }
+
+        void insert ( key_type key, value_type val ) {
+            BOOST_ASSERT ( val != k_default_value );
+            std::size_t i = home ( key );
+            while ( skip_ [ i ].value != k_default_value && !( skip_ [ i ].key == key ))
+                i = ( i + 1 ) & mask_;
+            skip_ [ i ].key   = key;
+            skip_ [ i ].value = val;
+            }
+
+        value_type operator [] ( key_type key ) const {
+            std::size_t i = home ( key );
+            while ( skip_ [ i ].value != k_default_value && !( skip_ [ i ].key == key ))
+                i = ( i + 1 ) & mask_;
+            return skip_ [ i ].value;
+            }
+
+        typedef void view_tag;
+        std::size_t width () const { return sizeof ( value_type ); }
+
+        template <typename Entry>
+        const flat_skip_table &view () const { return *this; }
+
+        void PrintSkipTable () const {
+            std::cout << "BM(H) Skip Table <flat>:" << std::endl;
+            for ( std::size_t i = 0; i < skip_.size (); ++i )
+                if ( skip_ [ i ].value != k_default_value )
+                    std::cout << "  " << skip_ [ i ].key << ": " << skip_ [ i ].value << std::endl;
+            std::cout << std::endl;
+            }
+        };
+
+
+//  Pick the skip table for a key type: an array for bytes, a paged array
+//  for 16-bit integers, a flat hash table for wider integers, and
+//  std::unordered_map for everything else.
+    template<typename key_type, typename value_type, typename Allocator = std::allocator<char> >
+    struct select_skip_table {
+        typedef typename boost::mpl::if_c<!boost::is_integral<key_type>::value,
+                    skip_table<key_type, value_type, false, Allocator>,
+                typename boost::mpl::if_c<sizeof(key_type) == 1,
+                    skip_table<key_type, value_type, true, Allocator>,
+                typename boost::mpl::if_c<sizeof(key_type) == 2,
+                    paged_skip_table<key_type, value_type, Allocator>,
+                    flat_skip_table<key_type, value_type, Allocator>
+                >::type >::type >::type type;
+        };
+
+    template<typename Iterator, typename Allocator = std::allocator<char> >
     struct BM_traits {
         typedef typename std::iterator_traits<Iterator>::difference_type value_type;
         typedef typename std::iterator_traits<Iterator>::value_type key_type;
-        typedef boost::algorithm::detail::skip_table<key_type, value_type, 
-                boost::is_integral<key_type>::value && (sizeof(key_type)==1)> skip_table_t;
+        typedef typename select_skip_table<key_type, value_type, Allocator>::type skip_table_t;
+        typedef Allocator allocator_type;
+        };
+
+//  Traits classes written before the skip tables took an allocator
+//  have no allocator_type; their skip tables use the default allocator.
+    BOOST_MPL_HAS_XXX_TRAIT_NAMED_DEF(has_allocator_type, allocator_type, false)
+
+    template<typename Traits, bool = has_allocator_type<Traits>::value>
+    struct traits_allocator {
+        typedef std::allocator<char> type;
+
+        template <typename Table, typename Value>
+        static Table make_table ( std::size_t patSize, Value default_value, const type & ) {
+            return Table ( patSize, default_value );
+            }
+        };
+
+    template<typename Traits>
+    struct traits_allocator<Traits, true> {
+        typedef typename Traits::allocator_type type;
+
+        template <typename Table, typename Value>
+        static Table make_table ( std::size_t patSize, Value default_value, const type &alloc ) {
+            return Table ( patSize, default_value, alloc );
+            }
         };
 
+//  Skip tables supplied by traits classes written before the tables were
+//  compacted have only insert, operator [] and PrintSkipTable.
+    BOOST_MPL_HAS_XXX_TRAIT_NAMED_DEF(has_view_tag, view_tag, false)
+
 }}} // namespaces
 
 #endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_BM_TRAITS_HPP
@@ -0,0 +1,48 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_DETAIL_CASE_FOLD_HPP
+#define BOOST_ALGORITHM_SEARCH_DETAIL_CASE_FOLD_HPP
+
+#include <cstddef>      // for std::size_t
+#include <locale>
+
+#include <boost/array.hpp>
+
+/// \cond DOXYGEN_HIDE
+
+namespace boost { namespace algorithm { namespace detail {
+
+//  Case folding for one-byte characters, looked up once per byte value.
+//  Two characters are equal, ignoring case, if they fold to the same value.
+//  Like boost::algorithm::is_iequal, this folds to upper case with the
+//  ctype facet of the given locale; but the locale is only consulted when
+//  the table is built.
+    class case_fold_table {
+    public:
+        explicit case_fold_table ( const std::locale &loc = std::locale ()) {
+            const std::ctype<char> &ct = std::use_facet<std::ctype<char> > ( loc );
+            for ( std::size_t i = 0; i < fold_.size (); ++i )
+                fold_ [ i ] = static_cast<unsigned char> ( ct.toupper ( static_cast<char> ( i )));
+            }
+
+        template <typename charT>
+        unsigned char operator () ( charT c ) const {
+            return fold_ [ static_cast<unsigned char> ( c ) ];
+            }
+
+    private:
+        boost::array<unsigned char, 256> fold_;
+        };
+
+}}} // namespaces
+
+/// \endcond
+
+#endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_CASE_FOLD_HPP
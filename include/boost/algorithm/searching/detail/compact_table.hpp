@@ -0,0 +1,175 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_DETAIL_COMPACT_TABLE_HPP
+#define BOOST_ALGORITHM_SEARCH_DETAIL_COMPACT_TABLE_HPP
+
+#include <cstddef>      // for std::size_t
+#include <cstring>      // for std::memset, std::memcpy
+#include <memory>       // for std::allocator
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/container/allocator_traits.hpp>
+#include <boost/core/pointer_traits.hpp>
+
+#include <boost/algorithm/searching/detail/debugging.hpp>
+
+/// \cond DOXYGEN_HIDE
+
+namespace boost { namespace algorithm { namespace detail {
+
+//  The searchers' tables take their memory from one allocator, rebound
+//  to whatever each table stores.
+    template<typename Allocator, typename T>
+    struct rebind_alloc {
+        typedef typename boost::container::allocator_traits<Allocator>::
+                    template portable_rebind_alloc<T>::type type;
+        };
+
+//  A read-only view of a compact_table with a known entry type.
+//  The searchers pick the entry type once per search, and then use the view.
+    template <typename Entry, typename Value>
+    class compact_view {
+    public:
+        explicit compact_view ( const Entry *entries ) : entries_ ( entries ) {}
+
+        Value operator [] ( std::size_t i ) const {
+            return static_cast<Value> ( entries_ [ i ] );
+            }
+
+    private:
+        const Entry *entries_;
+        };
+
+//  A table of signed values in a known range, stored in the narrowest
+//  signed type that can hold the range: one, two or four bytes, or
+//  a full Value. The searchers' tables hold offsets into the pattern
+//  (and -1), so for short patterns, each entry takes a byte.
+//  The entries are signed so that reading one is a single sign-extending
+//  load; storing them with a bias would add a subtraction to every shift.
+//
+//  The entries live in a single block, which comes from Allocator (rebound
+//  to Value, so that the block is suitably aligned for any entry type).
+    template <typename Value, typename Allocator = std::allocator<Value> >
+    class compact_table {
+        typedef typename rebind_alloc<Allocator, Value>::type value_allocator;
+        typedef boost::container::allocator_traits<value_allocator> alloc_traits;
+        typedef typename alloc_traits::pointer pointer;
+    public:
+        typedef Allocator allocator_type;
+
+        compact_table ( std::size_t count, Value min_value, Value max_value,
+                        const Allocator &alloc = Allocator ())
+                : alloc_ ( alloc ), width_ ( entry_width ( min_value, max_value )),
+                  count_ ( count ), storage_ (), block_ ( 0 ) {
+            BOOST_ASSERT ( min_value <= max_value );
+            this->allocate ();
+            if ( count_ > 0 )
+                std::memset ( block_, 0, count_ * width_ );
+            }
+
+        compact_table ( const compact_table &other )
+                : alloc_ ( alloc_traits::select_on_container_copy_construction ( other.alloc_ )),
+                  width_ ( other.width_ ), count_ ( other.count_ ), storage_ (), block_ ( 0 ) {
+            this->allocate ();
+            if ( count_ > 0 )
+                std::memcpy ( block_, other.block_, count_ * width_ );
+            }
+
+        ~compact_table () { this->deallocate (); }
+
+        allocator_type get_allocator () const { return allocator_type ( alloc_ ); }
+
+    //  The number of bytes in each entry
+        std::size_t width () const { return width_; }
+
+        std::size_t size () const { return count_; }
+
+        void set ( std::size_t i, Value val ) {
+            BOOST_ASSERT ( i < count_ );
+            switch ( width_ ) {
+                case 1:  static_cast<boost::int8_t  *> ( block_ ) [ i ] = static_cast<boost::int8_t>  ( val ); break;
+                case 2:  static_cast<boost::int16_t *> ( block_ ) [ i ] = static_cast<boost::int16_t> ( val ); break;
+                case 4:  static_cast<boost::int32_t *> ( block_ ) [ i ] = static_cast<boost::int32_t> ( val ); break;
+                default: static_cast<Value *>          ( block_ ) [ i ] = val; break;
+                }
+            }
+
+        void fill ( Value val ) {
+            for ( std::size_t i = 0; i < size (); ++i )
+                set ( i, val );
+            }
+
+    //  For building the table, and for the odd lookup; the searches use view ().
+        Value operator [] ( std::size_t i ) const {
+            BOOST_ASSERT ( i < count_ );
+            switch ( width_ ) {
+                case 1:  return static_cast<const boost::int8_t  *> ( block_ ) [ i ];
+                case 2:  return static_cast<const boost::int16_t *> ( block_ ) [ i ];
+                case 4:  return static_cast<const boost::int32_t *> ( block_ ) [ i ];
+                default: return static_cast<const Value *>          ( block_ ) [ i ];
+                }
+            }
+
+    //  Entry must be the type that width () calls for:
+    //  int8_t, int16_t, int32_t or Value.
+        template <typename Entry>
+        compact_view<Entry, Value> view () const {
+            BOOST_ASSERT ( sizeof ( Entry ) == width_ );
+            return compact_view<Entry, Value> ( static_cast<const Entry *> ( block_ ));
+            }
+
+        void PrintTable () const {
+            std::cout << size () << ": { ";
+            for ( std::size_t i = 0; i < size (); ++i )
+                std::cout << (*this) [ i ] << " ";
+            std::cout << "}" << std::endl;
+            }
+
+    private:
+        value_allocator alloc_;
+        std::size_t width_;
+        std::size_t count_;
+        pointer storage_;       // as the allocator returned it
+        void *block_;           // the same, as a raw pointer
+
+        compact_table &operator = ( const compact_table & );    // not assignable
+
+    //  The number of Values that hold all the entries
+        std::size_t units () const { return ( count_ * width_ + sizeof ( Value ) - 1 ) / sizeof ( Value ); }
+
+        void allocate () {
+            if ( count_ > 0 ) {
+                storage_ = alloc_traits::allocate ( alloc_, units ());
+                block_   = boost::to_address ( storage_ );
+                }
+            }
+
+        void deallocate () {
+            if ( block_ != 0 )
+                alloc_traits::deallocate ( alloc_, storage_, units ());
+            }
+
+        static std::size_t entry_width ( Value min_value, Value max_value ) {
+            if ( min_value >= Value ( -0x80 )   && max_value <= Value ( 0x7F ))   return 1;
+            if ( min_value >= Value ( -0x8000 ) && max_value <= Value ( 0x7FFF )) return 2;
+            if ( sizeof ( Value ) > 4 &&
+                    static_cast<boost::intmax_t> ( min_value ) >= -static_cast<boost::intmax_t> ( 0x7FFFFFFF ) - 1 &&
+                    static_cast<boost::intmax_t> ( max_value ) <=  static_cast<boost::intmax_t> ( 0x7FFFFFFF ))
+                return 4;
+            return sizeof ( Value );
+            }
+        };
+
+}}} // namespaces
+
+/// \endcond
+
+#endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_COMPACT_TABLE_HPP
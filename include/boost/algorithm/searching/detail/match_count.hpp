@@ -0,0 +1,65 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_DETAIL_MATCH_COUNT_HPP
+#define BOOST_ALGORITHM_SEARCH_DETAIL_MATCH_COUNT_HPP
+
+#include <cstddef>      // for std::size_t
+#include <algorithm>    // for std::count
+#include <iterator>     // for std::distance
+
+#include <boost/type_traits/integral_constant.hpp>
+
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/simd.hpp>
+
+/// \cond DOXYGEN_HIDE
+
+namespace boost { namespace algorithm { namespace detail {
+
+//  A pattern of one element matches wherever that element is; overlapping
+//  or not, the count is the same.
+    template <typename corpusIter, typename T>
+    std::size_t count_element ( corpusIter corpus_first, corpusIter corpus_last, const T &value, boost::false_type ) {
+        return static_cast<std::size_t> ( std::count ( corpus_first, corpus_last, value ));
+        }
+
+    template <typename corpusIter, typename T>
+    std::size_t count_element ( corpusIter corpus_first, corpusIter corpus_last, const T &value, boost::true_type ) {
+        return count_byte ( reinterpret_cast<const unsigned char *> ( corpus_first ),
+                            reinterpret_cast<const unsigned char *> ( corpus_last ),
+                            static_cast<unsigned char> ( value ));
+        }
+
+//  The number of matches of the searcher's pattern [pat_first, pat_last) in
+//  the corpus. Longer patterns are counted by the searcher's own find_next,
+//  so an overlapping count resumes a period (rather than one element) past
+//  each match, and a non-overlapping count resumes after it; an empty pattern
+//  is never counted, as find_all reports nothing for it.
+    template <typename Searcher, typename patIter, typename corpusIter>
+    std::size_t count_matches ( const Searcher &searcher, patIter pat_first, patIter pat_last,
+                                corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode ) {
+        const std::ptrdiff_t k_pattern_length = std::distance ( pat_first, pat_last );
+        if ( k_pattern_length == 0 )
+            return 0;
+        if ( k_pattern_length == 1 )
+            return count_element ( corpus_first, corpus_last, *pat_first, is_byte_pointer<corpusIter> ());
+
+        std::size_t retVal = 0;
+        for ( corpusIter curPos = searcher ( corpus_first, corpus_last ); curPos != corpus_last;
+                curPos = searcher.find_next ( curPos, corpus_last, mode ))
+            ++retVal;
+        return retVal;
+        }
+
+}}} // namespaces
+
+/// \endcond
+
+#endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_MATCH_COUNT_HPP
@@ -0,0 +1,112 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_DETAIL_SIMD_HPP
+#define BOOST_ALGORITHM_SEARCH_DETAIL_SIMD_HPP
+
+#include <cstddef>    // for std::size_t
+
+#include <boost/config.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_pointer.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+#include <boost/type_traits/remove_pointer.hpp>
+
+//  Which instruction sets the searchers may use. These follow the compiler's
+//  target flags (-msse2, -mavx2, /arch:AVX2); nothing is detected at run time.
+//  Define BOOST_ALGORITHM_SEARCH_NO_SIMD to get the portable code everywhere.
+#ifndef BOOST_ALGORITHM_SEARCH_NO_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BOOST_ALGORITHM_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define BOOST_ALGORITHM_SEARCH_AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+#if defined(BOOST_MSVC)
+#include <intrin.h>
+#endif
+
+/// \cond DOXYGEN_HIDE
+
+namespace boost { namespace algorithm { namespace detail {
+
+//  Is 'Iter' a pointer to a one-byte integral type (char, signed char, unsigned char)?
+//  Those are the only corpora that the vectorized kernels read directly.
+    template <typename Iter>
+    struct is_byte_pointer : public boost::integral_constant<bool,
+            boost::is_pointer<Iter>::value &&
+            boost::is_integral<typename boost::remove_cv<typename boost::remove_pointer<Iter>::type>::type>::value &&
+            sizeof(typename boost::remove_pointer<Iter>::type) == 1> {};
+
+//  Index of the lowest set bit; 'mask' must not be zero.
+    inline unsigned count_trailing_zeros ( unsigned mask ) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned> ( __builtin_ctz ( mask ));
+#elif defined(BOOST_MSVC)
+        unsigned long idx;
+        _BitScanForward ( &idx, mask );
+        return static_cast<unsigned> ( idx );
+#else
+        unsigned retVal = 0;
+        while (( mask & 1U ) == 0 ) { mask >>= 1; ++retVal; }
+        return retVal;
+#endif
+        }
+
+//  The number of bytes in [first, last) that are equal to 'value'. Each
+//  compare yields 0xFF (that is, -1) in the lanes that match, so subtracting
+//  it counts the matches in per-lane bytes; those are summed (with psadbw)
+//  every 255 blocks, before they can wrap.
+    inline std::size_t count_byte ( const unsigned char *first, const unsigned char *last, unsigned char value ) {
+        const std::size_t n = static_cast<std::size_t> ( last - first );
+        std::size_t retVal = 0;
+        std::size_t i = 0;
+
+#ifdef BOOST_ALGORITHM_SEARCH_AVX2
+        const __m256i value_32 = _mm256_set1_epi8 ( static_cast<char> ( value ));
+        while ( i + 32 <= n ) {
+            __m256i counts = _mm256_setzero_si256 ();
+            for ( int j = 0; j < 255 && i + 32 <= n; ++j, i += 32 ) {
+                const __m256i block = _mm256_loadu_si256 ( reinterpret_cast<const __m256i *> ( first + i ));
+                counts = _mm256_sub_epi8 ( counts, _mm256_cmpeq_epi8 ( block, value_32 ));
+                }
+            const __m256i sums_32 = _mm256_sad_epu8 ( counts, _mm256_setzero_si256 ());
+            const __m128i sums = _mm_add_epi64 ( _mm256_castsi256_si128 ( sums_32 ), _mm256_extracti128_si256 ( sums_32, 1 ));
+            retVal += static_cast<std::size_t> ( _mm_cvtsi128_si32 ( sums ) + _mm_cvtsi128_si32 ( _mm_srli_si128 ( sums, 8 )));
+            }
+#endif
+#ifdef BOOST_ALGORITHM_SEARCH_SSE2
+        const __m128i value_16 = _mm_set1_epi8 ( static_cast<char> ( value ));
+        while ( i + 16 <= n ) {
+            __m128i counts = _mm_setzero_si128 ();
+            for ( int j = 0; j < 255 && i + 16 <= n; ++j, i += 16 ) {
+                const __m128i block = _mm_loadu_si128 ( reinterpret_cast<const __m128i *> ( first + i ));
+                counts = _mm_sub_epi8 ( counts, _mm_cmpeq_epi8 ( block, value_16 ));
+                }
+            const __m128i sums = _mm_sad_epu8 ( counts, _mm_setzero_si128 ());
+            retVal += static_cast<std::size_t> ( _mm_cvtsi128_si32 ( sums ) + _mm_cvtsi128_si32 ( _mm_srli_si128 ( sums, 8 )));
+            }
+#endif
+
+    //  Whatever is left over (or everything, if there's no SIMD support)
+        for ( ; i < n; ++i )
+            retVal += first [ i ] == value ? 1 : 0;
+        return retVal;
+        }
+
+}}} // namespaces
+
+/// \endcond
+
+#endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_SIMD_HPP
@@ -0,0 +1,189 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_DETAIL_SUFFIX_ARRAY_HPP
+#define BOOST_ALGORITHM_SEARCH_DETAIL_SUFFIX_ARRAY_HPP
+
+#include <vector>
+#include <algorithm>    // for std::fill
+
+#include <boost/cstdint.hpp>
+
+/// \cond DOXYGEN_HIDE
+
+namespace boost { namespace algorithm { namespace detail {
+
+//  The bytes of a corpus, as the (unsigned) symbols of a string for SA-IS
+    template <typename Index, typename Iter>
+    class byte_symbols {
+    public:
+        explicit byte_symbols ( Iter first ) : first_ ( first ) {}
+        Index operator [] ( Index i ) const {
+            return static_cast<unsigned char> ( first_ [ i ] );
+            }
+
+    private:
+        Iter first_;
+        };
+
+//  Suffix array construction by induced sorting (SA-IS), after
+//      Nong, Zhang and Chan, "Two Efficient Algorithms for Linear Time
+//      Suffix Array Construction", IEEE Transactions on Computers, 2011.
+//
+//  The string is s[0..n), with symbols in [0, upper]; there is no sentinel.
+//  Sort the LMS (leftmost S-type) suffixes by inducing from their first
+//  symbols, name the LMS substrings, sort those names recursively, and
+//  induce the final order from the sorted LMS suffixes.
+    template <typename Index, typename Symbols>
+    class sais_builder {
+    public:
+        sais_builder ( const Symbols &s, Index n, Index upper, Index *sa )
+            : s_ ( s ), n_ ( n ), sa_ ( sa ), ls_ ( n ), sum_l_ ( upper + 1 ), sum_s_ ( upper + 1 ) {}
+
+        void build () {
+            const Index n = n_;
+            if ( n == 0 ) return;
+            if ( n == 1 ) { sa_ [ 0 ] = 0; return; }
+            if ( n == 2 ) {
+                sa_ [ 0 ] = s_ [ 0 ] < s_ [ 1 ] ? 0 : 1;
+                sa_ [ 1 ] = 1 - sa_ [ 0 ];
+                return;
+                }
+
+        //  Classify the suffixes: ls_ [i] is true for S-type (smaller than the next)
+            for ( Index i = n - 1; i-- > 0; )
+                ls_ [ i ] = s_ [ i ] == s_ [ i + 1 ] ? ls_ [ i + 1 ] : s_ [ i ] < s_ [ i + 1 ];
+
+        //  The buckets: L-type suffixes come first in each, then S-type
+            for ( Index i = 0; i < n; ++i ) {
+                if ( !ls_ [ i ] ) ++sum_s_ [ s_ [ i ]];
+                else              ++sum_l_ [ s_ [ i ] + 1 ];
+                }
+            const Index upper = static_cast<Index> ( sum_l_.size () - 1 );
+            for ( Index c = 0; c <= upper; ++c ) {
+                sum_s_ [ c ] += sum_l_ [ c ];
+                if ( c < upper ) sum_l_ [ c + 1 ] += sum_s_ [ c ];
+                }
+
+            std::vector<Index> lms_map ( n, empty ());
+            std::vector<Index> lms;
+            for ( Index i = 1; i < n; ++i )
+                if ( is_lms ( i )) {
+                    lms_map [ i ] = static_cast<Index> ( lms.size ());
+                    lms.push_back ( i );
+                    }
+            const Index m = static_cast<Index> ( lms.size ());
+
+            induce ( lms );
+            if ( m == 0 ) return;
+
+        //  The LMS suffixes, sorted by their LMS substrings
+            std::vector<Index> sorted_lms;
+            sorted_lms.reserve ( m );
+            for ( Index i = 0; i < n; ++i )
+                if ( lms_map [ sa_ [ i ]] != empty ())
+                    sorted_lms.push_back ( sa_ [ i ] );
+
+        //  Name the LMS substrings; equal substrings get equal names
+            std::vector<Index> rec_s ( m );
+            Index rec_upper = 0;
+            rec_s [ lms_map [ sorted_lms [ 0 ]]] = 0;
+            for ( Index i = 1; i < m; ++i ) {
+                Index l = sorted_lms [ i - 1 ], r = sorted_lms [ i ];
+                const Index end_l = lms_map [ l ] + 1 < m ? lms [ lms_map [ l ] + 1 ] : n;
+                const Index end_r = lms_map [ r ] + 1 < m ? lms [ lms_map [ r ] + 1 ] : n;
+                bool same = end_l - l == end_r - r;
+                if ( same ) {
+                    while ( l < end_l && s_ [ l ] == s_ [ r ] ) {
+                        ++l;
+                        ++r;
+                        }
+                    if ( l == n || r == n || s_ [ l ] != s_ [ r ] )
+                        same = false;
+                    }
+                if ( !same ) ++rec_upper;
+                rec_s [ lms_map [ sorted_lms [ i ]]] = rec_upper;
+                }
+
+        //  Sort the names, and induce from the LMS suffixes in that order
+            std::vector<Index> rec_sa ( m );
+            const Index *rec_symbols = &rec_s [ 0 ];
+            sais_builder<Index, const Index *> ( rec_symbols, m, rec_upper, &rec_sa [ 0 ] ).build ();
+            for ( Index i = 0; i < m; ++i )
+                sorted_lms [ i ] = lms [ rec_sa [ i ]];
+            induce ( sorted_lms );
+            }
+
+    private:
+        const Symbols &s_;
+        const Index n_;
+        Index *sa_;
+        std::vector<bool> ls_;
+        std::vector<Index> sum_l_;  // the start of each bucket
+        std::vector<Index> sum_s_;  // the start of the S-type part of each bucket
+
+        static Index empty () { return static_cast<Index> ( -1 ); }
+        bool is_lms ( Index i ) const { return !ls_ [ i - 1 ] && ls_ [ i ]; }
+
+        void induce ( const std::vector<Index> &lms ) {
+            const Index n = n_;
+            std::fill ( sa_, sa_ + n, empty ());
+            std::vector<Index> buf ( sum_s_ );
+            for ( typename std::vector<Index>::const_iterator it = lms.begin (); it != lms.end (); ++it )
+                sa_ [ buf [ s_ [ *it ]]++ ] = *it;
+
+        //  L-type suffixes, left to right
+            buf = sum_l_;
+            sa_ [ buf [ s_ [ n - 1 ]]++ ] = n - 1;
+            for ( Index i = 0; i < n; ++i ) {
+                const Index v = sa_ [ i ];
+                if ( v != empty () && v >= 1 && !ls_ [ v - 1 ] )
+                    sa_ [ buf [ s_ [ v - 1 ]]++ ] = v - 1;
+                }
+
+        //  S-type suffixes, right to left
+            buf = sum_l_;
+            for ( Index i = n; i-- > 0; ) {
+                const Index v = sa_ [ i ];
+                if ( v != empty () && v >= 1 && ls_ [ v - 1 ] )
+                    sa_ [ --buf [ s_ [ v - 1 ] + 1 ]] = v - 1;
+                }
+            }
+        };
+
+//  The longest common prefix of each suffix and the one before it in
+//  the suffix array (lcp [0] is 0), in linear time; after
+//      Kasai, Lee, Arimura, Arikawa and Park, "Linear-Time Longest-Common-Prefix
+//      Computation in Suffix Arrays and Its Applications", CPM 2001.
+    template <typename Index, typename Iter>
+    void build_lcp ( Iter first, Index n, const Index *sa, Index *lcp ) {
+        if ( n == 0 ) return;
+        std::vector<Index> rank ( n );
+        for ( Index i = 0; i < n; ++i )
+            rank [ sa [ i ]] = i;
+        lcp [ 0 ] = 0;
+        Index h = 0;
+        for ( Index i = 0; i < n; ++i ) {
+            if ( rank [ i ] == 0 ) {
+                h = 0;
+                continue;
+                }
+            const Index j = sa [ rank [ i ] - 1 ];
+            while ( i + h < n && j + h < n && first [ i + h ] == first [ j + h ] )
+                ++h;
+            lcp [ rank [ i ]] = h;
+            if ( h > 0 ) --h;
+            }
+        }
+
+}}}
+
+/// \endcond
+
+#endif  //  BOOST_ALGORITHM_SEARCH_DETAIL_SUFFIX_ARRAY_HPP
@@ -0,0 +1,248 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_FIRST_LAST_FILTER_SEARCH_HPP
+#define BOOST_ALGORITHM_FIRST_LAST_FILTER_SEARCH_HPP
+
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/detail/simd.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A templated version of the "first and last element" filter search.
+
+    Before comparing a candidate position element by element, the search
+    checks that the first and the last elements of the pattern are present
+    at the right distance. When the corpus is a pointer to one-byte data
+    this check is done for 32 (AVX2) or 16 (SSE2) positions at once, and only
+    the positions where both elements match are verified.
+
+References:
+    http://0x80.pl/articles/simd-strfind.html
+
+Requirements:
+        * Random access iterators
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type and be comparable.
+        * The vectorized filter is used when corpusIter is a pointer to a
+            one-byte integral type (char, signed char, unsigned char);
+            all other corpora use the same filter one position at a time.
+*/
+
+    template <typename patIter>
+    class first_last_filter {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+    public:
+        first_last_filter ( patIter first, patIter last )
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )) {}
+
+        ~first_last_filter () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if (    pat_first ==    pat_last ) return corpus_first; // empty pattern matches at start
+
+            const difference_type k_corpus_length  = std::distance ( corpus_first, corpus_last );
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+        //  Do the search
+            return this->do_search ( corpus_first, corpus_last, detail::is_byte_pointer<corpusIter> ());
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+
+    //  Compare the elements between the first and the last ones;
+    //  the filter has already checked those two.
+        template <typename corpusIter>
+        bool verify ( corpusIter curPos ) const {
+            for ( difference_type j = 1; j < k_pattern_length - 1; ++j )
+                if ( !( pat_first [ j ] == curPos [ j ] ))
+                    return false;
+            return true;
+            }
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, false_type )
+        /// \brief The portable search, one candidate position at a time.
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, boost::false_type ) const {
+            const difference_type k_last = k_pattern_length - 1;
+            const corpusIter lastPos = corpus_last - k_pattern_length;
+            for ( corpusIter curPos = corpus_first; curPos <= lastPos; ++curPos )
+                if ( pat_first [ 0 ] == curPos [ 0 ] && pat_first [ k_last ] == curPos [ k_last ] && verify ( curPos ))
+                    return curPos;
+            return corpus_last;     // We didn't find anything
+            }
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, true_type )
+        /// \brief The search over byte pointers; filters a block of positions at a time.
+        ///
+        /// \param corpus_first The start of the data to search (pointer to bytes)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, boost::true_type ) const {
+            const unsigned char *first = reinterpret_cast<const unsigned char *> ( corpus_first );
+            const std::size_t k_last     = static_cast<std::size_t> ( k_pattern_length - 1 );
+            const std::size_t last_start = static_cast<std::size_t> ( corpus_last - corpus_first ) - k_last - 1;
+            const unsigned char first_elem = static_cast<unsigned char> ( pat_first [ 0 ] );
+            const unsigned char last_elem  = static_cast<unsigned char> ( pat_first [ k_last ] );
+            std::size_t i = 0;  // the candidate position we're checking
+
+#ifdef BOOST_ALGORITHM_SEARCH_AVX2
+            const __m256i first_32 = _mm256_set1_epi8 ( static_cast<char> ( first_elem ));
+            const __m256i last_32  = _mm256_set1_epi8 ( static_cast<char> ( last_elem ));
+            for ( ; i + 31 <= last_start; i += 32 ) {
+                const __m256i block_first = _mm256_loadu_si256 ( reinterpret_cast<const __m256i *> ( first + i ));
+                const __m256i block_last  = _mm256_loadu_si256 ( reinterpret_cast<const __m256i *> ( first + i + k_last ));
+                unsigned mask = static_cast<unsigned> ( _mm256_movemask_epi8 ( _mm256_and_si256 (
+                                    _mm256_cmpeq_epi8 ( block_first, first_32 ),
+                                    _mm256_cmpeq_epi8 ( block_last,  last_32 ))));
+                while ( mask != 0 ) {
+                    const std::size_t pos = i + detail::count_trailing_zeros ( mask );
+                    if ( verify ( corpus_first + pos ))
+                        return corpus_first + pos;
+                    mask &= mask - 1;
+                    }
+                }
+#endif
+
+#ifdef BOOST_ALGORITHM_SEARCH_SSE2
+            const __m128i first_16 = _mm_set1_epi8 ( static_cast<char> ( first_elem ));
+            const __m128i last_16  = _mm_set1_epi8 ( static_cast<char> ( last_elem ));
+            for ( ; i + 15 <= last_start; i += 16 ) {
+                const __m128i block_first = _mm_loadu_si128 ( reinterpret_cast<const __m128i *> ( first + i ));
+                const __m128i block_last  = _mm_loadu_si128 ( reinterpret_cast<const __m128i *> ( first + i + k_last ));
+                unsigned mask = static_cast<unsigned> ( _mm_movemask_epi8 ( _mm_and_si128 (
+                                    _mm_cmpeq_epi8 ( block_first, first_16 ),
+                                    _mm_cmpeq_epi8 ( block_last,  last_16 ))));
+                while ( mask != 0 ) {
+                    const std::size_t pos = i + detail::count_trailing_zeros ( mask );
+                    if ( verify ( corpus_first + pos ))
+                        return corpus_first + pos;
+                    mask &= mask - 1;
+                    }
+                }
+#endif
+
+        //  Whatever is left over (or everything, if there's no SIMD support)
+            for ( ; i <= last_start; ++i )
+                if ( first [ i ] == first_elem && first [ i + k_last ] == last_elem && verify ( corpus_first + i ))
+                    return corpus_first + i;
+
+            return corpus_last;     // We didn't find anything
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn first_last_filter_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter first_last_filter_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        first_last_filter<patIter> flf ( pat_first, pat_last );
+        return flf ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter first_last_filter_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        first_last_filter<pattern_iterator> flf ( boost::begin(pattern), boost::end (pattern));
+        return flf ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value, typename boost::range_iterator<CorpusRange> >
+    ::type
+    first_last_filter_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        first_last_filter<patIter> flf ( pat_first, pat_last );
+        return flf (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    first_last_filter_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        first_last_filter<pattern_iterator> flf ( boost::begin(pattern), boost::end (pattern));
+        return flf (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::first_last_filter<typename boost::range_iterator<const Range>::type>
+    make_first_last_filter ( const Range &r ) {
+        return boost::algorithm::first_last_filter
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    template <typename Range>
+    boost::algorithm::first_last_filter<typename boost::range_iterator<Range>::type>
+    make_first_last_filter ( Range &r ) {
+        return boost::algorithm::first_last_filter
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_FIRST_LAST_FILTER_SEARCH_HPP
@@ -0,0 +1,342 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_HASHED_BOYER_MOORE_HORSPOOL_SEARCH_HPP
+#define BOOST_ALGORITHM_HASHED_BOYER_MOORE_HORSPOOL_SEARCH_HPP
+
+#include <vector>
+#include <algorithm>    // for std::copy, std::fill, std::max
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/config.hpp>
+#include <boost/static_assert.hpp>
+
+#ifdef BOOST_NO_CXX11_HDR_FUNCTIONAL
+#include <boost/functional/hash.hpp>
+#else
+#include <functional>   // for std::hash
+#endif
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/detail/bm_traits.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A version of the boyer-moore-horspool searching algorithm for element
+    types that are expensive to hash and to compare, such as the tokens
+    (std::strings) of a tokenized document.
+
+    The plain searcher looks up every corpus element it shifts on in a
+    std::unordered_map, which hashes the element each time, and compares
+    elements with operator ==. This one hashes the pattern once, keys the
+    skip table by hash value, and hashes the corpus lazily, as the search
+    reaches it; each hash is kept while the element is still inside the
+    window of the search. Elements are compared by hash first, and only
+    compared by value when the hashes are equal.
+
+    Requirements:
+        * Random access iterators
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type.
+        * Hash is a hash function for that type.
+*/
+
+/// \cond DOXYGEN_HIDE
+namespace detail {
+
+//  The same hash that the map-based skip table of boyer_moore_horspool uses
+    template <typename T>
+    struct default_element_hash {
+#ifdef BOOST_NO_CXX11_HDR_FUNCTIONAL
+        typedef boost::hash<T> type;
+#else
+        typedef std::hash<T> type;
+#endif
+        };
+
+//  The hashes of the corpus elements near the search window, computed the
+//  first time they are asked for. The search only moves forward, so when
+//  the window runs off the end of the buffer, the hashes that are still
+//  needed are moved down to the start of it.
+    template <typename corpusIter, typename Hash>
+    class hash_window {
+        typedef typename std::iterator_traits<corpusIter>::difference_type difference_type;
+    public:
+        hash_window ( corpusIter first, const Hash &hash, difference_type span )
+            : first_ ( first ), hash_ ( hash ), span_ ( span ), base_ ( 0 ),
+              hashes_ (( std::max ) ( 2 * span, difference_type ( 256 ))), known_ ( hashes_.size (), 0 ) {}
+
+    //  Positions before 'pos' are done with; [pos, pos + span) are about to be used
+        void advance_to ( difference_type pos ) {
+            const difference_type capacity = static_cast<difference_type> ( hashes_.size ());
+            if ( pos + span_ <= base_ + capacity )
+                return;
+            const difference_type keep = base_ + capacity - pos;
+            if ( keep > 0 ) {
+                std::copy ( hashes_.end () - keep, hashes_.end (), hashes_.begin ());
+                std::copy ( known_.end ()  - keep, known_.end (),  known_.begin ());
+                std::fill ( known_.begin () + keep, known_.end (), 0 );
+                }
+            else
+                std::fill ( known_.begin (), known_.end (), 0 );
+            base_ = pos;
+            }
+
+        std::size_t operator [] ( difference_type pos ) {
+            const std::size_t i = static_cast<std::size_t> ( pos - base_ );
+            if ( !known_ [ i ] ) {
+                hashes_ [ i ] = hash_ ( first_ [ pos ] );
+                known_  [ i ] = 1;
+                }
+            return hashes_ [ i ];
+            }
+
+    private:
+        corpusIter first_;
+        const Hash &hash_;
+        const difference_type span_;
+        difference_type base_;              // the corpus position of hashes_ [0]
+        std::vector<std::size_t> hashes_;
+        std::vector<unsigned char> known_;
+        };
+    }
+/// \endcond
+
+    template <typename patIter,
+              typename Hash = typename detail::default_element_hash<typename std::iterator_traits<patIter>::value_type>::type>
+    class hashed_boyer_moore_horspool {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef detail::flat_skip_table<std::size_t, difference_type> skip_table_t;
+    public:
+        hashed_boyer_moore_horspool ( patIter first, patIter last, const Hash &hash = Hash ())
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  hash_ ( hash ), pattern_hashes_ ( k_pattern_length ),
+                  skip_ ( k_pattern_length, k_pattern_length ) {
+            for ( difference_type i = 0; i < k_pattern_length; ++i )
+                pattern_hashes_ [ i ] = hash_ ( pat_first [ i ] );
+        //  Elements with the same hash share an entry; the smaller shift wins,
+        //  which is safe for all of them.
+            for ( difference_type i = 0; i < k_pattern_length - 1; ++i )
+                skip_.insert ( pattern_hashes_ [ i ], k_pattern_length - 1 - i );
+            }
+
+        ~hashed_boyer_moore_horspool () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                typename std::iterator_traits<patIter>::value_type,
+                typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if (    pat_first ==    pat_last ) return corpus_first; // empty pattern matches at start
+
+            const difference_type k_corpus_length = std::distance ( corpus_first, corpus_last );
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+            detail::hash_window<corpusIter, Hash> window ( corpus_first, hash_, k_pattern_length );
+            return corpus_first + this->do_search ( corpus_first, window, 0, k_corpus_length );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( pat_first == pat_last )
+                return corpus_last;
+            const difference_type shift = mode == search_overlapping ? 1 : k_pattern_length;
+            if ( std::distance ( match, corpus_last ) - shift < k_pattern_length )
+                return corpus_last;
+            return (*this) ( match + shift, corpus_last );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<hashed_boyer_moore_horspool, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<hashed_boyer_moore_horspool, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<hashed_boyer_moore_horspool, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// \fn for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f, search_overlap_mode mode )
+        /// \brief Calls f ( match_start ) for each match, in one pass that hashes each
+        ///        corpus element at most once (find_all starts a new pass for each match).
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param f            Called with the start of each match
+        /// \param mode         Whether matches may overlap
+        /// \return             f
+        ///
+        template <typename corpusIter, typename Func>
+        Func for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f,
+                              search_overlap_mode mode = search_overlapping ) const {
+            const difference_type k_corpus_length = std::distance ( corpus_first, corpus_last );
+            if ( k_pattern_length == 0 || k_corpus_length < k_pattern_length )
+                return f;
+            const difference_type shift = mode == search_overlapping ? 1 : k_pattern_length;
+            detail::hash_window<corpusIter, Hash> window ( corpus_first, hash_, k_pattern_length );
+            for ( difference_type pos = this->do_search ( corpus_first, window, 0, k_corpus_length );
+                    pos != k_corpus_length;
+                    pos = this->do_search ( corpus_first, window, pos + shift, k_corpus_length ))
+                f ( corpus_first + pos );
+            return f;
+            }
+
+        template <typename Range, typename Func>
+        Func for_each_match ( Range &r, Func f, search_overlap_mode mode = search_overlapping ) const {
+            return this->for_each_match (boost::begin(r), boost::end(r), f, mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+        Hash hash_;
+        std::vector<std::size_t> pattern_hashes_;
+        skip_table_t skip_;
+
+    //  Returns the position of the first match at or after pos, or k_corpus_length
+        template <typename corpusIter>
+        difference_type do_search ( corpusIter corpus_first, detail::hash_window<corpusIter, Hash> &window,
+                                    difference_type pos, difference_type k_corpus_length ) const {
+            const difference_type lastPos = k_corpus_length - k_pattern_length;
+            while ( pos <= lastPos ) {
+                window.advance_to ( pos );
+            //  Do we match right where we are? Hashes first, then the elements.
+                const std::size_t last_hash = window [ pos + k_pattern_length - 1 ];
+                difference_type j = k_pattern_length - 1;
+                while ( pattern_hashes_ [ j ] == window [ pos + j ] && pat_first [ j ] == corpus_first [ pos + j ] ) {
+                //  We matched - we're done!
+                    if ( j == 0 )
+                        return pos;
+                    j--;
+                    }
+
+                pos += skip_ [ last_hash ];
+                }
+
+            return k_corpus_length;
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn hashed_boyer_moore_horspool_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern, hashing each element at most once.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter hashed_boyer_moore_horspool_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        hashed_boyer_moore_horspool<patIter> hbmh ( pat_first, pat_last );
+        return hbmh ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter hashed_boyer_moore_horspool_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        hashed_boyer_moore_horspool<pattern_iterator> hbmh ( boost::begin(pattern), boost::end (pattern));
+        return hbmh ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
+    ::type
+    hashed_boyer_moore_horspool_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        hashed_boyer_moore_horspool<patIter> hbmh ( pat_first, pat_last );
+        return hbmh (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    hashed_boyer_moore_horspool_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        hashed_boyer_moore_horspool<pattern_iterator> hbmh ( boost::begin(pattern), boost::end (pattern));
+        return hbmh (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::hashed_boyer_moore_horspool<typename boost::range_iterator<const Range>::type>
+    make_hashed_boyer_moore_horspool ( const Range &r ) {
+        return boost::algorithm::hashed_boyer_moore_horspool
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    template <typename Range>
+    boost::algorithm::hashed_boyer_moore_horspool<typename boost::range_iterator<Range>::type>
+    make_hashed_boyer_moore_horspool ( Range &r ) {
+        return boost::algorithm::hashed_boyer_moore_horspool
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_HASHED_BOYER_MOORE_HORSPOOL_SEARCH_HPP
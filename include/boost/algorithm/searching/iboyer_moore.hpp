@@ -0,0 +1,291 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_IBOYER_MOORE_SEARCH_HPP
+#define BOOST_ALGORITHM_IBOYER_MOORE_SEARCH_HPP
+
+#include <vector>
+#include <iterator>     // for std::iterator_traits
+#include <locale>
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/detail/bm_traits.hpp>
+#include <boost/algorithm/searching/detail/case_fold.hpp>
+#include <boost/algorithm/searching/detail/compact_table.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A case-insensitive version of the boyer-moore searching algorithm.
+
+    The pattern is folded (to upper case, with the ctype facet of a locale)
+    once, when the searcher is built. The "bad character" table is filled in
+    for every byte that folds to a character of the pattern, so it is looked
+    up with the corpus byte as it is; the "good suffix" table is built from
+    the folded pattern. The comparisons fold each corpus byte through a
+    256-entry table.
+
+    Requirements:
+        * Random access iterators
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type, which must be
+            a one-byte character type.
+*/
+
+    template <typename patIter>
+    class iboyer_moore {
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef detail::skip_table<unsigned char, difference_type, true> skip_table_t;
+        BOOST_STATIC_ASSERT (( boost::is_integral<value_type>::value && sizeof ( value_type ) == 1 ));
+    public:
+        iboyer_moore ( patIter first, patIter last, const std::locale &loc = std::locale ())
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  fold_ ( loc ), pattern_ ( k_pattern_length ),
+                  skip_ ( k_pattern_length, -1 ),
+                  suffix_ ( k_pattern_length + 1, -1, k_pattern_length ) {
+            for ( difference_type i = 0; i < k_pattern_length; ++i )
+                pattern_ [ i ] = fold_ ( pat_first [ i ] );
+
+        //  Build the skip table for the folded pattern, then copy it out,
+        //  so that each byte gets the skip of the character it folds to.
+            skip_table_t folded ( k_pattern_length, -1 );
+            for ( difference_type i = 0; i < k_pattern_length; ++i )
+                folded.insert ( pattern_ [ i ], i );
+            for ( std::size_t c = 0; c < 256; ++c )
+                skip_.insert ( static_cast<unsigned char> ( c ), folded [ fold_ ( c ) ] );
+
+            detail::build_bm_suffix_table ( pattern_.begin (), pattern_.end (), suffix_ );
+            }
+
+        ~iboyer_moore () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor, ignoring case
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                typename std::iterator_traits<patIter>::value_type,
+                typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if (    pat_first ==    pat_last ) return corpus_first; // empty pattern matches at start
+
+            const difference_type k_corpus_length  = std::distance ( corpus_first, corpus_last );
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+        //  Do the search
+            return this->dispatch_search ( corpus_first, corpus_last, 0 );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+        //  After a full match, suffix_ [ 0 ] is the period of the pattern
+            const difference_type shift = mode == search_overlapping ? suffix_ [ 0 ] : k_pattern_length;
+            if ( pat_first == pat_last || std::distance ( match, corpus_last ) - shift < k_pattern_length )
+                return corpus_last;
+        //  Galil's rule: after a shift by the period, the first (length - period)
+        //  elements are already known to match, and are not compared again.
+            return this->dispatch_search ( match + shift, corpus_last,
+                                           mode == search_overlapping ? k_pattern_length - shift : 0 );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<iboyer_moore, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<iboyer_moore, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<iboyer_moore, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+        detail::case_fold_table fold_;
+        std::vector<unsigned char> pattern_;    // the folded pattern
+        skip_table_t skip_;
+        detail::compact_table<difference_type> suffix_;
+
+    //  Pick the entry type of the tables once, rather than on every lookup;
+    //  both tables hold values from -1 to the pattern length.
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory ) const {
+            switch ( suffix_.width ()) {
+                case 1:  return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<boost::int8_t>  (), suffix_.template view<boost::int8_t>  ());
+                case 2:  return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<boost::int16_t> (), suffix_.template view<boost::int16_t> ());
+                case 4:  return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<boost::int32_t> (), suffix_.template view<boost::int32_t> ());
+                default: return this->do_search ( corpus_first, corpus_last, memory,
+                                    skip_.template view<difference_type> (), suffix_.template view<difference_type> ());
+                }
+            }
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory, const SkipView &skip, const SuffixView &suffix )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param memory       The number of pattern elements already known to
+        ///                     match at the start of the corpus
+        /// \param skip         The bad character table
+        /// \param suffix       The good suffix table
+        ///
+        template <typename corpusIter, typename SkipView, typename SuffixView>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory,
+                               const SkipView &skip, const SuffixView &suffix ) const {
+            corpusIter curPos = corpus_first;
+            const corpusIter lastPos = corpus_last - k_pattern_length;
+            difference_type j, k, m;
+
+            while ( curPos <= lastPos ) {
+            //  Do we match right where we are?
+                j = k_pattern_length;
+                while ( pattern_ [j-1] == fold_ ( curPos [j-1] )) {
+                    j--;
+                //  We matched - we're done!
+                    if ( j == memory )
+                        return curPos;
+                    }
+
+            //  Since we didn't match, figure out how far to skip forward
+                k = skip [ static_cast<unsigned char> ( curPos [ j - 1 ] ) ];
+                m = j - k - 1;
+                if ( k < j && m > suffix [ j ] )
+                    curPos += m;
+                else
+                    curPos += suffix [ j ];
+                memory = 0;
+                }
+
+            return corpus_last;     // We didn't find anything
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn iboyer_moore_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern, ignoring case (in the global locale).
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter iboyer_moore_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        iboyer_moore<patIter> ibm ( pat_first, pat_last );
+        return ibm ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter iboyer_moore_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        iboyer_moore<pattern_iterator> ibm ( boost::begin(pattern), boost::end (pattern));
+        return ibm ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
+    ::type
+    iboyer_moore_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        iboyer_moore<patIter> ibm ( pat_first, pat_last );
+        return ibm (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    iboyer_moore_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        iboyer_moore<pattern_iterator> ibm ( boost::begin(pattern), boost::end (pattern));
+        return ibm (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::iboyer_moore<typename boost::range_iterator<const Range>::type>
+    make_iboyer_moore ( const Range &r, const std::locale &loc = std::locale ()) {
+        return boost::algorithm::iboyer_moore
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r), loc);
+        }
+
+    template <typename Range>
+    boost::algorithm::iboyer_moore<typename boost::range_iterator<Range>::type>
+    make_iboyer_moore ( Range &r, const std::locale &loc = std::locale ()) {
+        return boost::algorithm::iboyer_moore
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r), loc);
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_IBOYER_MOORE_SEARCH_HPP
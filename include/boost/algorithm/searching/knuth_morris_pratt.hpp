@@ -12,17 +12,23 @@
 
 #include <vector>
 #include <iterator>     // for std::iterator_traits
+#include <memory>       // for std::allocator
 
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
 #include <boost/static_assert.hpp>
 
 #include <boost/range/begin.hpp>
 #include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
 
 #include <boost/utility/enable_if.hpp>
 #include <boost/type_traits/is_same.hpp>
 
+#include <boost/algorithm/searching/detail/compact_table.hpp>
 #include <boost/algorithm/searching/detail/debugging.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/match_count.hpp>
 
 // #define  BOOST_ALGORITHM_KNUTH_MORRIS_PRATT_DEBUG
 
@@ -41,21 +47,26 @@ namespace boost { namespace algorithm {
     http://www.inf.fh-flensburg.de/lang/algorithmen/pattern/kmpen.htm
 */
 
-    template <typename patIter>
+    template <typename patIter, typename Allocator = std::allocator<char> > class knuth_morris_pratt_session;
+
+    template <typename patIter, typename Allocator = std::allocator<char> >
     class knuth_morris_pratt {
+        template <typename, typename> friend class knuth_morris_pratt_session;
         typedef typename std::iterator_traits<patIter>::difference_type difference_type;
     public:
-        knuth_morris_pratt ( patIter first, patIter last ) 
+        typedef Allocator allocator_type;
+
+        knuth_morris_pratt ( patIter first, patIter last, const Allocator &alloc = Allocator ())
                 : pat_first ( first ), pat_last ( last ), 
                   k_pattern_length ( std::distance ( pat_first, pat_last )),
-                  skip_ ( k_pattern_length + 1 ) {
+                  skip_ ( k_pattern_length + 1, -1, k_pattern_length, alloc ) {
 #ifdef NEW_KMP
             preKmp ( pat_first, pat_last );
 #else
             init_skip_table ( pat_first, pat_last );
 #endif
 #ifdef BOOST_ALGORITHM_KNUTH_MORRIS_PRATT_DEBUG
-            detail::PrintTable ( skip_.begin (), skip_.end ());
+            skip_.PrintTable ();
 #endif
             }
             
@@ -81,7 +92,7 @@ namespace boost { namespace algorithm {
             if ( k_corpus_length < k_pattern_length ) 
                 return corpus_last;
 
-            return do_search   ( corpus_first, corpus_last, k_corpus_length );
+            return dispatch_search ( corpus_first, corpus_last, k_corpus_length, 0 );
             }
     
         template <typename Range>
@@ -89,29 +100,109 @@ namespace boost { namespace algorithm {
             return (*this) (boost::begin(r), boost::end(r));
             }
 
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        /// 
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( pat_first == pat_last )
+                return corpus_last;
+        //  After a full match, skip_ [ k_pattern_length ] is the length of the longest
+        //  border of the pattern; those elements are already known to match.
+            const difference_type idx   = mode == search_overlapping ? skip_ [ k_pattern_length ] : 0;
+            const corpusIter      start = match + ( k_pattern_length - idx );
+            return dispatch_search ( start, corpus_last, std::distance ( start, corpus_last ), idx );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        /// 
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<knuth_morris_pratt, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<knuth_morris_pratt, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<knuth_morris_pratt, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// \fn count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Counts the matches of the pattern in the corpus, without visiting them one by one
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        std::size_t count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            return detail::count_matches ( *this, pat_first, pat_last, corpus_first, corpus_last, mode );
+            }
+
+        template <typename Range>
+        std::size_t count ( const Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->count (boost::begin(r), boost::end(r), mode);
+            }
+
     private:
 /// \cond DOXYGEN_HIDE
         patIter pat_first, pat_last;
         const difference_type k_pattern_length;
-        std::vector <difference_type> skip_;
+        detail::compact_table <difference_type, typename detail::rebind_alloc<Allocator, difference_type>::type> skip_;
 
-        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last, Pred p )
+    //  Pick the entry type of the skip table once, rather than on every lookup
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last,
+                                     difference_type k_corpus_length, difference_type idx ) const {
+            switch ( skip_.width ()) {
+                case 1:  return do_search ( corpus_first, corpus_last, k_corpus_length, idx,
+                                            skip_.template view<boost::int8_t>  ());
+                case 2:  return do_search ( corpus_first, corpus_last, k_corpus_length, idx,
+                                            skip_.template view<boost::int16_t> ());
+                case 4:  return do_search ( corpus_first, corpus_last, k_corpus_length, idx,
+                                            skip_.template view<boost::int32_t> ());
+                default: return do_search ( corpus_first, corpus_last, k_corpus_length, idx,
+                                            skip_.template view<difference_type> ());
+                }
+            }
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type k_corpus_length, difference_type idx, const SkipView &skip )
         /// \brief Searches the corpus for the pattern that was passed into the constructor
         /// 
         /// \param corpus_first The start of the data to search (Random Access Iterator)
         /// \param corpus_last  One past the end of the data to search
-        /// \param p            A predicate used for the search comparisons.
+        /// \param k_corpus_length The length of the corpus to search
+        /// \param idx          The number of pattern elements already known to
+        ///                     match at the start of the corpus
+        /// \param skip         The skip table
         ///
-        template <typename corpusIter>
+        template <typename corpusIter, typename SkipView>
         corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, 
-                                                difference_type k_corpus_length ) const {
+                                difference_type k_corpus_length, difference_type idx,
+                                const SkipView &skip ) const {
             difference_type match_start = 0;  // position in the corpus that we're matching
             
 #ifdef NEW_KMP
-            int patternIdx = 0;
+            int patternIdx = idx;
+            match_start = idx;
             while ( match_start < k_corpus_length ) {
                 while ( patternIdx > -1 && pat_first[patternIdx] != corpus_first [match_start] )
-                    patternIdx = skip_ [patternIdx]; //<--- Shifting the pattern on mismatch
+                    patternIdx = skip [patternIdx]; //<--- Shifting the pattern on mismatch
 
                 patternIdx++;
                 match_start++; //<--- corpus is always increased by 1
@@ -130,7 +221,7 @@ namespace boost { namespace algorithm {
 //              match_start is in the range 0 .. k_corpus_length - k_pattern_length + 1
 
             const difference_type last_match = k_corpus_length - k_pattern_length;
-            difference_type idx = 0;          // position in the pattern we're comparing
+        //  idx is the position in the pattern we're comparing
 
             while ( match_start <= last_match ) {
                 while ( pat_first [ idx ] == corpus_first [ match_start + idx ] ) {
@@ -138,9 +229,10 @@ namespace boost { namespace algorithm {
                         return corpus_first + match_start;
                     }
             //  Figure out where to start searching again
-           //   assert ( idx - skip_ [ idx ] > 0 ); // we're always moving forward
-                match_start += idx - skip_ [ idx ];
-                idx = skip_ [ idx ] >= 0 ? skip_ [ idx ] : 0;
+           //   assert ( idx - skip [ idx ] > 0 ); // we're always moving forward
+                const difference_type next = skip [ idx ];
+                match_start += idx - next;
+                idx = next >= 0 ? next : 0;
            //   assert ( idx >= 0 && idx < k_pattern_length );
                 }
 #endif
@@ -156,16 +248,17 @@ namespace boost { namespace algorithm {
            int i, j;
         
            i = 0;
-           j = skip_[0] = -1;
+           j = -1;
+           skip_.set ( 0, -1 );
            while (i < count) {
               while (j > -1 && first[i] != first[j])
                  j = skip_[j];
               i++;
               j++;
               if (first[i] == first[j])
-                 skip_[i] = skip_[j];
+                 skip_.set ( i, skip_[j] );
               else
-                 skip_[i] = j;
+                 skip_.set ( i, j );
            }
         }
 
@@ -173,22 +266,105 @@ namespace boost { namespace algorithm {
         void init_skip_table ( patIter first, patIter last ) {
             const difference_type count = std::distance ( first, last );
     
-            int j;
-            skip_ [ 0 ] = -1;
-            for ( int i = 1; i <= count; ++i ) {
+            difference_type j;
+            skip_.set ( 0, -1 );
+            for ( difference_type i = 1; i <= count; ++i ) {
                 j = skip_ [ i - 1 ];
                 while ( j >= 0 ) {
                     if ( first [ j ] == first [ i - 1 ] )
                         break;
                     j = skip_ [ j ];
                     }
-                skip_ [ i ] = j + 1;
+                skip_.set ( i, j + 1 );
                 }
             }
 // \endcond
         };
 
 
+/*
+    A resumable search over a corpus that arrives in pieces (chunks).
+
+    The session reports every (possibly overlapping) match, with its offset
+    from the start of the stream. The only state carried from one chunk to
+    the next is the position in the pattern that has been matched so far,
+    so the chunks can be read with input iterators, and can be discarded
+    as soon as they have been pushed.
+*/
+
+    template <typename patIter, typename Allocator>
+    class knuth_morris_pratt_session {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+    public:
+        typedef boost::uintmax_t offset_type;
+
+        explicit knuth_morris_pratt_session ( const knuth_morris_pratt<patIter, Allocator> &searcher )
+                : searcher_ ( searcher ), idx_ ( 0 ), offset_ ( 0 ) {}
+
+        ~knuth_morris_pratt_session () {}
+
+        /// \fn push ( corpusIter chunk_first, corpusIter chunk_last, Func f )
+        /// \brief Searches the next chunk of the stream
+        ///
+        /// \param chunk_first The start of the chunk (Input Iterator)
+        /// \param chunk_last  One past the end of the chunk
+        /// \param f           Called as f ( offset ) for each match, in order;
+        ///                    offset is the position of the match in the whole stream.
+        /// \return            f
+        ///
+        template <typename corpusIter, typename Func>
+        Func push ( corpusIter chunk_first, corpusIter chunk_last, Func f ) {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                typename std::iterator_traits<patIter>::value_type,
+                typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            const difference_type k_pattern_length = searcher_.k_pattern_length;
+            if ( k_pattern_length == 0 ) {  // empty pattern; nothing to report
+                offset_ += std::distance ( chunk_first, chunk_last );
+                return f;
+                }
+
+            switch ( searcher_.skip_.width ()) {
+                case 1:  return push_chunk ( chunk_first, chunk_last, f, searcher_.skip_.template view<boost::int8_t>  ());
+                case 2:  return push_chunk ( chunk_first, chunk_last, f, searcher_.skip_.template view<boost::int16_t> ());
+                case 4:  return push_chunk ( chunk_first, chunk_last, f, searcher_.skip_.template view<boost::int32_t> ());
+                default: return push_chunk ( chunk_first, chunk_last, f, searcher_.skip_.template view<difference_type> ());
+                }
+            }
+
+        /// The number of elements pushed so far
+        offset_type offset () const { return offset_; }
+
+        /// Start over, at the beginning of a new stream
+        void reset () { idx_ = 0; offset_ = 0; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        const knuth_morris_pratt<patIter, Allocator> &searcher_;
+        difference_type idx_;       // the number of pattern elements matched so far
+        offset_type offset_;
+
+        template <typename corpusIter, typename Func, typename SkipView>
+        Func push_chunk ( corpusIter chunk_first, corpusIter chunk_last, Func f, const SkipView &skip ) {
+            const difference_type k_pattern_length = searcher_.k_pattern_length;
+            const patIter pat_first = searcher_.pat_first;
+            difference_type idx = idx_;
+            for ( ; chunk_first != chunk_last; ++chunk_first ) {
+                ++offset_;
+                while ( idx >= 0 && !( pat_first [ idx ] == *chunk_first ))
+                    idx = skip [ idx ];
+                if ( ++idx == k_pattern_length ) {
+                    f ( offset_ - k_pattern_length );
+                    idx = skip [ k_pattern_length ];
+                    }
+                }
+            idx_ = idx;
+            return f;
+            }
+/// \endcond
+        };
+
+
 /*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
     Use a bit of TMP to disambiguate the 3-argument templates */
 
@@ -221,7 +397,8 @@ namespace boost { namespace algorithm {
     
     template <typename patIter, typename CorpusRange>
     typename boost::lazy_disable_if_c<
-        boost::is_same<CorpusRange, patIter>::value, typename boost::range_iterator<CorpusRange> >
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
     ::type
     knuth_morris_pratt_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
     {
@@ -253,6 +430,21 @@ namespace boost { namespace algorithm {
         return boost::algorithm::knuth_morris_pratt
             <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
         }
+
+    //  The same, with the tables from an allocator
+    template <typename Range, typename Allocator>
+    boost::algorithm::knuth_morris_pratt<typename boost::range_iterator<const Range>::type, Allocator>
+    make_knuth_morris_pratt ( const Range &r, const Allocator &alloc ) {
+        return boost::algorithm::knuth_morris_pratt
+            <typename boost::range_iterator<const Range>::type, Allocator> (boost::begin(r), boost::end(r), alloc);
+        }
+
+    template <typename Range, typename Allocator>
+    boost::algorithm::knuth_morris_pratt<typename boost::range_iterator<Range>::type, Allocator>
+    make_knuth_morris_pratt ( Range &r, const Allocator &alloc ) {
+        return boost::algorithm::knuth_morris_pratt
+            <typename boost::range_iterator<Range>::type, Allocator> (boost::begin(r), boost::end(r), alloc);
+        }
 }}
 
 #endif  // BOOST_ALGORITHM_KNUTH_MORRIS_PRATT_SEARCH_HPP
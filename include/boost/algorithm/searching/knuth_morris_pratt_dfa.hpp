@@ -0,0 +1,379 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_KNUTH_MORRIS_PRATT_DFA_SEARCH_HPP
+#define BOOST_ALGORITHM_KNUTH_MORRIS_PRATT_DFA_SEARCH_HPP
+
+#include <iterator>     // for std::iterator_traits
+#include <memory>       // for std::allocator
+
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/detail/compact_table.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/match_count.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    The Knuth-Morris-Pratt searching algorithm, for one-byte values, with
+    the pattern compiled into a deterministic automaton.
+
+    knuth_morris_pratt follows failure links after a mismatch, in a loop
+    whose trip count depends on the data. Here the failure links are
+    followed once, when the searcher is built: the table has a row of 256
+    transitions for each state (the number of pattern elements matched),
+    so each corpus element costs one table lookup, and the corpus is
+    never read twice.
+
+    Requirements:
+        * Random-access iterators (input iterators for the session)
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type, which must be
+            a one-byte integral type.
+
+    http://en.wikipedia.org/wiki/Knuth-Morris-Pratt_algorithm
+    Sedgewick and Wayne, "Algorithms", 4th edition, section 5.3
+*/
+
+    template <typename patIter, typename Allocator = std::allocator<char> > class knuth_morris_pratt_dfa_session;
+
+    template <typename patIter, typename Allocator = std::allocator<char> >
+    class knuth_morris_pratt_dfa {
+        template <typename, typename> friend class knuth_morris_pratt_dfa_session;
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        BOOST_STATIC_ASSERT (( boost::is_integral<value_type>::value && sizeof ( value_type ) == 1 ));
+        static const std::size_t k_row_size = 256;
+    public:
+        typedef Allocator allocator_type;
+
+        knuth_morris_pratt_dfa ( patIter first, patIter last, const Allocator &alloc = Allocator ())
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  dfa_ ( ( k_pattern_length + 1 ) * k_row_size, 0, k_pattern_length, alloc ) {
+            if ( k_pattern_length > 0 )
+                build_dfa ();
+            }
+
+        ~knuth_morris_pratt_dfa () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                typename std::iterator_traits<patIter>::value_type,
+                typename std::iterator_traits<corpusIter>::value_type>::value ));
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if ( pat_first == pat_last )       return corpus_first; // empty pattern matches at start
+
+            return dispatch_search ( corpus_first, corpus_last, 0 );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( pat_first == pat_last )
+                return corpus_last;
+        //  In overlapping mode, carry on from the state after a full match;
+        //  its row is the row of the longest border of the pattern.
+            return dispatch_search ( match + k_pattern_length, corpus_last,
+                                     mode == search_overlapping ? k_pattern_length : 0 );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<knuth_morris_pratt_dfa, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<knuth_morris_pratt_dfa, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<knuth_morris_pratt_dfa, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// \fn count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Counts the matches of the pattern in the corpus, without visiting them one by one
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        std::size_t count ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            return detail::count_matches ( *this, pat_first, pat_last, corpus_first, corpus_last, mode );
+            }
+
+        template <typename Range>
+        std::size_t count ( const Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->count (boost::begin(r), boost::end(r), mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+        detail::compact_table <difference_type, typename detail::rebind_alloc<Allocator, difference_type>::type> dfa_;
+
+    //  The next state, from 'state' after reading 'c'
+        template <typename DfaView>
+        static difference_type transition ( const DfaView &dfa, difference_type state, value_type c ) {
+            return dfa [ static_cast<std::size_t> ( state ) * k_row_size + static_cast<unsigned char> ( c ) ];
+            }
+
+    //  Pick the entry type of the table once, rather than on every lookup
+        template <typename corpusIter>
+        corpusIter dispatch_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type state ) const {
+            switch ( dfa_.width ()) {
+                case 1:  return do_search ( corpus_first, corpus_last, state, dfa_.template view<boost::int8_t>  ());
+                case 2:  return do_search ( corpus_first, corpus_last, state, dfa_.template view<boost::int16_t> ());
+                case 4:  return do_search ( corpus_first, corpus_last, state, dfa_.template view<boost::int32_t> ());
+                default: return do_search ( corpus_first, corpus_last, state, dfa_.template view<difference_type> ());
+                }
+            }
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type state, const DfaView &dfa )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param state        The number of pattern elements matched just before corpus_first
+        /// \param dfa          The transition table
+        ///
+        template <typename corpusIter, typename DfaView>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last,
+                               difference_type state, const DfaView &dfa ) const {
+            for ( corpusIter curPos = corpus_first; curPos != corpus_last; ++curPos ) {
+                state = transition ( dfa, state, *curPos );
+                if ( state == k_pattern_length )
+                    return curPos - ( k_pattern_length - 1 );
+                }
+            return corpus_last;     // We didn't find anything
+            }
+
+    //  Row 'j' is a copy of the row of the state that the automaton would
+    //  fall back to after a mismatch at 'j' (the restart state), except for
+    //  the transition on pat_first [ j ]. The restart state trails behind
+    //  'j', so its row is always complete when it is copied.
+        void build_dfa () {
+            dfa_.set ( static_cast<unsigned char> ( pat_first [ 0 ] ), 1 );
+            difference_type restart = 0;
+            for ( difference_type j = 1; j <= k_pattern_length; ++j ) {
+                for ( std::size_t c = 0; c < k_row_size; ++c )
+                    dfa_.set ( j * k_row_size + c, dfa_ [ restart * k_row_size + c ] );
+                if ( j < k_pattern_length ) {
+                    const unsigned char c = static_cast<unsigned char> ( pat_first [ j ] );
+                    dfa_.set ( j * k_row_size + c, j + 1 );
+                    restart = dfa_ [ restart * k_row_size + c ];
+                    }
+                }
+            }
+/// \endcond
+        };
+
+
+/*
+    A resumable search over a corpus that arrives in pieces (chunks),
+    using the compiled automaton.
+
+    The session reports every (possibly overlapping) match, with its offset
+    from the start of the stream. The only state carried from one chunk to
+    the next is the state of the automaton.
+*/
+
+    template <typename patIter, typename Allocator>
+    class knuth_morris_pratt_dfa_session {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+    public:
+        typedef boost::uintmax_t offset_type;
+
+        explicit knuth_morris_pratt_dfa_session ( const knuth_morris_pratt_dfa<patIter, Allocator> &searcher )
+                : searcher_ ( searcher ), state_ ( 0 ), offset_ ( 0 ) {}
+
+        ~knuth_morris_pratt_dfa_session () {}
+
+        /// \fn push ( corpusIter chunk_first, corpusIter chunk_last, Func f )
+        /// \brief Searches the next chunk of the stream
+        ///
+        /// \param chunk_first The start of the chunk (Input Iterator)
+        /// \param chunk_last  One past the end of the chunk
+        /// \param f           Called as f ( offset ) for each match, in order;
+        ///                    offset is the position of the match in the whole stream.
+        /// \return            f
+        ///
+        template <typename corpusIter, typename Func>
+        Func push ( corpusIter chunk_first, corpusIter chunk_last, Func f ) {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                typename std::iterator_traits<patIter>::value_type,
+                typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            if ( searcher_.k_pattern_length == 0 ) {  // empty pattern; nothing to report
+                offset_ += std::distance ( chunk_first, chunk_last );
+                return f;
+                }
+
+            switch ( searcher_.dfa_.width ()) {
+                case 1:  return push_chunk ( chunk_first, chunk_last, f, searcher_.dfa_.template view<boost::int8_t>  ());
+                case 2:  return push_chunk ( chunk_first, chunk_last, f, searcher_.dfa_.template view<boost::int16_t> ());
+                case 4:  return push_chunk ( chunk_first, chunk_last, f, searcher_.dfa_.template view<boost::int32_t> ());
+                default: return push_chunk ( chunk_first, chunk_last, f, searcher_.dfa_.template view<difference_type> ());
+                }
+            }
+
+        /// The number of elements pushed so far
+        offset_type offset () const { return offset_; }
+
+        /// Start over, at the beginning of a new stream
+        void reset () { state_ = 0; offset_ = 0; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        const knuth_morris_pratt_dfa<patIter, Allocator> &searcher_;
+        difference_type state_;     // the number of pattern elements matched so far
+        offset_type offset_;
+
+        template <typename corpusIter, typename Func, typename DfaView>
+        Func push_chunk ( corpusIter chunk_first, corpusIter chunk_last, Func f, const DfaView &dfa ) {
+            const difference_type k_pattern_length = searcher_.k_pattern_length;
+            difference_type state = state_;
+            for ( ; chunk_first != chunk_last; ++chunk_first ) {
+                ++offset_;
+                state = knuth_morris_pratt_dfa<patIter, Allocator>::transition ( dfa, state, *chunk_first );
+                if ( state == k_pattern_length )
+                    f ( offset_ - k_pattern_length );
+                }
+            state_ = state;
+            return f;
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn knuth_morris_pratt_dfa_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter knuth_morris_pratt_dfa_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        knuth_morris_pratt_dfa<patIter> kmp ( pat_first, pat_last );
+        return kmp ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter knuth_morris_pratt_dfa_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        knuth_morris_pratt_dfa<pattern_iterator> kmp ( boost::begin(pattern), boost::end (pattern));
+        return kmp ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
+    ::type
+    knuth_morris_pratt_dfa_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        knuth_morris_pratt_dfa<patIter> kmp ( pat_first, pat_last );
+        return kmp (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    knuth_morris_pratt_dfa_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        knuth_morris_pratt_dfa<pattern_iterator> kmp ( boost::begin(pattern), boost::end (pattern));
+        return kmp (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::knuth_morris_pratt_dfa<typename boost::range_iterator<const Range>::type>
+    make_knuth_morris_pratt_dfa ( const Range &r ) {
+        return boost::algorithm::knuth_morris_pratt_dfa
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    template <typename Range>
+    boost::algorithm::knuth_morris_pratt_dfa<typename boost::range_iterator<Range>::type>
+    make_knuth_morris_pratt_dfa ( Range &r ) {
+        return boost::algorithm::knuth_morris_pratt_dfa
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    //  The same, with the tables from an allocator
+    template <typename Range, typename Allocator>
+    boost::algorithm::knuth_morris_pratt_dfa<typename boost::range_iterator<const Range>::type, Allocator>
+    make_knuth_morris_pratt_dfa ( const Range &r, const Allocator &alloc ) {
+        return boost::algorithm::knuth_morris_pratt_dfa
+            <typename boost::range_iterator<const Range>::type, Allocator> (boost::begin(r), boost::end(r), alloc);
+        }
+
+    template <typename Range, typename Allocator>
+    boost::algorithm::knuth_morris_pratt_dfa<typename boost::range_iterator<Range>::type, Allocator>
+    make_knuth_morris_pratt_dfa ( Range &r, const Allocator &alloc ) {
+        return boost::algorithm::knuth_morris_pratt_dfa
+            <typename boost::range_iterator<Range>::type, Allocator> (boost::begin(r), boost::end(r), alloc);
+        }
+}}
+
+#endif  // BOOST_ALGORITHM_KNUTH_MORRIS_PRATT_DFA_SEARCH_HPP
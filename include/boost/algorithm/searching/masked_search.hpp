@@ -0,0 +1,674 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_MASKED_SEARCH_HPP
+#define BOOST_ALGORITHM_MASKED_SEARCH_HPP
+
+#include <string>
+#include <vector>
+#include <cstring>      // for std::strlen
+#include <utility>      // for std::pair
+#include <iterator>     // for std::iterator_traits, std::distance
+#include <algorithm>    // for std::sort
+#include <stdexcept>    // for std::invalid_argument
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <boost/type_traits/is_integral.hpp>
+
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/simd.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    Searching for byte patterns with "don't care" bits, such as the
+    signatures of file formats and of malware: "4D 5A ?? ?? 50 45", where
+    each ?? matches any byte, and "4? 0F" matches 40 to 4F, then 0F.
+
+    masked_searcher is a version of Boyer-Moore-Horspool for one such
+    pattern. A wildcard near the end of the pattern would make every shift
+    tiny, so the shift is taken from the byte at the end of the longest run
+    of concrete (fully specified) bytes, rather than from the last byte of
+    the pattern; the run is then a pattern whose skip table is never
+    limited by a wildcard. Candidates are verified 32 (AVX2) or 16 (SSE2)
+    bytes at a time, by comparing (corpus & mask) with the pattern.
+
+    masked_multi_searcher looks for many patterns in one pass. Each pattern
+    is anchored on a pair of adjacent concrete bytes (or one, if it has no
+    such pair); the scan looks up each pair of corpus bytes in a table of
+    anchors, and verifies the patterns found there.
+
+Requirements:
+        * Random access iterators for the corpus
+        * The corpus must "point to" a one-byte integral type (char,
+            signed char or unsigned char).
+        * The vectorized verification is used when the corpus iterator is a
+            pointer; all other corpora are compared a byte at a time.
+*/
+
+/// \class masked_pattern
+/// \brief A sequence of bytes, each with a mask of the bits that must match.
+///
+/// The text form is a sequence of hex bytes, optionally separated by
+/// whitespace, where '?' stands for a "don't care" nibble: "4D 5A ?? ?? 5? 45"
+/// (a lone '?' is a whole "don't care" byte).
+///
+    class masked_pattern {
+    public:
+        masked_pattern () {}
+
+        /// Parses the text form; throws std::invalid_argument if it is malformed
+        explicit masked_pattern ( const char *signature ) {
+            this->parse ( signature, signature + std::strlen ( signature ));
+            }
+
+        explicit masked_pattern ( const std::string &signature ) {
+            this->parse ( signature.data (), signature.data () + signature.size ());
+            }
+
+        /// A pattern of the bytes [first, last), all of them concrete
+        template <typename Iter>
+        masked_pattern ( Iter first, Iter last ) {
+            for ( ; first != last; ++first )
+                this->push_back ( static_cast<unsigned char> ( *first ));
+            }
+
+        /// The bytes [first, last), with the masks starting at mask_first
+        template <typename Iter, typename MaskIter>
+        masked_pattern ( Iter first, Iter last, MaskIter mask_first ) {
+            for ( ; first != last; ++first, ++mask_first )
+                this->push_back ( static_cast<unsigned char> ( *first ), static_cast<unsigned char> ( *mask_first ));
+            }
+
+        /// Appends a byte; the bits that are clear in 'mask' match anything
+        void push_back ( unsigned char value, unsigned char mask = 0xFF ) {
+            values_.push_back ( static_cast<unsigned char> ( value & mask ));
+            masks_.push_back ( mask );
+            }
+
+        std::size_t size () const { return values_.size (); }
+        bool empty () const { return values_.empty (); }
+
+        /// The bits of byte i that must match (the others are zero)
+        unsigned char value ( std::size_t i ) const { return values_ [ i ]; }
+        unsigned char mask  ( std::size_t i ) const { return masks_ [ i ]; }
+
+        /// Does 'c' match byte i of the pattern?
+        bool matches ( std::size_t i, unsigned char c ) const {
+            return static_cast<unsigned char> ( c & masks_ [ i ] ) == values_ [ i ];
+            }
+
+        const unsigned char *values () const { return values_.empty () ? 0 : &values_ [ 0 ]; }
+        const unsigned char *masks  () const { return masks_.empty ()  ? 0 : &masks_ [ 0 ]; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        std::vector<unsigned char> values_;
+        std::vector<unsigned char> masks_;
+
+        static int nibble ( char c ) {
+            if ( c >= '0' && c <= '9' ) return c - '0';
+            if ( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+            if ( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+            if ( c == '?' ) return -1;
+            boost::throw_exception ( std::invalid_argument ( "boost::algorithm::masked_pattern: not a hex digit or '?'" ));
+            return 0;   // not reached
+            }
+
+        static bool is_space ( char c ) {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+            }
+
+        void parse ( const char *first, const char *last ) {
+            while ( first != last ) {
+                if ( is_space ( *first )) { ++first; continue; }
+            //  A lone '?' is a whole byte
+                if ( *first == '?' && ( first + 1 == last || is_space ( first [ 1 ] ))) {
+                    this->push_back ( 0, 0 );
+                    ++first;
+                    continue;
+                    }
+                if ( first + 1 == last || is_space ( first [ 1 ] ))
+                    boost::throw_exception ( std::invalid_argument ( "boost::algorithm::masked_pattern: half a byte" ));
+                const int hi = nibble ( first [ 0 ] );
+                const int lo = nibble ( first [ 1 ] );
+                this->push_back (
+                    static_cast<unsigned char> (( hi < 0 ? 0 : hi << 4 ) | ( lo < 0 ? 0 : lo )),
+                    static_cast<unsigned char> (( hi < 0 ? 0 : 0xF0 ) | ( lo < 0 ? 0 : 0x0F )));
+                first += 2;
+                }
+            }
+/// \endcond
+        };
+
+
+/// \cond DOXYGEN_HIDE
+namespace detail {
+//  Does the pattern match the corpus at 'pos'? The corpus must have at least
+//  pattern.size () bytes there.
+    template <typename corpusIter>
+    bool masked_equal ( const masked_pattern &pattern, corpusIter pos, boost::false_type ) {
+        const std::size_t m = pattern.size ();
+        for ( std::size_t j = 0; j < m; ++j )
+            if ( !pattern.matches ( j, static_cast<unsigned char> ( pos [ j ] )))
+                return false;
+        return true;
+        }
+
+    template <typename corpusIter>
+    bool masked_equal ( const masked_pattern &pattern, corpusIter pos, boost::true_type ) {
+        const unsigned char *p      = reinterpret_cast<const unsigned char *> ( pos );
+        const unsigned char *values = pattern.values ();
+        const unsigned char *masks  = pattern.masks ();
+        const std::size_t m = pattern.size ();
+        std::size_t j = 0;
+
+#ifdef BOOST_ALGORITHM_SEARCH_AVX2
+        for ( ; j + 32 <= m; j += 32 ) {
+            const __m256i block = _mm256_loadu_si256 ( reinterpret_cast<const __m256i *> ( p + j ));
+            const __m256i mask  = _mm256_loadu_si256 ( reinterpret_cast<const __m256i *> ( masks + j ));
+            const __m256i value = _mm256_loadu_si256 ( reinterpret_cast<const __m256i *> ( values + j ));
+            if ( static_cast<unsigned> ( _mm256_movemask_epi8 ( _mm256_cmpeq_epi8 (
+                            _mm256_and_si256 ( block, mask ), value ))) != 0xFFFFFFFFU )
+                return false;
+            }
+#endif
+#ifdef BOOST_ALGORITHM_SEARCH_SSE2
+        for ( ; j + 16 <= m; j += 16 ) {
+            const __m128i block = _mm_loadu_si128 ( reinterpret_cast<const __m128i *> ( p + j ));
+            const __m128i mask  = _mm_loadu_si128 ( reinterpret_cast<const __m128i *> ( masks + j ));
+            const __m128i value = _mm_loadu_si128 ( reinterpret_cast<const __m128i *> ( values + j ));
+            if ( _mm_movemask_epi8 ( _mm_cmpeq_epi8 ( _mm_and_si128 ( block, mask ), value )) != 0xFFFF )
+                return false;
+            }
+#endif
+
+    //  Whatever is left over (or everything, if there's no SIMD support)
+        for ( ; j < m; ++j )
+            if (( p [ j ] & masks [ j ] ) != values [ j ] )
+                return false;
+        return true;
+        }
+
+    template <typename corpusIter>
+    struct is_byte_corpus : public boost::integral_constant<bool,
+            boost::is_integral<typename std::iterator_traits<corpusIter>::value_type>::value &&
+            sizeof(typename std::iterator_traits<corpusIter>::value_type) == 1> {};
+
+//  The pattern id that masked_multi_searcher returns when nothing is found;
+//  a template, so that it can be defined in the header.
+    template <typename Dummy>
+    struct masked_multi_npos {
+        static const std::size_t npos;
+        };
+
+    template <typename Dummy>
+    const std::size_t masked_multi_npos<Dummy>::npos = static_cast<std::size_t> ( -1 );
+    }
+/// \endcond
+
+
+/// \class masked_searcher
+/// \brief A Boyer-Moore-Horspool search for a masked_pattern.
+///
+    class masked_searcher {
+        typedef std::ptrdiff_t difference_type;
+    public:
+        explicit masked_searcher ( const masked_pattern &pattern )
+                : pattern_ ( pattern ), k_pattern_length ( static_cast<difference_type> ( pattern_.size ())) {
+            this->build_skip_table ();
+            }
+
+        ~masked_searcher () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( detail::is_byte_corpus<corpusIter>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if ( k_pattern_length == 0 ) return corpus_first;       // empty pattern matches at start
+
+            const difference_type k_corpus_length = std::distance ( corpus_first, corpus_last );
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+        //  Do the search
+            return this->do_search ( corpus_first, corpus_last );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( k_pattern_length == 0 )
+                return corpus_last;
+            const difference_type shift = mode == search_overlapping ? 1 : k_pattern_length;
+            if ( std::distance ( match, corpus_last ) - shift < k_pattern_length )
+                return corpus_last;
+            return this->do_search ( match + shift, corpus_last );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<masked_searcher, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<masked_searcher, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = k_pattern_length == 0 ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<masked_searcher, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// The pattern that the searcher looks for
+        const masked_pattern &pattern () const { return pattern_; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        masked_pattern pattern_;
+        difference_type k_pattern_length;
+        difference_type anchor_;        // the position in the pattern of the byte that picks the shift
+        difference_type skip_ [ 256 ];
+
+    //  Anchor on the last byte of the longest run of concrete bytes (the last
+    //  such run, if there is a tie). Shifting by k lines up pattern [anchor - k]
+    //  with the corpus byte c that was under the anchor, so the shift for c is
+    //  the smallest k for which that byte of the pattern could be c. Within
+    //  the run that is at most the length of the run; before it, it is at
+    //  least that, so the length of the run is a safe default.
+        void build_skip_table () {
+            difference_type run_start = 0, run_length = 0;
+            for ( difference_type j = 0, len = 0; j < k_pattern_length; ++j ) {
+                len = pattern_.mask ( j ) == 0xFF ? len + 1 : 0;
+                if ( len > 0 && len >= run_length ) {
+                    run_length = len;
+                    run_start  = j - len + 1;
+                    }
+                }
+            if ( run_length == 0 ) {    // no concrete bytes at all
+                run_start  = k_pattern_length - 1;
+                run_length = 1;
+                }
+            anchor_ = run_start + run_length - 1;
+
+            for ( unsigned c = 0; c < 256; ++c )
+                skip_ [ c ] = run_length;
+        //  The bytes closer to the anchor override the ones further away
+            for ( difference_type j = run_start; j < anchor_; ++j )
+                for ( unsigned c = 0; c < 256; ++c )
+                    if ( pattern_.matches ( static_cast<std::size_t> ( j ), static_cast<unsigned char> ( c )))
+                        skip_ [ c ] = anchor_ - j;
+            }
+
+        template <typename corpusIter>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            const std::size_t anchor = static_cast<std::size_t> ( anchor_ );
+            const corpusIter lastPos = corpus_last - k_pattern_length;
+            corpusIter curPos = corpus_first;
+            while ( curPos <= lastPos ) {
+                const unsigned char c = static_cast<unsigned char> ( curPos [ anchor_ ] );
+                if ( pattern_.matches ( anchor, c ) &&
+                        detail::masked_equal ( pattern_, curPos, detail::is_byte_pointer<corpusIter> ()))
+                    return curPos;
+                curPos += skip_ [ c ];
+                }
+
+            return corpus_last;     // We didn't find anything
+            }
+/// \endcond
+        };
+
+
+/// \class masked_multi_searcher
+/// \brief Searches for many masked_patterns in one pass.
+///
+/// Patterns are identified by their position in the range of patterns passed
+/// to the constructor. Empty patterns are not allowed.
+///
+    class masked_multi_searcher : public detail::masked_multi_npos<void> {
+    public:
+        /// The matches found but not yet reported during a scan, as (start, id)
+        typedef std::vector<std::pair<std::size_t, std::size_t> > pending_matches;
+
+        template <typename PatternsIter>
+        masked_multi_searcher ( PatternsIter first, PatternsIter last )
+                : pair_bits_ ( 65536 / 64, 0 ), pair_start_ ( 65536 + 1, 0 ), byte_start_ ( 256 + 1, 0 ),
+                  max_offset_ ( 0 ) {
+            for ( ; first != last; ++first ) {
+                if ( first->empty ())
+                    boost::throw_exception ( std::invalid_argument ( "boost::algorithm::masked_multi_searcher: empty pattern" ));
+                patterns_.push_back ( *first );
+                }
+            this->build_tables ();
+            }
+
+        ~masked_multi_searcher () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the leftmost occurrence of any of the patterns
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \return             The start of the match and the id of the pattern; if
+        ///                     nothing is found, (corpus_last, npos). If several
+        ///                     patterns match there, the lowest id is reported.
+        ///
+        template <typename corpusIter>
+        std::pair<corpusIter, std::size_t> operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            first_match<corpusIter> visit ( corpus_last );
+            pending_matches pending;
+            this->scan ( corpus_first, corpus_last, visit, pending );
+            return std::make_pair ( visit.where, visit.id );
+            }
+
+        template <typename Range>
+        std::pair<typename boost::range_iterator<Range>::type, std::size_t> operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f )
+        /// \brief Reports every occurrence of every pattern in the corpus, in one pass
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param f            Called as f ( pattern_id, match_start ) for each match,
+        ///                     in order of position (and of id, at the same position).
+        /// \return             f
+        ///
+        template <typename corpusIter, typename Func>
+        Func for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f ) const {
+            pending_matches pending;
+            return this->for_each_match ( corpus_first, corpus_last, f, pending );
+            }
+
+        /// \fn for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f, pending_matches &pending )
+        /// \brief The same, with the buffer of pending matches from the caller
+        ///
+        /// 'pending' is cleared first; its storage is reused, so repeated scans
+        /// with the same buffer need not allocate. It never holds more than the
+        /// matches that start in the last (longest pattern) bytes scanned.
+        ///
+        template <typename corpusIter, typename Func>
+        Func for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f, pending_matches &pending ) const {
+            every_match<Func> visit ( f );
+            pending.clear ();
+            this->scan ( corpus_first, corpus_last, visit, pending );
+            return visit.f;
+            }
+
+        template <typename Range, typename Func>
+        Func for_each_match ( Range &r, Func f ) const {
+            return this->for_each_match (boost::begin(r), boost::end(r), f);
+            }
+
+        /// The number of patterns the searcher was built from
+        std::size_t pattern_count () const { return patterns_.size (); }
+
+        /// Pattern number 'id'
+        const masked_pattern &pattern ( std::size_t id ) const { return patterns_ [ id ]; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+    //  Pattern 'id' is checked wherever its anchor is found, 'offset' bytes into it
+        struct anchor {
+            std::size_t id;
+            std::size_t offset;
+            };
+
+        std::vector<masked_pattern> patterns_;
+        std::vector<boost::uint64_t> pair_bits_;    // which of the 65536 byte pairs start an anchor
+        std::vector<std::size_t> pair_start_;       // the anchors of pair p are [pair_start_[p], pair_start_[p+1])
+        std::vector<anchor> pair_anchors_;
+        std::vector<std::size_t> byte_start_;       // the same, for anchors of one byte
+        std::vector<anchor> byte_anchors_;
+        std::vector<std::size_t> unanchored_;       // patterns with no concrete bytes
+        std::size_t max_offset_;
+
+        template <typename corpusIter>
+        struct first_match {
+            explicit first_match ( corpusIter last ) : where ( last ), id ( npos ) {}
+            bool operator () ( std::size_t i, corpusIter pos ) {
+                where = pos;
+                id = i;
+                return true;    // stop
+                }
+            corpusIter where;
+            std::size_t id;
+            };
+
+        template <typename Func>
+        struct every_match {
+            explicit every_match ( Func fn ) : f ( fn ) {}
+            template <typename corpusIter>
+            bool operator () ( std::size_t id, corpusIter pos ) {
+                f ( id, pos );
+                return false;
+                }
+            Func f;
+            };
+
+        static bool by_position ( const std::pair<std::size_t, std::size_t> &a, const std::pair<std::size_t, std::size_t> &b ) {
+            return a < b;
+            }
+
+    //  Anchor each pattern on its first pair of adjacent concrete bytes (preferring
+    //  a pair that is not 00 00, which is common in binary files), or else on its
+    //  first concrete byte. The anchors are grouped by key, in order of id.
+        void build_tables () {
+            std::vector<std::pair<std::size_t, anchor> > pairs, bytes;
+            for ( std::size_t id = 0; id < patterns_.size (); ++id ) {
+                const masked_pattern &p = patterns_ [ id ];
+                std::size_t pair_at = npos, byte_at = npos;
+                for ( std::size_t j = 0; j < p.size (); ++j ) {
+                    if ( p.mask ( j ) != 0xFF ) continue;
+                    if ( byte_at == npos ) byte_at = j;
+                    if ( j + 1 < p.size () && p.mask ( j + 1 ) == 0xFF ) {
+                        const bool zeros = p.value ( j ) == 0 && p.value ( j + 1 ) == 0;
+                        if ( pair_at == npos || ( !zeros && p.value ( pair_at ) == 0 && p.value ( pair_at + 1 ) == 0 ))
+                            pair_at = j;
+                        }
+                    }
+                const anchor a = { id, pair_at != npos ? pair_at : byte_at };
+                if ( pair_at != npos )
+                    pairs.push_back ( std::make_pair ( pair_key ( p.value ( pair_at ), p.value ( pair_at + 1 )), a ));
+                else if ( byte_at != npos )
+                    bytes.push_back ( std::make_pair ( std::size_t ( p.value ( byte_at )), a ));
+                else
+                    unanchored_.push_back ( id );
+                if ( a.offset != npos && a.offset > max_offset_ )
+                    max_offset_ = a.offset;
+                }
+
+            group ( pairs, pair_start_, pair_anchors_ );
+            group ( bytes, byte_start_, byte_anchors_ );
+            for ( std::size_t i = 0; i < pairs.size (); ++i )
+                pair_bits_ [ pairs [ i ].first / 64 ] |= boost::uint64_t ( 1 ) << ( pairs [ i ].first % 64 );
+            }
+
+        static std::size_t pair_key ( unsigned char first, unsigned char second ) {
+            return ( std::size_t ( first ) << 8 ) | second;
+            }
+
+    //  A counting sort of the anchors by key, which keeps them in order of id
+        static void group ( const std::vector<std::pair<std::size_t, anchor> > &keyed,
+                            std::vector<std::size_t> &start, std::vector<anchor> &anchors ) {
+            for ( std::size_t i = 0; i < keyed.size (); ++i )
+                ++start [ keyed [ i ].first + 1 ];
+            for ( std::size_t k = 1; k < start.size (); ++k )
+                start [ k ] += start [ k - 1 ];
+            anchors.resize ( keyed.size ());
+            std::vector<std::size_t> next ( start.begin (), start.end () - 1 );
+            for ( std::size_t i = 0; i < keyed.size (); ++i )
+                anchors [ next [ keyed [ i ].first ]++ ] = keyed [ i ].second;
+            }
+
+    //  Check the anchors in [first, last), found at corpus position i, and
+    //  note the matches as (start, id).
+        template <typename corpusIter>
+        void check ( corpusIter corpus_first, std::size_t n, std::size_t i,
+                     const anchor *first, const anchor *last,
+                     pending_matches &found ) const {
+            for ( ; first != last; ++first ) {
+                if ( first->offset > i ) continue;
+                const std::size_t start = i - first->offset;
+                const masked_pattern &p = patterns_ [ first->id ];
+                if ( p.size () <= n - start &&
+                        detail::masked_equal ( p, corpus_first + start, detail::is_byte_pointer<corpusIter> ()))
+                    found.push_back ( std::make_pair ( start, first->id ));
+                }
+            }
+
+    //  Look at each position of the corpus once. A match is found when the scan
+    //  reaches its anchor, which is at most max_offset_ bytes into it; so once
+    //  the scan is past start + max_offset_, no match can start before 'start',
+    //  and the matches found so far that start there can be reported in order.
+        template <typename corpusIter, typename Visitor>
+        void scan ( corpusIter corpus_first, corpusIter corpus_last, Visitor &visit, pending_matches &found ) const {
+            BOOST_STATIC_ASSERT (( detail::is_byte_corpus<corpusIter>::value ));
+            const std::size_t n = static_cast<std::size_t> ( std::distance ( corpus_first, corpus_last ));
+            if ( patterns_.empty () || n == 0 )
+                return;
+
+            const bool any_bytes = !byte_anchors_.empty ();
+            std::size_t reported = 0;   // found [0, reported) have been reported
+            for ( std::size_t i = 0; i < n; ++i ) {
+                const unsigned char c = static_cast<unsigned char> ( corpus_first [ i ] );
+                if ( i + 1 < n ) {
+                    const std::size_t key = pair_key ( c, static_cast<unsigned char> ( corpus_first [ i + 1 ] ));
+                    if (( pair_bits_ [ key / 64 ] >> ( key % 64 )) & 1 ) {
+                        const anchor *a = &pair_anchors_ [ 0 ];
+                        this->check ( corpus_first, n, i, a + pair_start_ [ key ], a + pair_start_ [ key + 1 ], found );
+                        }
+                    }
+                if ( any_bytes && byte_start_ [ c ] != byte_start_ [ c + 1 ] ) {
+                    const anchor *a = &byte_anchors_ [ 0 ];
+                    this->check ( corpus_first, n, i, a + byte_start_ [ c ], a + byte_start_ [ c + 1 ], found );
+                    }
+                for ( std::size_t k = 0; k < unanchored_.size (); ++k ) {
+                    const masked_pattern &p = patterns_ [ unanchored_ [ k ]];
+                    if ( p.size () <= n - i &&
+                            detail::masked_equal ( p, corpus_first + i, detail::is_byte_pointer<corpusIter> ()))
+                        found.push_back ( std::make_pair ( i, unanchored_ [ k ] ));
+                    }
+
+                if ( found.size () > reported ) {
+                    std::sort ( found.begin () + reported, found.end (), by_position );
+                    const bool last_pos = i + 1 == n;
+                    for ( ; reported < found.size (); ++reported ) {
+                        if ( !last_pos && found [ reported ].first + max_offset_ > i )
+                            break;
+                        if ( visit ( found [ reported ].second, corpus_first + found [ reported ].first ))
+                            return;
+                        }
+                //  Drop what has been reported, so that at most max_offset_
+                //  positions' worth of matches are ever held
+                    found.erase ( found.begin (), found.begin () + reported );
+                    reported = 0;
+                    }
+                }
+            }
+/// \endcond
+        };
+
+
+/// \fn masked_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       const masked_pattern &pattern )
+/// \brief Searches the corpus for the masked pattern.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pattern      The pattern to search for
+///
+    template <typename corpusIter>
+    corpusIter masked_search (
+        corpusIter corpus_first, corpusIter corpus_last, const masked_pattern &pattern )
+    {
+        masked_searcher ms ( pattern );
+        return ms ( corpus_first, corpus_last );
+    }
+
+    template <typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    masked_search ( CorpusRange &corpus, const masked_pattern &pattern )
+    {
+        masked_searcher ms ( pattern );
+        return ms (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+/// \fn masked_multi_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       const PatternsRange &patterns )
+/// \brief Searches the corpus for the leftmost occurrence of any of the masked patterns.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param patterns     A range of masked_patterns to search for
+///
+    template <typename PatternsRange, typename corpusIter>
+    std::pair<corpusIter, std::size_t> masked_multi_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternsRange &patterns )
+    {
+        masked_multi_searcher mms ( boost::begin(patterns), boost::end (patterns));
+        return mms ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternsRange, typename CorpusRange>
+    std::pair<typename boost::range_iterator<CorpusRange>::type, std::size_t>
+    masked_multi_search ( CorpusRange &corpus, const PatternsRange &patterns )
+    {
+        masked_multi_searcher mms ( boost::begin(patterns), boost::end (patterns));
+        return mms (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator function -- take a range of patterns, return an object
+    template <typename PatternsRange>
+    boost::algorithm::masked_multi_searcher make_masked_multi_searcher ( const PatternsRange &patterns ) {
+        return boost::algorithm::masked_multi_searcher ( boost::begin(patterns), boost::end(patterns));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_MASKED_SEARCH_HPP
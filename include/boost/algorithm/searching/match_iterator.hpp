@@ -0,0 +1,76 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_MATCH_ITERATOR_HPP
+#define BOOST_ALGORITHM_SEARCH_MATCH_ITERATOR_HPP
+
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/iterator_categories.hpp>
+#include <boost/range/iterator_range.hpp>
+
+/*! \file
+    Defines an iterator over all the matches that a searcher object
+    (boyer_moore, boyer_moore_horspool, knuth_morris_pratt) finds in a corpus.
+*/
+
+namespace boost { namespace algorithm {
+
+/// \enum search_overlap_mode
+/// \brief Whether a match may start inside the previous one
+///
+    enum search_overlap_mode {
+        search_overlapping,     ///< Report every match ("aa" is found 3 times in "aaaa")
+        search_non_overlapping  ///< Resume the search after the end of each match ("aa" is found twice in "aaaa")
+        };
+
+/// \class search_match_iterator
+/// \brief A forward iterator over the matches of a searcher in a corpus
+///
+/// Dereferencing the iterator gives the start of the current match.
+/// The iterator asks the searcher for the next match with
+/// Searcher::find_next, which resumes the search using what the searcher
+/// already knows about the match it has just found.
+///
+/// The searcher (and its pattern) must outlive the iterator.
+///
+    template <typename Searcher, typename corpusIter>
+    class search_match_iterator :
+        public boost::iterator_facade<
+            search_match_iterator<Searcher, corpusIter>,
+            const corpusIter,
+            boost::forward_traversal_tag> {
+    public:
+        /// Default constructor; a singular iterator
+        search_match_iterator () : searcher_ ( 0 ), match_ (), corpus_last_ (), mode_ ( search_overlapping ) {}
+
+        /// Construct from a searcher, the first match, and the end of the corpus
+        search_match_iterator ( const Searcher &searcher, corpusIter match, corpusIter corpus_last,
+                                search_overlap_mode mode )
+            : searcher_ ( &searcher ), match_ ( match ), corpus_last_ ( corpus_last ), mode_ ( mode ) {}
+
+    private:
+/// \cond DOXYGEN_HIDE
+        friend class ::boost::iterator_core_access;
+
+        const corpusIter &dereference () const { return match_; }
+
+        void increment () { match_ = searcher_->find_next ( match_, corpus_last_, mode_ ); }
+
+        bool equal ( const search_match_iterator &other ) const { return match_ == other.match_; }
+
+        const Searcher *searcher_;
+        corpusIter match_;          // the current match, or corpus_last_
+        corpusIter corpus_last_;
+        search_overlap_mode mode_;
+/// \endcond
+        };
+
+}}
+
+#endif  //  BOOST_ALGORITHM_SEARCH_MATCH_ITERATOR_HPP
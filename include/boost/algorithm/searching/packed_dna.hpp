@@ -0,0 +1,146 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCH_PACKED_DNA_HPP
+#define BOOST_ALGORITHM_SEARCH_PACKED_DNA_HPP
+
+#include <vector>
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <stdexcept>    // for std::invalid_argument
+
+#include <boost/cstdint.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/range/iterator_range.hpp>
+
+/*! \file
+    2-bit packed DNA sequences: 32 bases to a 64-bit word, base i of a word
+    in bits 2i and 2i+1 (A = 0, C = 1, G = 2, T = 3). The sequence is read
+    through a random access iterator, without unpacking it.
+*/
+
+namespace boost { namespace algorithm {
+
+/// \fn dna_code ( Char c )
+/// \brief The 2-bit code of a base: 'A', 'C', 'G' or 'T' (in either case), or the
+///        code itself (0 to 3). Throws std::invalid_argument for anything else.
+///
+    template <typename Char>
+    unsigned dna_code ( Char c ) {
+        switch ( static_cast<int> ( c )) {
+            case 0: case 'A': case 'a': return 0;
+            case 1: case 'C': case 'c': return 1;
+            case 2: case 'G': case 'g': return 2;
+            case 3: case 'T': case 't': return 3;
+            default: break;
+            }
+        boost::throw_exception ( std::invalid_argument ( "boost::algorithm::dna_code: not a base" ));
+        return 0;   // not reached
+        }
+
+/// The letter for a 2-bit code
+    inline char dna_letter ( unsigned code ) { return "ACGT" [ code & 3 ]; }
+
+/// \class packed_dna_iterator
+/// \brief A random access iterator over a 2-bit packed sequence of bases.
+///
+/// Dereferencing gives the code of the base (0 to 3). The words must
+/// outlive the iterator.
+///
+    class packed_dna_iterator :
+        public boost::iterator_facade<
+            packed_dna_iterator,
+            unsigned char,
+            boost::random_access_traversal_tag,
+            unsigned char> {
+    public:
+        /// Default constructor; a singular iterator
+        packed_dna_iterator () : words_ ( 0 ), pos_ ( 0 ) {}
+
+        /// The base at position pos of the packed words
+        packed_dna_iterator ( const boost::uint64_t *words, std::size_t pos ) : words_ ( words ), pos_ ( pos ) {}
+
+        const boost::uint64_t *words () const { return words_; }
+        std::size_t position () const { return pos_; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        friend class ::boost::iterator_core_access;
+
+        unsigned char dereference () const {
+            return static_cast<unsigned char> (( words_ [ pos_ / 32 ] >> ( 2 * ( pos_ % 32 ))) & 3 );
+            }
+
+        bool equal ( const packed_dna_iterator &other ) const { return pos_ == other.pos_; }
+        void increment () { ++pos_; }
+        void decrement () { --pos_; }
+        void advance ( std::ptrdiff_t n ) { pos_ += n; }
+        std::ptrdiff_t distance_to ( const packed_dna_iterator &other ) const {
+            return static_cast<std::ptrdiff_t> ( other.pos_ ) - static_cast<std::ptrdiff_t> ( pos_ );
+            }
+
+        const boost::uint64_t *words_;
+        std::size_t pos_;
+/// \endcond
+        };
+
+    typedef boost::iterator_range<packed_dna_iterator> packed_dna_range;
+
+/// \fn make_packed_dna_range ( const boost::uint64_t *words, std::size_t length )
+/// \brief The first 'length' bases of some packed words (from a file, for example)
+///
+    inline packed_dna_range make_packed_dna_range ( const boost::uint64_t *words, std::size_t length ) {
+        return packed_dna_range ( packed_dna_iterator ( words, 0 ), packed_dna_iterator ( words, length ));
+        }
+
+/// \class packed_dna_sequence
+/// \brief A 2-bit packed sequence of bases, which owns its words.
+///
+    class packed_dna_sequence {
+    public:
+        typedef packed_dna_iterator iterator;
+        typedef packed_dna_iterator const_iterator;
+        typedef unsigned char value_type;
+
+        packed_dna_sequence () : size_ ( 0 ) {}
+
+        /// Packs a sequence of bases (letters or codes; see dna_code)
+        template <typename Iter>
+        packed_dna_sequence ( Iter first, Iter last ) : size_ ( 0 ) {
+            for ( ; first != last; ++first )
+                this->push_back ( dna_code ( *first ));
+            }
+
+        void push_back ( unsigned code ) {
+            if ( size_ % 32 == 0 )
+                words_.push_back ( 0 );
+            words_.back () |= static_cast<boost::uint64_t> ( code & 3 ) << ( 2 * ( size_ % 32 ));
+            ++size_;
+            }
+
+        const_iterator begin () const { return const_iterator ( this->data (), 0 ); }
+        const_iterator end   () const { return const_iterator ( this->data (), size_ ); }
+
+        unsigned char operator [] ( std::size_t i ) const { return this->begin () [ i ]; }
+
+        std::size_t size () const { return size_; }
+        bool empty () const { return size_ == 0; }
+
+        /// The packed words; the unused bases of the last word are zero (A)
+        const boost::uint64_t *data () const { return words_.empty () ? 0 : &words_ [ 0 ]; }
+        std::size_t word_count () const { return words_.size (); }
+
+    private:
+        std::vector<boost::uint64_t> words_;
+        std::size_t size_;
+        };
+
+}}
+
+#endif  //  BOOST_ALGORITHM_SEARCH_PACKED_DNA_HPP
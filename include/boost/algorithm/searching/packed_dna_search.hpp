@@ -0,0 +1,249 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_PACKED_DNA_SEARCH_HPP
+#define BOOST_ALGORITHM_PACKED_DNA_SEARCH_HPP
+
+#include <vector>
+#include <algorithm>    // for std::max
+
+#include <boost/cstdint.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <boost/algorithm/searching/packed_dna.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+#include <boost/algorithm/searching/detail/compact_table.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A searcher for DNA, which works directly on 2-bit packed sequences.
+
+    With only four letters, the skip table of Boyer-Moore-Horspool is
+    nearly useless: almost any base occurs near the end of the pattern,
+    so the shifts are tiny. Instead, the skip table is indexed by the
+    last q bases of the window (a q-gram, as in Wu and Manber's
+    algorithm). There are 4^q of them, and q is picked so that most
+    q-grams do not occur in the pattern at all; for those, the window
+    moves along by m - q + 1. Since the corpus is packed, a q-gram is read
+    with a shift and a mask, and the window is compared with the pattern
+    32 bases (one 64-bit word) at a time.
+
+References:
+    Wu and Manber, "A fast algorithm for multi-pattern searching",
+    Technical Report TR-94-17, University of Arizona, 1994.
+
+Requirements:
+        * The corpus is a range of packed_dna_iterators.
+        * The pattern is a sequence of bases: letters ("ACGT", in either
+            case) or codes (0 to 3), or a packed sequence.
+*/
+
+/// \cond DOXYGEN_HIDE
+namespace detail {
+//  The 32 bases at base position pos of the packed words; bases past the
+//  word last_word are zero.
+    inline boost::uint64_t packed_bases ( const boost::uint64_t *words, std::size_t pos, std::size_t last_word ) {
+        const std::size_t w = pos / 32;
+        const unsigned s = static_cast<unsigned> ( 2 * ( pos % 32 ));
+        boost::uint64_t retVal = words [ w ] >> s;
+        if ( s != 0 && w < last_word )
+            retVal |= words [ w + 1 ] << ( 64 - s );
+        return retVal;
+        }
+    }
+/// \endcond
+
+    class packed_dna_searcher {
+        typedef std::ptrdiff_t difference_type;
+        typedef detail::compact_table<difference_type> skip_table_t;
+    public:
+        template <typename patIter>
+        packed_dna_searcher ( patIter first, patIter last )
+                : pattern_ ( first, last ), k_pattern_length ( static_cast<difference_type> ( pattern_.size ())),
+                  q_ ( pick_q ( k_pattern_length )),
+                  skip_ ( std::size_t ( 1 ) << ( 2 * q_ ), 1, ( std::max ) ( k_pattern_length - q_ + 1, difference_type ( 1 ))),
+                  last_gram_ ( 0 ) {
+            this->build_skip_table ();
+            }
+
+        ~packed_dna_searcher () {}
+
+        /// \fn operator ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the packed data to search
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        packed_dna_iterator operator () ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last ) const {
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if ( k_pattern_length == 0 ) return corpus_first;       // empty pattern matches at start
+            if ( corpus_last - corpus_first < k_pattern_length )
+                return corpus_last;
+            return this->dispatch_search ( corpus_first, corpus_last );
+            }
+
+        template <typename Range>
+        packed_dna_iterator operator () ( const Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( packed_dna_iterator match, packed_dna_iterator corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        packed_dna_iterator find_next ( packed_dna_iterator match, packed_dna_iterator corpus_last, search_overlap_mode mode ) const {
+            if ( k_pattern_length == 0 )
+                return corpus_last;
+            const difference_type shift = mode == search_overlapping ? 1 : k_pattern_length;
+            if ( corpus_last - match - shift < k_pattern_length )
+                return corpus_last;
+            return this->dispatch_search ( match + shift, corpus_last );
+            }
+
+        /// \fn find_all ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        boost::iterator_range<search_match_iterator<packed_dna_searcher, packed_dna_iterator> >
+        find_all ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<packed_dna_searcher, packed_dna_iterator> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const packed_dna_iterator first_match = k_pattern_length == 0 ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<packed_dna_searcher, packed_dna_iterator> >
+        find_all ( const Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+        /// The number of bases in each q-gram of the skip table
+        unsigned q () const { return q_; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        packed_dna_sequence pattern_;
+        const difference_type k_pattern_length;
+        const unsigned q_;
+        skip_table_t skip_;
+        boost::uint64_t last_gram_;     // the last q-gram of the pattern
+
+    //  With 4^q q-grams, and about m of them in the pattern, a q-gram of
+    //  random DNA is unlikely to be in the pattern when 4^q is a few times m.
+        static unsigned pick_q ( difference_type m ) {
+            unsigned q = 1;
+            while ( q < 8 && ( difference_type ( 1 ) << ( 2 * q )) < 4 * m )
+                ++q;
+            return m < static_cast<difference_type> ( q ) ? static_cast<unsigned> ( m ) : q;
+            }
+
+        boost::uint64_t gram_mask () const {
+            return ( boost::uint64_t ( 1 ) << ( 2 * q_ )) - 1;
+            }
+
+        void build_skip_table () {
+            if ( k_pattern_length == 0 ) return;
+            const difference_type m = k_pattern_length;
+            const difference_type q = q_;
+            skip_.fill ( m - q + 1 );
+        //  The q-gram that ends at pattern position j moves the window m - 1 - j;
+        //  later (closer to the end) q-grams override earlier ones.
+            const std::size_t last_word = pattern_.word_count () - 1;
+            for ( difference_type j = q - 1; j < m - 1; ++j ) {
+                const boost::uint64_t g = detail::packed_bases ( pattern_.data (), j - q + 1, last_word ) & gram_mask ();
+                skip_.set ( static_cast<std::size_t> ( g ), m - 1 - j );
+                }
+            last_gram_ = detail::packed_bases ( pattern_.data (), m - q, last_word ) & gram_mask ();
+            }
+
+    //  Pick the entry type of the skip table once, rather than on every lookup
+        packed_dna_iterator dispatch_search ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last ) const {
+            switch ( skip_.width ()) {
+                case 1:  return this->do_search ( corpus_first, corpus_last, skip_.view<boost::int8_t>  ());
+                case 2:  return this->do_search ( corpus_first, corpus_last, skip_.view<boost::int16_t> ());
+                case 4:  return this->do_search ( corpus_first, corpus_last, skip_.view<boost::int32_t> ());
+                default: return this->do_search ( corpus_first, corpus_last, skip_.view<difference_type> ());
+                }
+            }
+
+        template <typename SkipView>
+        packed_dna_iterator do_search ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last, const SkipView &skip ) const {
+            const boost::uint64_t *words = corpus_first.words ();
+            const std::size_t last_word = ( corpus_last.position () - 1 ) / 32;
+            const std::size_t m = static_cast<std::size_t> ( k_pattern_length );
+            const std::size_t gram_offset = m - q_;
+            const boost::uint64_t mask = gram_mask ();
+            const std::size_t lastPos = corpus_last.position () - m;
+            std::size_t pos = corpus_first.position ();
+            while ( pos <= lastPos ) {
+                const boost::uint64_t g = detail::packed_bases ( words, pos + gram_offset, last_word ) & mask;
+                if ( g == last_gram_ && this->matches ( words, pos, last_word ))
+                    return packed_dna_iterator ( words, pos );
+                pos += skip [ static_cast<std::size_t> ( g ) ];
+                }
+            return corpus_last;
+            }
+
+    //  Compare the window with the pattern, a word (32 bases) at a time
+        bool matches ( const boost::uint64_t *words, std::size_t pos, std::size_t last_word ) const {
+            const boost::uint64_t *pat = pattern_.data ();
+            const std::size_t m = static_cast<std::size_t> ( k_pattern_length );
+            const std::size_t full = m / 32;
+            for ( std::size_t i = 0; i < full; ++i )
+                if ( detail::packed_bases ( words, pos + 32 * i, last_word ) != pat [ i ] )
+                    return false;
+            if ( m % 32 == 0 )
+                return true;
+            const boost::uint64_t tail_mask = ( boost::uint64_t ( 1 ) << ( 2 * ( m % 32 ))) - 1;
+            return (( detail::packed_bases ( words, pos + 32 * full, last_word ) ^ pat [ full ] ) & tail_mask ) == 0;
+            }
+/// \endcond
+        };
+
+
+/// \fn packed_dna_search ( packed_dna_iterator corpus_first, packed_dna_iterator corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the packed corpus for the pattern.
+///
+/// \param corpus_first The start of the packed data to search
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (letters, codes, or packed)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter>
+    packed_dna_iterator packed_dna_search (
+                  packed_dna_iterator corpus_first, packed_dna_iterator corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        packed_dna_searcher pds ( pat_first, pat_last );
+        return pds ( corpus_first, corpus_last );
+    }
+
+    template <typename CorpusRange, typename PatternRange>
+    packed_dna_iterator packed_dna_search ( const CorpusRange &corpus, const PatternRange &pattern )
+    {
+        packed_dna_searcher pds ( boost::begin ( pattern ), boost::end ( pattern ));
+        return pds ( boost::begin ( corpus ), boost::end ( corpus ));
+    }
+
+
+    //  Creator function -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::packed_dna_searcher make_packed_dna_searcher ( const Range &r ) {
+        return boost::algorithm::packed_dna_searcher ( boost::begin ( r ), boost::end ( r ));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_PACKED_DNA_SEARCH_HPP
@@ -0,0 +1,298 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_PARALLEL_SEARCH_HPP
+#define BOOST_ALGORITHM_PARALLEL_SEARCH_HPP
+
+#include <vector>
+#include <algorithm>    // for std::min
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/config.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_HDR_EXCEPTION)
+#define BOOST_ALGORITHM_PARALLEL_SEARCH_THREADS
+#include <thread>
+#include <atomic>
+#include <exception>
+#endif
+
+/*
+    Parallel versions of the procedural searching interfaces.
+
+    The corpus is split into one slice per thread. Neighbouring slices overlap
+    by (pattern length - 1) elements, so that a match that straddles two
+    slices is seen in full by the slice where it starts. All the threads share
+    a single (immutable) searcher object.
+
+    The result is the same as the sequential search: the leftmost match.
+    Each slice is searched a block at a time; before each block, a thread
+    checks whether a slice to its left has already found a match, and stops
+    if so. Slices to the left of a match always run to completion.
+
+    Without C++11 threads, the searches are done sequentially.
+*/
+
+namespace boost { namespace algorithm {
+
+/// \class parallel_search_policy
+/// \brief How to split a corpus between threads
+///
+    class parallel_search_policy {
+    public:
+        /// \param num_threads  The number of threads to use (including the caller's);
+        ///                     zero means std::thread::hardware_concurrency
+        /// \param min_slice    Corpora shorter than twice this are searched sequentially,
+        ///                     and no slice is made shorter than this
+        /// \param block_length How far a thread searches between checks for an earlier match
+        explicit parallel_search_policy ( unsigned num_threads = 0,
+                                          std::size_t min_slice = 1U << 16,
+                                          std::size_t block_length = 1U << 18 )
+            : num_threads_ ( num_threads ), min_slice_ ( min_slice ? min_slice : 1 ),
+              block_length_ ( block_length ? block_length : 1 ) {}
+
+        unsigned num_threads () const {
+#ifdef BOOST_ALGORITHM_PARALLEL_SEARCH_THREADS
+            if ( num_threads_ == 0 ) {
+                const unsigned hw = std::thread::hardware_concurrency ();
+                return hw ? hw : 1;
+                }
+#endif
+            return num_threads_ ? num_threads_ : 1;
+            }
+
+        std::size_t min_slice    () const { return min_slice_; }
+        std::size_t block_length () const { return block_length_; }
+
+    private:
+        unsigned num_threads_;
+        std::size_t min_slice_;
+        std::size_t block_length_;
+        };
+
+namespace detail {
+/// \cond DOXYGEN_HIDE
+
+    template <typename Searcher, typename corpusIter>
+    class parallel_search_slices {
+        typedef typename std::iterator_traits<corpusIter>::difference_type difference_type;
+    public:
+        parallel_search_slices ( const Searcher &searcher, corpusIter corpus_first, corpusIter corpus_last,
+                                 difference_type pattern_length, difference_type num_slices,
+                                 difference_type block_length )
+            : searcher_ ( searcher ), corpus_first_ ( corpus_first ), corpus_last_ ( corpus_last ),
+              k_pattern_length ( pattern_length ), k_num_slices ( num_slices ),
+              k_block_length ( block_length ), results_ ( num_slices, -1 )
+#ifdef BOOST_ALGORITHM_PARALLEL_SEARCH_THREADS
+            , errors_ ( num_slices ), found_slice_ ( num_slices )
+#endif
+            {
+            const difference_type k_starts = std::distance ( corpus_first, corpus_last ) - pattern_length + 1;
+            k_slice_length = ( k_starts + num_slices - 1 ) / num_slices;
+            }
+
+        corpusIter run () {
+#ifdef BOOST_ALGORITHM_PARALLEL_SEARCH_THREADS
+            std::vector<std::thread> threads;
+            threads.reserve ( k_num_slices - 1 );
+            try {
+                for ( difference_type i = 1; i < k_num_slices; ++i )
+                    threads.push_back ( std::thread ( &parallel_search_slices::guarded_search, this, i ));
+                }
+            catch ( ... ) {     // couldn't start a thread; do its work here
+                for ( difference_type i = static_cast<difference_type> ( threads.size ()) + 1; i < k_num_slices; ++i )
+                    guarded_search ( i );
+                }
+            guarded_search ( 0 );
+            for ( std::size_t i = 0; i < threads.size (); ++i )
+                threads [ i ].join ();
+#endif
+            for ( difference_type i = 0; i < k_num_slices; ++i ) {
+#ifdef BOOST_ALGORITHM_PARALLEL_SEARCH_THREADS
+                if ( errors_ [ i ] )
+                    std::rethrow_exception ( errors_ [ i ] );
+#else
+                search_slice ( i );
+#endif
+                if ( results_ [ i ] >= 0 )
+                    return corpus_first_ + results_ [ i ];
+                }
+            return corpus_last_;
+            }
+
+    private:
+        const Searcher &searcher_;
+        const corpusIter corpus_first_, corpus_last_;
+        const difference_type k_pattern_length;
+        const difference_type k_num_slices;
+        const difference_type k_block_length;
+        difference_type k_slice_length;         // the number of match positions in each slice
+        std::vector<difference_type> results_;  // the first match in each slice, or -1
+#ifdef BOOST_ALGORITHM_PARALLEL_SEARCH_THREADS
+        std::vector<std::exception_ptr> errors_;
+        std::atomic<difference_type> found_slice_;  // the leftmost slice with a match so far
+
+        void guarded_search ( difference_type slice ) {
+            try { search_slice ( slice ); }
+            catch ( ... ) {
+                errors_ [ slice ] = std::current_exception ();
+                note_found ( slice );   // the slices to the right don't matter any more
+                }
+            }
+
+        bool left_slice_found ( difference_type slice ) const {
+            return found_slice_.load ( std::memory_order_relaxed ) < slice;
+            }
+
+        void note_found ( difference_type slice ) {
+            difference_type prev = found_slice_.load ( std::memory_order_relaxed );
+            while ( slice < prev && !found_slice_.compare_exchange_weak ( prev, slice ))
+                ;
+            }
+#else
+        bool left_slice_found ( difference_type /*slice*/ ) const { return false; }
+        void note_found ( difference_type /*slice*/ ) {}
+#endif
+
+    //  Search the match positions [ start, stop ) of the slice, a block at a time
+        void search_slice ( difference_type slice ) {
+            const difference_type k_starts = std::distance ( corpus_first_, corpus_last_ ) - k_pattern_length + 1;
+            const difference_type start = slice * k_slice_length;
+            const difference_type stop  = (std::min) ( k_starts, start + k_slice_length );
+            for ( difference_type block = start; block < stop; block += k_block_length ) {
+                if ( left_slice_found ( slice ))
+                    return;
+                const corpusIter block_last = corpus_first_ + (std::min) ( stop, block + k_block_length ) + k_pattern_length - 1;
+                const corpusIter res = searcher_ ( corpus_first_ + block, block_last );
+                if ( res != block_last ) {
+                    results_ [ slice ] = res - corpus_first_;
+                    note_found ( slice );
+                    return;
+                    }
+                }
+            }
+        };
+
+    template <typename Searcher, typename corpusIter>
+    corpusIter parallel_search ( const parallel_search_policy &policy, const Searcher &searcher,
+                    corpusIter corpus_first, corpusIter corpus_last,
+                    typename std::iterator_traits<corpusIter>::difference_type pattern_length ) {
+        typedef typename std::iterator_traits<corpusIter>::difference_type difference_type;
+        const difference_type k_corpus_length = std::distance ( corpus_first, corpus_last );
+        const difference_type k_min_slice = static_cast<difference_type> ( policy.min_slice ());
+
+    //  Small jobs (and the odd cases) aren't worth starting threads for
+        if ( pattern_length == 0 || k_corpus_length < pattern_length || k_corpus_length < 2 * k_min_slice )
+            return searcher ( corpus_first, corpus_last );
+
+        const difference_type k_starts = k_corpus_length - pattern_length + 1;
+        const difference_type k_num_slices = (std::min) (
+                static_cast<difference_type> ( policy.num_threads ()),
+                (std::max) ( k_starts / k_min_slice, static_cast<difference_type> ( 1 )));
+        if ( k_num_slices < 2 )
+            return searcher ( corpus_first, corpus_last );
+
+        return parallel_search_slices<Searcher, corpusIter> ( searcher, corpus_first, corpus_last,
+            pattern_length, k_num_slices, static_cast<difference_type> ( policy.block_length ())).run ();
+        }
+
+/// \endcond
+}
+
+/// \fn boyer_moore_search ( const parallel_search_policy &policy,
+///       corpusIter corpus_first, corpusIter corpus_last, patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern, using several threads.
+///
+/// \param policy       How many threads to use, and how to split the corpus
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter boyer_moore_search ( const parallel_search_policy &policy,
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        boyer_moore<patIter> bm ( pat_first, pat_last );
+        return detail::parallel_search ( policy, bm, corpus_first, corpus_last, std::distance ( pat_first, pat_last ));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    boyer_moore_search ( const parallel_search_policy &policy, CorpusRange &corpus, const PatternRange &pattern )
+    {
+        return boyer_moore_search ( policy, boost::begin (corpus), boost::end (corpus),
+                                            boost::begin (pattern), boost::end (pattern));
+    }
+
+/// \fn boyer_moore_horspool_search ( const parallel_search_policy &policy,
+///       corpusIter corpus_first, corpusIter corpus_last, patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern, using several threads.
+///
+/// \param policy       How many threads to use, and how to split the corpus
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter boyer_moore_horspool_search ( const parallel_search_policy &policy,
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        boyer_moore_horspool<patIter> bmh ( pat_first, pat_last );
+        return detail::parallel_search ( policy, bmh, corpus_first, corpus_last, std::distance ( pat_first, pat_last ));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    boyer_moore_horspool_search ( const parallel_search_policy &policy, CorpusRange &corpus, const PatternRange &pattern )
+    {
+        return boyer_moore_horspool_search ( policy, boost::begin (corpus), boost::end (corpus),
+                                                     boost::begin (pattern), boost::end (pattern));
+    }
+
+/// \fn knuth_morris_pratt_search ( const parallel_search_policy &policy,
+///       corpusIter corpus_first, corpusIter corpus_last, patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern, using several threads.
+///
+/// \param policy       How many threads to use, and how to split the corpus
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter knuth_morris_pratt_search ( const parallel_search_policy &policy,
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        knuth_morris_pratt<patIter> kmp ( pat_first, pat_last );
+        return detail::parallel_search ( policy, kmp, corpus_first, corpus_last, std::distance ( pat_first, pat_last ));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    knuth_morris_pratt_search ( const parallel_search_policy &policy, CorpusRange &corpus, const PatternRange &pattern )
+    {
+        return knuth_morris_pratt_search ( policy, boost::begin (corpus), boost::end (corpus),
+                                                   boost::begin (pattern), boost::end (pattern));
+    }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_PARALLEL_SEARCH_HPP
@@ -0,0 +1,450 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_RABIN_KARP_SEARCH_HPP
+#define BOOST_ALGORITHM_RABIN_KARP_SEARCH_HPP
+
+#include <vector>
+#include <utility>      // for std::pair
+#include <iterator>     // for std::iterator_traits, std::distance
+#include <algorithm>    // for std::equal
+#include <stdexcept>    // for std::invalid_argument
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/value_type.hpp>
+
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/make_unsigned.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A version of the Rabin-Karp algorithm, for searching for many patterns
+    of the same length at once.
+
+    Each pattern is hashed with a polynomial hash, and the hashes are kept
+    in a flat (open-addressing) hash table. A hash of the same form is then
+    rolled across the corpus, one element at a time, and looked up in the
+    table; when a hash is found, the corpus is compared with the pattern,
+    so hash collisions never produce false matches.
+
+    The same rolling hash can also split a sequence into content-defined
+    chunks (see rabin_karp_chunks, below).
+
+References:
+    Karp and Rabin, "Efficient randomized pattern-matching algorithms",
+    IBM Journal of Research and Development, 1987.
+
+Requirements:
+        * Random access iterators for the corpus
+        * The patterns and the corpus must "point to" the same underlying
+            integral type.
+        * All the patterns must be the same length.
+
+    Patterns are identified by their position in the range of patterns passed
+    to the constructor.
+*/
+
+/// \cond DOXYGEN_HIDE
+namespace detail {
+    const boost::uint64_t rk_base = 0x100000001B3ULL;  // odd, so multiplying is invertible mod 2^64
+
+    template <typename T>
+    boost::uint64_t rk_symbol ( T t ) {
+        return static_cast<boost::uint64_t> ( static_cast<typename boost::make_unsigned<T>::type> ( t ));
+        }
+
+    inline boost::uint64_t rk_power ( std::size_t n ) {
+        boost::uint64_t retVal = 1;
+        while ( n-- > 0 )
+            retVal *= rk_base;
+        return retVal;
+        }
+
+//  Chunk fingerprints are a polynomial modulo the prime 2^61 - 1, in a base
+//  picked by a seed. Modulo 2^64, Thue-Morse strings collide whatever the
+//  (odd) base; modulo a prime, two different chunks of length L collide
+//  with probability at most L / 2^61 over the choice of base.
+    const boost::uint64_t fp_prime = ( boost::uint64_t ( 1 ) << 61 ) - 1;
+
+    inline boost::uint64_t fp_reduce ( boost::uint64_t x ) {
+        x = ( x & fp_prime ) + ( x >> 61 );
+        return x >= fp_prime ? x - fp_prime : x;
+        }
+
+//  a * b mod 2^61 - 1, for a, b < 2^61, in 64-bit arithmetic: split both
+//  at bit 31, and fold the high parts of the product using 2^61 == 1.
+    inline boost::uint64_t fp_multiply ( boost::uint64_t a, boost::uint64_t b ) {
+        const boost::uint64_t mask31 = ( boost::uint64_t ( 1 ) << 31 ) - 1;
+        const boost::uint64_t mask30 = ( boost::uint64_t ( 1 ) << 30 ) - 1;
+        const boost::uint64_t a_hi = a >> 31, a_lo = a & mask31;
+        const boost::uint64_t b_hi = b >> 31, b_lo = b & mask31;
+        const boost::uint64_t mid  = a_lo * b_hi + a_hi * b_lo;
+        return fp_reduce ( 2 * a_hi * b_hi + ( mid >> 30 ) + (( mid & mask30 ) << 31 ) + a_lo * b_lo );
+        }
+
+    inline boost::uint64_t fp_step ( boost::uint64_t h, boost::uint64_t base, boost::uint64_t c ) {
+        return fp_reduce ( fp_multiply ( h, base ) + fp_reduce ( c ));
+        }
+
+//  The base for a seed: the seed, mixed (splitmix64's finalizer) and
+//  reduced; kept away from 0 and 1, for which every chunk of a length collides.
+    inline boost::uint64_t fp_base ( boost::uint64_t seed ) {
+        boost::uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+        z = ( z ^ ( z >> 30 )) * 0xBF58476D1CE4E5B9ULL;
+        z = ( z ^ ( z >> 27 )) * 0x94D049BB133111EBULL;
+        z = fp_reduce ( z ^ ( z >> 31 ));
+        return z < 2 ? z + 256 : z;
+        }
+    }
+/// \endcond
+
+/// \fn rabin_karp_hash ( Iter first, Iter last )
+/// \brief The polynomial hash that rabin_karp uses, of a sequence of integral values.
+///
+    template <typename Iter>
+    boost::uint64_t rabin_karp_hash ( Iter first, Iter last ) {
+        boost::uint64_t h = 0;
+        for ( ; first != last; ++first )
+            h = h * detail::rk_base + detail::rk_symbol ( *first );
+        return h;
+        }
+
+/// \fn rabin_karp_fingerprint ( Iter first, Iter last, boost::uint64_t seed )
+/// \brief The fingerprint that rabin_karp_chunks gives a chunk: a polynomial
+///     hash modulo 2^61 - 1, in a base picked by 'seed'.
+///
+    template <typename Iter>
+    boost::uint64_t rabin_karp_fingerprint ( Iter first, Iter last, boost::uint64_t seed = 0 ) {
+        const boost::uint64_t base = detail::fp_base ( seed );
+        boost::uint64_t h = 0;
+        for ( ; first != last; ++first )
+            h = detail::fp_step ( h, base, detail::rk_symbol ( *first ));
+        return h;
+        }
+
+    template <typename patIter>
+    class rabin_karp {
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        BOOST_STATIC_ASSERT (( boost::is_integral<value_type>::value ));
+    public:
+        /// The pattern id returned when nothing is found
+        static const std::size_t npos = static_cast<std::size_t> ( -1 );
+
+        template <typename PatternsIter>
+        rabin_karp ( PatternsIter first, PatternsIter last )
+                : k_pattern_length ( 0 ), k_count ( 0 ), shift_ ( 63 ), high_power_ ( 0 ) {
+            for ( ; first != last; ++first ) {
+                const difference_type len = std::distance ( boost::begin ( *first ), boost::end ( *first ));
+                if ( k_count == 0 )
+                    k_pattern_length = len;
+                else if ( len != k_pattern_length )
+                    boost::throw_exception ( std::invalid_argument ( "boost::algorithm::rabin_karp: patterns of different lengths" ));
+                patterns_.insert ( patterns_.end (), boost::begin ( *first ), boost::end ( *first ));
+                ++k_count;
+                }
+            if ( k_pattern_length > 0 )
+                this->build_table ();
+            }
+
+        ~rabin_karp () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the leftmost occurrence of any of the patterns
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \return             The start of the match and the id of the pattern; if
+        ///                     nothing is found, (corpus_last, npos). If several
+        ///                     (identical) patterns match there, the lowest id is reported.
+        ///
+        template <typename corpusIter>
+        std::pair<corpusIter, std::size_t> operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            first_match<corpusIter> found ( corpus_last );
+            this->scan ( corpus_first, corpus_last, found );
+            return std::make_pair ( found.where, found.id );
+            }
+
+        template <typename Range>
+        std::pair<typename boost::range_iterator<Range>::type, std::size_t> operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f )
+        /// \brief Reports every occurrence of every pattern in the corpus, in one pass
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param f            Called as f ( pattern_id, match_start ) for each match,
+        ///                     in order of position (and of id, at the same position).
+        /// \return             f
+        ///
+        template <typename corpusIter, typename Func>
+        Func for_each_match ( corpusIter corpus_first, corpusIter corpus_last, Func f ) const {
+            every_match<Func> visitor ( f );
+            this->scan ( corpus_first, corpus_last, visitor );
+            return visitor.f;
+            }
+
+        template <typename Range, typename Func>
+        Func for_each_match ( Range &r, Func f ) const {
+            return this->for_each_match (boost::begin(r), boost::end(r), f);
+            }
+
+        /// The number of patterns the searcher was built from
+        std::size_t pattern_count () const { return k_count; }
+
+        /// The length of (each of) the patterns
+        difference_type pattern_length () const { return k_pattern_length; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        struct slot {
+            boost::uint64_t hash;
+            std::size_t id;         // npos for an empty slot
+            };
+
+        difference_type k_pattern_length;
+        std::size_t k_count;
+        std::vector<value_type> patterns_;  // all the patterns, one after another
+        std::vector<slot> slots_;           // a power of two of them, at most half full
+        unsigned shift_;                    // the high bits of a mixed hash pick its slot
+        boost::uint64_t high_power_;        // rk_base ^ (pattern length - 1)
+
+    //  The high bits of the hash of a short pattern hardly vary, so mix
+    //  them first (Fibonacci hashing, as in detail::flat_skip_table).
+        std::size_t home ( boost::uint64_t h ) const {
+            const boost::uint64_t k_golden = ( static_cast<boost::uint64_t> ( 0x9E3779B9U ) << 32 ) | 0x7F4A7C15U;
+            return static_cast<std::size_t> (( h * k_golden ) >> shift_ );
+            }
+
+        template <typename corpusIter>
+        struct first_match {
+            explicit first_match ( corpusIter last ) : where ( last ), id ( npos ) {}
+            bool operator () ( std::size_t i, corpusIter pos ) {
+                where = pos;
+                id = i;
+                return true;    // stop
+                }
+            corpusIter where;
+            std::size_t id;
+            };
+
+        template <typename Func>
+        struct every_match {
+            explicit every_match ( Func fn ) : f ( fn ) {}
+            template <typename corpusIter>
+            bool operator () ( std::size_t id, corpusIter pos ) {
+                f ( id, pos );
+                return false;
+                }
+            Func f;
+            };
+
+        void build_table () {
+            std::size_t size = 2;
+            shift_ = 63;
+            while ( size < 2 * k_count ) {
+                size *= 2;
+                --shift_;
+                }
+            const slot empty = { 0, npos };
+            slots_.assign ( size, empty );
+            high_power_ = detail::rk_power ( static_cast<std::size_t> ( k_pattern_length - 1 ));
+
+        //  Identical patterns get slots in the order of their ids, so they are found in that order
+            for ( std::size_t id = 0; id < k_count; ++id ) {
+                const value_type *pat = &patterns_ [ id * k_pattern_length ];
+                const boost::uint64_t h = rabin_karp_hash ( pat, pat + k_pattern_length );
+                std::size_t i = home ( h );
+                while ( slots_ [ i ].id != npos )
+                    i = ( i + 1 ) & ( size - 1 );
+                slots_ [ i ].hash = h;
+                slots_ [ i ].id = id;
+                }
+            }
+
+    //  Roll the hash across the corpus; at each position, look it up, and pass
+    //  the verified matches to the visitor, until it returns true.
+        template <typename corpusIter, typename Visitor>
+        void scan ( corpusIter corpus_first, corpusIter corpus_last, Visitor &visit ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+            if ( k_count == 0 || k_pattern_length == 0 ||
+                    std::distance ( corpus_first, corpus_last ) < k_pattern_length )
+                return;
+
+            const std::size_t mask = slots_.size () - 1;
+            boost::uint64_t h = rabin_karp_hash ( corpus_first, corpus_first + k_pattern_length );
+            const corpusIter lastPos = corpus_last - k_pattern_length;
+            for ( corpusIter curPos = corpus_first; ; ++curPos ) {
+                for ( std::size_t i = home ( h ); slots_ [ i ].id != npos; i = ( i + 1 ) & mask )
+                    if ( slots_ [ i ].hash == h ) {
+                        const std::size_t id = slots_ [ i ].id;
+                        const value_type *pat = &patterns_ [ id * k_pattern_length ];
+                        if ( std::equal ( pat, pat + k_pattern_length, curPos ) && visit ( id, curPos ))
+                            return;
+                        }
+                if ( curPos == lastPos )
+                    break;
+                h = ( h - detail::rk_symbol ( *curPos ) * high_power_ ) * detail::rk_base
+                        + detail::rk_symbol ( curPos [ k_pattern_length ] );
+                }
+            }
+/// \endcond
+        };
+
+    template <typename patIter>
+    const std::size_t rabin_karp<patIter>::npos;
+
+
+/// \fn rabin_karp_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       const PatternsRange &patterns )
+/// \brief Searches the corpus for the leftmost occurrence of any of the patterns.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param patterns     A range of patterns to search for, all the same length
+///
+    template <typename PatternsRange, typename corpusIter>
+    std::pair<corpusIter, std::size_t> rabin_karp_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternsRange &patterns )
+    {
+        typedef typename boost::range_value<const PatternsRange>::type pattern_type;
+        typedef typename boost::range_iterator<const pattern_type>::type pattern_iterator;
+        rabin_karp<pattern_iterator> rk ( boost::begin(patterns), boost::end (patterns));
+        return rk ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternsRange, typename CorpusRange>
+    std::pair<typename boost::range_iterator<CorpusRange>::type, std::size_t>
+    rabin_karp_search ( CorpusRange &corpus, const PatternsRange &patterns )
+    {
+        typedef typename boost::range_value<const PatternsRange>::type pattern_type;
+        typedef typename boost::range_iterator<const pattern_type>::type pattern_iterator;
+        rabin_karp<pattern_iterator> rk ( boost::begin(patterns), boost::end (patterns));
+        return rk (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator function -- take a range of patterns, return an object
+    template <typename PatternsRange>
+    boost::algorithm::rabin_karp<typename boost::range_iterator<
+        const typename boost::range_value<const PatternsRange>::type>::type>
+    make_rabin_karp ( const PatternsRange &patterns ) {
+        return boost::algorithm::rabin_karp<typename boost::range_iterator<
+            const typename boost::range_value<const PatternsRange>::type>::type>
+                (boost::begin(patterns), boost::end(patterns));
+        }
+
+
+/*
+    Content-defined chunking.
+
+    The hash of a small window is rolled across the data; a chunk ends
+    wherever that hash has its top bits clear (and the chunk is at least
+    min_size long), or when the chunk reaches max_size. Since the cut points
+    depend only on the nearby content, an insertion or deletion changes
+    only the chunks around it, and the rest of the chunks (and their
+    fingerprints) are the same as before; which is what deduplication needs.
+    The fingerprints are 61 bits wide, so equal fingerprints still mean
+    only that the chunks are very probably equal; a store that must not
+    lose data compares the contents too (or fingerprints with a
+    cryptographic hash instead).
+*/
+
+    struct rabin_karp_chunking {
+        /// \param window       The number of elements hashed to pick the cut points
+        /// \param average_size The average chunk size that is aimed for; a power of two
+        /// \param min_size     No chunk (except the last) is shorter than this
+        /// \param max_size     No chunk is longer than this
+        /// \param seed         Picks the base of the chunk fingerprints; keep it secret
+        ///                     if the data may be built to collide
+        explicit rabin_karp_chunking ( std::size_t window_ = 48, std::size_t average_size_ = 8192,
+                                       std::size_t min_size_ = 2048, std::size_t max_size_ = 65536,
+                                       boost::uint64_t seed_ = 0 )
+            : window ( window_ ), average_size ( average_size_ ), min_size ( min_size_ ), max_size ( max_size_ ),
+              seed ( seed_ ) {}
+
+        std::size_t window;
+        std::size_t average_size;
+        std::size_t min_size;
+        std::size_t max_size;
+        boost::uint64_t seed;
+        };
+
+/// \fn rabin_karp_chunks ( Iter first, Iter last, const rabin_karp_chunking &params, Func f )
+/// \brief Splits a sequence into content-defined chunks, and fingerprints each one.
+///
+/// \param first        The start of the data (Forward Iterator)
+/// \param last         One past the end of the data
+/// \param params       The window and the chunk sizes
+/// \param f            Called as f ( chunk_first, chunk_last, fingerprint ) for each chunk, in order;
+///                     the fingerprint is rabin_karp_fingerprint ( chunk_first, chunk_last, params.seed ).
+/// \return             f
+///
+    template <typename Iter, typename Func>
+    Func rabin_karp_chunks ( Iter first, Iter last, const rabin_karp_chunking &params, Func f ) {
+    //  Check that average_size is a power of two (and more than one) before
+    //  looking for its exponent, so the shift below never reaches the width.
+        if ( params.window == 0 || params.average_size < 2 || ( params.average_size & ( params.average_size - 1 )) != 0 ||
+                params.max_size == 0 || params.min_size > params.max_size )
+            boost::throw_exception ( std::invalid_argument ( "boost::algorithm::rabin_karp_chunks: bad chunking parameters" ));
+        unsigned bits = 0;
+        while (( std::size_t ( 1 ) << bits ) < params.average_size )
+            ++bits;
+
+        const boost::uint64_t out_power = detail::rk_power ( params.window - 1 );
+        const boost::uint64_t fp_base = detail::fp_base ( params.seed );
+        const unsigned shift = 64 - bits;
+        boost::uint64_t window_hash = 0, chunk_hash = 0;
+        std::size_t seen = 0, length = 0;
+        Iter chunk_first = first, window_first = first;
+        while ( first != last ) {
+            const boost::uint64_t c = detail::rk_symbol ( *first );
+            ++first;
+            ++length;
+            chunk_hash = detail::fp_step ( chunk_hash, fp_base, c );
+            if ( seen < params.window )
+                ++seen;
+            else {
+                window_hash -= detail::rk_symbol ( *window_first ) * out_power;
+                ++window_first;
+                }
+            window_hash = window_hash * detail::rk_base + c;
+
+            if ( length >= params.max_size ||
+                    ( length >= params.min_size && seen == params.window && ( window_hash >> shift ) == 0 )) {
+                f ( chunk_first, first, chunk_hash );
+                chunk_first = first;
+                chunk_hash = 0;
+                length = 0;
+                }
+            }
+        if ( length > 0 )
+            f ( chunk_first, first, chunk_hash );
+        return f;
+        }
+
+    template <typename Range, typename Func>
+    Func rabin_karp_chunks ( const Range &r, const rabin_karp_chunking &params, Func f ) {
+        return rabin_karp_chunks ( boost::begin ( r ), boost::end ( r ), params, f );
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_RABIN_KARP_SEARCH_HPP
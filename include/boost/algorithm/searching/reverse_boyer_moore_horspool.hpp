@@ -0,0 +1,172 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_REVERSE_BOYER_MOORE_HORSPOOL_SEARCH_HPP
+#define BOOST_ALGORITHM_REVERSE_BOYER_MOORE_HORSPOOL_SEARCH_HPP
+
+#include <iterator>     // for std::iterator_traits, std::reverse_iterator
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    A version of the boyer-moore-horspool searching algorithm that finds the last
+    occurrence of the pattern in the corpus, rather than the first.
+
+    The window moves from the end of the corpus towards the start, and the
+    shift is picked by the first element of the window; so the skip table is
+    built from the pattern prefix, and holds the distance of each element
+    from the start of the pattern. This is just boyer_moore_horspool, run
+    over reverse iterators, and it has the same (sublinear, on average) cost.
+
+Requirements:
+        * Random access iterators
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type and be comparable.
+        * Additional requirements may be imposed by the skip table, such as:
+        ** Numeric type (array-based skip table)
+        ** Hashable type (map-based skip table)
+*/
+
+    template <typename patIter, typename traits = detail::BM_traits<patIter> >
+    class reverse_boyer_moore_horspool {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef std::reverse_iterator<patIter> pattern_reverse_iterator;
+        typedef boyer_moore_horspool<pattern_reverse_iterator, traits> searcher_type;
+    public:
+        typedef typename searcher_type::allocator_type allocator_type;
+
+        reverse_boyer_moore_horspool ( patIter first, patIter last, const allocator_type &alloc = allocator_type ())
+                : k_pattern_length ( std::distance ( first, last )),
+                  searcher_ ( pattern_reverse_iterator ( last ), pattern_reverse_iterator ( first ), alloc ) {}
+
+        ~reverse_boyer_moore_horspool () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the last occurrence of the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \return             The start of the last match, or corpus_last if there is none.
+        ///                     An empty pattern matches at the end of the corpus.
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            typedef std::reverse_iterator<corpusIter> corpus_reverse_iterator;
+            const corpus_reverse_iterator r_last ( corpus_first );
+            const corpus_reverse_iterator found = searcher_ ( corpus_reverse_iterator ( corpus_last ), r_last );
+            return found == r_last ? corpus_last : found.base () - k_pattern_length;
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_previous ( corpusIter corpus_first, corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the match before a match that has already been found
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param match        The start of a match of the pattern
+        /// \param corpus_last  One past the end of the data to search; returned if there is no earlier match
+        /// \param mode         Whether the earlier match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_previous ( corpusIter corpus_first, corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            typedef std::reverse_iterator<corpusIter> corpus_reverse_iterator;
+            const corpus_reverse_iterator r_last ( corpus_first );
+            const corpus_reverse_iterator found =
+                searcher_.find_next ( corpus_reverse_iterator ( match + k_pattern_length ), r_last, mode );
+            return found == r_last ? corpus_last : found.base () - k_pattern_length;
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        const difference_type k_pattern_length;
+        searcher_type searcher_;
+/// \endcond
+        };
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn reverse_boyer_moore_horspool_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the last occurrence of the pattern.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter reverse_boyer_moore_horspool_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        reverse_boyer_moore_horspool<patIter> rbmh ( pat_first, pat_last );
+        return rbmh ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter reverse_boyer_moore_horspool_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        reverse_boyer_moore_horspool<pattern_iterator> rbmh ( boost::begin(pattern), boost::end (pattern));
+        return rbmh ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
+    ::type
+    reverse_boyer_moore_horspool_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        reverse_boyer_moore_horspool<patIter> rbmh ( pat_first, pat_last );
+        return rbmh (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    reverse_boyer_moore_horspool_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        reverse_boyer_moore_horspool<pattern_iterator> rbmh ( boost::begin(pattern), boost::end (pattern));
+        return rbmh (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::reverse_boyer_moore_horspool<typename boost::range_iterator<const Range>::type>
+    make_reverse_boyer_moore_horspool ( const Range &r ) {
+        return boost::algorithm::reverse_boyer_moore_horspool
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    template <typename Range>
+    boost::algorithm::reverse_boyer_moore_horspool<typename boost::range_iterator<Range>::type>
+    make_reverse_boyer_moore_horspool ( Range &r ) {
+        return boost::algorithm::reverse_boyer_moore_horspool
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_REVERSE_BOYER_MOORE_HORSPOOL_SEARCH_HPP
@@ -0,0 +1,240 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEARCHER_CACHE_HPP
+#define BOOST_ALGORITHM_SEARCHER_CACHE_HPP
+
+#include <list>
+#include <vector>
+#include <algorithm>    // for std::equal
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/config.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/functional/hash.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+
+#ifdef BOOST_NO_CXX11_HDR_UNORDERED_MAP
+#include <boost/tr1/tr1/unordered_map>
+#else
+#include <unordered_map>
+#endif
+
+#ifdef BOOST_NO_CXX11_HDR_MUTEX
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/lock_guard.hpp>
+#else
+#include <mutex>
+#endif
+
+/*
+    A bounded cache of searchers, keyed by the contents of the pattern.
+
+    Building a searcher (the tables for Boyer-Moore, for example) costs
+    time and memory in proportion to the pattern. When the same patterns
+    are searched for over and over, the cache keeps the most recently used
+    searchers, so that a repeated search skips the construction entirely.
+
+    Each entry owns a copy of its pattern, and the searcher refers to that
+    copy. Entries are handed out as shared pointers; an entry that is
+    evicted while it is being used lives until the last user is done.
+
+    The cache can be shared between threads; the lock is not held while a
+    searcher is built, or during the search. Without C++11 <mutex>, the
+    lock is a boost::mutex, so Boost.Thread must be linked.
+*/
+
+namespace boost { namespace algorithm {
+
+    template <typename Value,
+              typename Searcher = boyer_moore<typename std::vector<Value>::const_iterator> >
+    class searcher_cache : boost::noncopyable {
+    public:
+        typedef Value value_type;
+        typedef Searcher searcher_type;
+        typedef boost::shared_ptr<const Searcher> searcher_ptr;
+
+        /// \param capacity The most searchers to keep; zero means that nothing is cached
+        explicit searcher_cache ( std::size_t capacity )
+            : capacity_ ( capacity ), hits_ ( 0 ), misses_ ( 0 ) {}
+
+        ~searcher_cache () {}
+
+        /// \fn get ( patIter pat_first, patIter pat_last )
+        /// \brief Returns a searcher for the pattern, building it if it is not in the cache
+        ///
+        /// \param pat_first    The start of the pattern (Forward Iterator)
+        /// \param pat_last     One past the end of the pattern
+        ///
+        template <typename patIter>
+        searcher_ptr get ( patIter pat_first, patIter pat_last ) {
+            const std::size_t hash = boost::hash_range ( pat_first, pat_last );
+            {
+                lock_type lock ( mutex_ );
+                const entry_ptr found = this->find ( hash, pat_first, pat_last );
+                if ( found ) {
+                    ++hits_;
+                    return searcher_ptr ( found, &found->searcher );
+                    }
+                ++misses_;
+            }
+
+        //  Build the searcher without holding the lock
+            entry_ptr built ( new entry ( pat_first, pat_last, hash ));
+
+            lock_type lock ( mutex_ );
+        //  Another thread may have built the same searcher in the meantime
+            const entry_ptr found = this->find ( hash, pat_first, pat_last );
+            if ( found )
+                return searcher_ptr ( found, &found->searcher );
+            if ( capacity_ > 0 ) {
+                lru_.push_front ( built );
+                index_.insert ( typename index_map::value_type ( hash, lru_.begin ()));
+                if ( lru_.size () > capacity_ )
+                    this->evict_oldest ();
+                }
+            return searcher_ptr ( built, &built->searcher );
+            }
+
+        template <typename Range>
+        searcher_ptr get ( const Range &pattern ) {
+            return this->get ( boost::begin ( pattern ), boost::end ( pattern ));
+            }
+
+        /// The number of lookups that found a searcher in the cache
+        std::size_t hits () const {
+            lock_type lock ( mutex_ );
+            return hits_;
+            }
+
+        /// The number of lookups that had to build a searcher
+        std::size_t misses () const {
+            lock_type lock ( mutex_ );
+            return misses_;
+            }
+
+        /// The number of searchers in the cache
+        std::size_t size () const {
+            lock_type lock ( mutex_ );
+            return lru_.size ();
+            }
+
+        std::size_t capacity () const { return capacity_; }
+
+        /// Drop all the searchers (but not the counters)
+        void clear () {
+            lock_type lock ( mutex_ );
+            index_.clear ();
+            lru_.clear ();
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        struct entry : boost::noncopyable {
+            template <typename patIter>
+            entry ( patIter pat_first, patIter pat_last, std::size_t h )
+                : pattern ( pat_first, pat_last ), hash ( h ),
+                  searcher ( pattern.begin (), pattern.end ()) {}
+
+            const std::vector<Value> pattern;   // the searcher refers to this copy
+            const std::size_t hash;
+            const Searcher searcher;
+            };
+
+        typedef boost::shared_ptr<entry> entry_ptr;
+        typedef std::list<entry_ptr> lru_list;      // most recently used first
+#ifdef BOOST_NO_CXX11_HDR_UNORDERED_MAP
+        typedef std::tr1::unordered_multimap<std::size_t, typename lru_list::iterator> index_map;
+#else
+        typedef std::unordered_multimap<std::size_t, typename lru_list::iterator> index_map;
+#endif
+
+#ifdef BOOST_NO_CXX11_HDR_MUTEX
+        typedef boost::mutex mutex_type;
+        typedef boost::lock_guard<boost::mutex> lock_type;
+#else
+        typedef std::mutex mutex_type;
+        typedef std::lock_guard<std::mutex> lock_type;
+#endif
+
+        const std::size_t capacity_;
+        lru_list lru_;
+        index_map index_;       // hash of the pattern -> entry
+        std::size_t hits_;
+        std::size_t misses_;
+        mutable mutex_type mutex_;
+
+    //  Look for the pattern; if it is there, make it the most recently used.
+    //  Patterns are compared element by element, so there is no need to
+    //  build a key (and allocate) for a lookup.
+        template <typename patIter>
+        entry_ptr find ( std::size_t hash, patIter pat_first, patIter pat_last ) {
+            typedef typename index_map::iterator index_iter;
+            const std::pair<index_iter, index_iter> candidates = index_.equal_range ( hash );
+            for ( index_iter it = candidates.first; it != candidates.second; ++it ) {
+                const std::vector<Value> &pattern = (*it->second)->pattern;
+                if ( static_cast<std::size_t> ( std::distance ( pat_first, pat_last )) == pattern.size () &&
+                        std::equal ( pattern.begin (), pattern.end (), pat_first )) {
+                    lru_.splice ( lru_.begin (), lru_, it->second );
+                    return lru_.front ();
+                    }
+                }
+            return entry_ptr ();
+            }
+
+        void evict_oldest () {
+            const typename lru_list::iterator oldest = --lru_.end ();
+            typedef typename index_map::iterator index_iter;
+            const std::pair<index_iter, index_iter> candidates = index_.equal_range ( (*oldest)->hash );
+            for ( index_iter it = candidates.first; it != candidates.second; ++it )
+                if ( it->second == oldest ) {
+                    index_.erase ( it );
+                    break;
+                    }
+            lru_.erase ( oldest );
+            }
+/// \endcond
+        };
+
+
+/// \fn cached_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last, searcher_cache<Value, Searcher> &cache )
+/// \brief Searches the corpus for the pattern, with a searcher from the cache.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Forward Iterator)
+/// \param pat_last     One past the end of the data to search for
+/// \param cache        Where to look for (and keep) the searcher
+///
+    template <typename patIter, typename corpusIter, typename Value, typename Searcher>
+    corpusIter cached_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last, searcher_cache<Value, Searcher> &cache )
+    {
+        const typename searcher_cache<Value, Searcher>::searcher_ptr s = cache.get ( pat_first, pat_last );
+        return (*s) ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename CorpusRange, typename Value, typename Searcher>
+    typename boost::range_iterator<CorpusRange>::type
+    cached_search ( CorpusRange &corpus, const PatternRange &pattern, searcher_cache<Value, Searcher> &cache )
+    {
+        const typename searcher_cache<Value, Searcher>::searcher_ptr s = cache.get ( pattern );
+        return (*s) ( boost::begin ( corpus ), boost::end ( corpus ));
+    }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_SEARCHER_CACHE_HPP
@@ -0,0 +1,303 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SEGMENTED_SEARCH_HPP
+#define BOOST_ALGORITHM_SEGMENTED_SEARCH_HPP
+
+#include <vector>
+#include <utility>      // for std::pair
+#include <iterator>     // for std::iterator_traits, std::distance
+#include <algorithm>    // for std::min
+
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
+
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+namespace boost { namespace algorithm {
+
+/*
+    Searching a corpus that is stored in pieces (segments), such as a chain
+    of I/O buffers, without copying it into one buffer.
+
+    The corpus is a sequence of segments, each of which is a range with
+    random access iterators (a std::vector, a std::string, an iterator_range
+    of pointers, ...). Each segment is searched with an ordinary searcher,
+    on its own iterators; only the matches that span the end of a segment
+    are handled specially. For those, the searcher keeps the last (pattern
+    length - 1) elements before each segment, and searches them together
+    with the first (pattern length - 1) elements of the segment, the way
+    boyer_moore_horspool_session does with the chunks of a stream.
+
+Requirements:
+        * The segments are a range of ranges, with (at least) forward
+            iterators; the elements of the segments must have random access
+            iterators, and "point to" the same type as the pattern.
+        * The searcher (boyer_moore_horspool, by default) is constructed
+            from the pattern, and has operator () and find_next.
+        * Segments may be empty, or shorter than the pattern.
+*/
+
+/// \struct segmented_position
+/// \brief Where a match starts, in a segmented corpus.
+///
+    template <typename SegmentIter>
+    struct segmented_position {
+        typedef typename std::iterator_traits<SegmentIter>::value_type segment_type;
+        typedef typename boost::range_iterator<const segment_type>::type iterator;
+
+        segmented_position () : segment (), position (), offset ( 0 ) {}
+        segmented_position ( SegmentIter seg, iterator pos, boost::uintmax_t off )
+            : segment ( seg ), position ( pos ), offset ( off ) {}
+
+        SegmentIter segment;        ///< The segment that the match starts in (the end of the segments, if there is no match)
+        iterator position;          ///< The start of the match, in that segment
+        boost::uintmax_t offset;    ///< The number of elements before the match, in all the segments
+        };
+
+
+    template <typename patIter, typename Searcher = boyer_moore_horspool<patIter> >
+    class segmented_searcher {
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef typename std::vector<value_type>::const_iterator tail_iterator;
+    public:
+        segmented_searcher ( patIter first, patIter last )
+                : searcher_ ( first, last ), k_pattern_length ( std::distance ( first, last )) {}
+
+        ~segmented_searcher () {}
+
+        /// \fn operator ( SegmentIter seg_first, SegmentIter seg_last )
+        /// \brief Searches the segments for the pattern that was passed into the constructor
+        ///
+        /// \param seg_first The first segment to search
+        /// \param seg_last  One past the last segment to search
+        /// \return          Where the first match starts; if there is no match, the
+        ///                  segment is seg_last, and the offset is the total length.
+        ///
+        template <typename SegmentIter>
+        segmented_position<SegmentIter> operator () ( SegmentIter seg_first, SegmentIter seg_last ) const {
+            typedef segmented_position<SegmentIter> position;
+        //  An empty pattern matches at the start
+            if ( k_pattern_length == 0 && seg_first != seg_last )
+                return position ( seg_first, segment_begin ( seg_first ), 0 );
+
+            first_match<SegmentIter> visit;
+            const boost::uintmax_t total = this->scan ( seg_first, seg_last, search_overlapping, visit );
+            return visit.found ? visit.where : position ( seg_last, typename position::iterator (), total );
+            }
+
+        template <typename SegmentRange>
+        segmented_position<typename boost::range_iterator<const SegmentRange>::type>
+        operator () ( const SegmentRange &segments ) const {
+            return (*this) (boost::begin(segments), boost::end(segments));
+            }
+
+        /// \fn for_each_match ( SegmentIter seg_first, SegmentIter seg_last, Func f, search_overlap_mode mode )
+        /// \brief Reports every match of the pattern in the segments, in one pass
+        ///
+        /// \param seg_first The first segment to search
+        /// \param seg_last  One past the last segment to search
+        /// \param f         Called as f ( segmented_position ) for each match, in order
+        /// \param mode      Whether matches may overlap
+        /// \return          f
+        ///
+        template <typename SegmentIter, typename Func>
+        Func for_each_match ( SegmentIter seg_first, SegmentIter seg_last, Func f,
+                              search_overlap_mode mode = search_overlapping ) const {
+            every_match<Func> visit ( f );
+            this->scan ( seg_first, seg_last, mode, visit );
+            return visit.f;
+            }
+
+        template <typename SegmentRange, typename Func>
+        Func for_each_match ( const SegmentRange &segments, Func f, search_overlap_mode mode = search_overlapping ) const {
+            return this->for_each_match (boost::begin(segments), boost::end(segments), f, mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        Searcher searcher_;
+        const difference_type k_pattern_length;
+
+        template <typename SegmentIter>
+        struct first_match {
+            first_match () : found ( false ) {}
+            bool operator () ( const segmented_position<SegmentIter> &pos ) {
+                where = pos;
+                found = true;
+                return true;    // stop
+                }
+            segmented_position<SegmentIter> where;
+            bool found;
+            };
+
+        template <typename Func>
+        struct every_match {
+            explicit every_match ( Func fn ) : f ( fn ) {}
+            template <typename Position>
+            bool operator () ( const Position &pos ) {
+                f ( pos );
+                return false;
+                }
+            Func f;
+            };
+
+    //  *seg may be a temporary (an iterator_range, say); the iterators outlive it
+        template <typename SegmentIter>
+        static typename segmented_position<SegmentIter>::iterator segment_begin ( SegmentIter seg ) {
+            const typename segmented_position<SegmentIter>::segment_type &s = *seg;
+            return boost::begin ( s );
+            }
+
+        template <typename SegmentIter>
+        static typename segmented_position<SegmentIter>::iterator segment_end ( SegmentIter seg ) {
+            const typename segmented_position<SegmentIter>::segment_type &s = *seg;
+            return boost::end ( s );
+            }
+
+    //  Search each segment in turn, and pass the matches to the visitor until it
+    //  returns true. Returns the number of elements in the segments that were searched.
+        template <typename SegmentIter, typename Visitor>
+        boost::uintmax_t scan ( SegmentIter seg_first, SegmentIter seg_last, search_overlap_mode mode, Visitor &visit ) const {
+            typedef segmented_position<SegmentIter> position;
+            typedef typename position::iterator iterator;
+            typedef std::pair<SegmentIter, difference_type> where_type;
+            BOOST_STATIC_ASSERT (( boost::is_same<value_type,
+                typename std::iterator_traits<iterator>::value_type>::value ));
+
+            const difference_type k_keep = k_pattern_length > 0 ? k_pattern_length - 1 : 0;
+            const difference_type shift  = mode == search_overlapping ? 1 : k_pattern_length;
+            std::vector<value_type> tail;       // the last (pattern length - 1) elements before this segment
+            std::vector<where_type> tail_where; // and where each of them is
+            boost::uintmax_t offset = 0;        // the number of elements before this segment
+            boost::uintmax_t next_start = 0;    // where the next match may start
+            if ( k_keep > 0 ) {
+                tail.reserve ( 2 * k_keep );
+                tail_where.reserve ( k_keep );
+                }
+
+            for ( SegmentIter seg = seg_first; seg != seg_last; ++seg ) {
+                const iterator first = segment_begin ( seg ), last = segment_end ( seg );
+                const difference_type len = std::distance ( first, last );
+                if ( k_pattern_length == 0 || len == 0 ) {
+                    offset += len;
+                    continue;
+                    }
+
+            //  Matches that start in the tail; they can only end in the first
+            //  (pattern length - 1) elements of this segment. The tail is
+            //  searched for overlapping matches, since some of them may have
+            //  to be skipped (if they overlap a match that was reported).
+                const difference_type k_tail = tail.size ();
+                if ( k_tail > 0 ) {
+                    tail.insert ( tail.end (), first, first + (std::min) ( len, k_keep ));
+                    const tail_iterator t_first = tail.begin (), t_last = tail.end ();
+                    for ( tail_iterator cur = searcher_ ( t_first, t_last ); cur != t_last && cur - t_first < k_tail;
+                                cur = searcher_.find_next ( cur, t_last, search_overlapping )) {
+                        const boost::uintmax_t at = offset - k_tail + ( cur - t_first );
+                        if ( at < next_start )
+                            continue;
+                        const where_type &w = tail_where [ cur - t_first ];
+                        if ( visit ( position ( w.first, segment_begin ( w.first ) + w.second, at )))
+                            return offset;
+                        next_start = at + shift;
+                        }
+                    tail.resize ( k_tail );
+                    }
+
+            //  Matches inside this segment
+                iterator start = first;
+                if ( next_start > offset )
+                    start = next_start - offset < static_cast<boost::uintmax_t> ( len ) ?
+                                first + static_cast<difference_type> ( next_start - offset ) : last;
+                for ( iterator cur = searcher_ ( start, last ); cur != last; cur = searcher_.find_next ( cur, last, mode )) {
+                    const boost::uintmax_t at = offset + ( cur - first );
+                    if ( visit ( position ( seg, cur, at )))
+                        return offset;
+                    next_start = at + shift;
+                    }
+
+            //  Keep the last (pattern length - 1) elements for the next segment
+                if ( len >= k_keep ) {
+                    tail.assign ( last - k_keep, last );
+                    tail_where.clear ();
+                    for ( difference_type i = len - k_keep; i < len; ++i )
+                        tail_where.push_back ( where_type ( seg, i ));
+                    }
+                else {
+                    tail.insert ( tail.end (), first, last );
+                    for ( difference_type i = 0; i < len; ++i )
+                        tail_where.push_back ( where_type ( seg, i ));
+                    if ( tail.size () > static_cast<std::size_t> ( k_keep )) {
+                        const std::size_t excess = tail.size () - k_keep;
+                        tail.erase ( tail.begin (), tail.begin () + excess );
+                        tail_where.erase ( tail_where.begin (), tail_where.begin () + excess );
+                        }
+                    }
+
+                offset += len;
+                }
+            return offset;
+            }
+/// \endcond
+        };
+
+
+/// \fn segmented_search ( SegmentIter seg_first, SegmentIter seg_last, const PatternRange &pattern )
+/// \brief Searches the segments for the pattern, with boyer_moore_horspool.
+///
+/// \param seg_first The first segment to search
+/// \param seg_last  One past the last segment to search
+/// \param pattern   The pattern to search for
+///
+    template <typename PatternRange, typename SegmentIter>
+    segmented_position<SegmentIter> segmented_search (
+        SegmentIter seg_first, SegmentIter seg_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        segmented_searcher<pattern_iterator> ss ( boost::begin(pattern), boost::end (pattern));
+        return ss ( seg_first, seg_last );
+    }
+
+    template <typename PatternRange, typename SegmentRange>
+    segmented_position<typename boost::range_iterator<const SegmentRange>::type>
+    segmented_search ( const SegmentRange &segments, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        segmented_searcher<pattern_iterator> ss ( boost::begin(pattern), boost::end (pattern));
+        return ss (boost::begin (segments), boost::end (segments));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::segmented_searcher<typename boost::range_iterator<const Range>::type>
+    make_segmented_searcher ( const Range &r ) {
+        return boost::algorithm::segmented_searcher
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    template <typename Range>
+    boost::algorithm::segmented_searcher<typename boost::range_iterator<Range>::type>
+    make_segmented_searcher ( Range &r ) {
+        return boost::algorithm::segmented_searcher
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_SEGMENTED_SEARCH_HPP
@@ -0,0 +1,347 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SHIFT_OR_SEARCH_HPP
+#define BOOST_ALGORITHM_SHIFT_OR_SEARCH_HPP
+
+#include <algorithm>    // for std::min
+#include <iterator>     // for std::iterator_traits
+#include <stdexcept>    // for std::length_error
+
+#include <boost/array.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/detail/bm_traits.hpp>
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+namespace boost { namespace algorithm {
+
+namespace detail {
+/// \cond DOXYGEN_HIDE
+
+//  The character masks of the Shift-Or automaton. Bit i of the mask for 'c'
+//  is clear if the pattern has 'c' at position i; characters that are not
+//  in the pattern have every bit set.
+    template<typename key_type, bool /*useArray*/> class shift_or_masks;
+
+//  General case; use a map, with all ones as the default
+    template<typename key_type>
+    class shift_or_masks<key_type, false> {
+    public:
+        explicit shift_or_masks ( std::size_t patSize ) : masks_ ( patSize, ~boost::uint64_t ( 0 )) {}
+
+        void clear_bit ( key_type key, std::size_t bit ) {
+            masks_.insert ( key, masks_ [ key ] & ~( boost::uint64_t ( 1 ) << bit ));
+            }
+
+        boost::uint64_t operator [] ( key_type key ) const { return masks_ [ key ]; }
+
+    private:
+        skip_table<key_type, boost::uint64_t, false> masks_;
+        };
+
+//  One-byte values; use an array
+    template<typename key_type>
+    class shift_or_masks<key_type, true> {
+    public:
+        explicit shift_or_masks ( std::size_t /*patSize*/ ) { masks_.assign ( ~boost::uint64_t ( 0 )); }
+
+        void clear_bit ( key_type key, std::size_t bit ) {
+            masks_ [ static_cast<unsigned char> ( key ) ] &= ~( boost::uint64_t ( 1 ) << bit );
+            }
+
+        boost::uint64_t operator [] ( key_type key ) const {
+            return masks_ [ static_cast<unsigned char> ( key ) ];
+            }
+
+    private:
+        boost::array<boost::uint64_t, 256> masks_;
+        };
+
+/// \endcond
+}
+
+/*
+    A templated version of the Shift-Or (bit-parallel) searching algorithm.
+
+    The state of a nondeterministic automaton for the pattern is kept in
+    the bits of a machine word; each corpus element costs a table lookup,
+    a shift and an or, with no branches besides the test for a match.
+    Patterns are limited to 64 elements, the width of the state word.
+
+    With a non-zero mismatch count 'k', the searcher finds the first
+    position where the pattern matches with at most 'k' elements different
+    (the Hamming distance); it keeps one state word for each number of
+    mismatches from 0 to k.
+
+References:
+    http://www-igm.univ-mlv.fr/~lecroq/string/node6.html
+    R. Baeza-Yates and G. Gonnet, "A New Approach to Text Searching",
+    Communications of the ACM 35(10), 1992.
+
+Requirements:
+        * Random access iterators for the pattern; forward iterators for the corpus
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type and be comparable.
+        * Additional requirements may be imposed by the mask table, such as hashability.
+*/
+
+    template <typename patIter>
+    class shift_or {
+        typedef typename std::iterator_traits<patIter>::value_type value_type;
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+        typedef detail::shift_or_masks<value_type,
+                    boost::is_integral<value_type>::value && sizeof ( value_type ) == 1> mask_table;
+    public:
+    //  The longest pattern that fits in the state word
+        static const std::size_t max_pattern_length = 64;
+
+        shift_or ( patIter first, patIter last, std::size_t max_mismatches = 0 )
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  k_mismatches ( (std::min) ( max_mismatches, static_cast<std::size_t> ( k_pattern_length ))),
+                  masks_ ( k_pattern_length ), k_match_bit ( 0 ) {
+            if ( static_cast<std::size_t> ( k_pattern_length ) > max_pattern_length )
+                boost::throw_exception ( std::length_error ( "boost::algorithm::shift_or: pattern longer than 64 elements" ));
+            for ( difference_type i = 0; i < k_pattern_length; ++i )
+                masks_.clear_bit ( pat_first [ i ], i );
+            if ( k_pattern_length > 0 )
+                k_match_bit = boost::uint64_t ( 1 ) << ( k_pattern_length - 1 );
+            }
+
+        ~shift_or () {}
+
+    //  The number of mismatches that a match may have
+        std::size_t max_mismatches () const { return k_mismatches; }
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Forward Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if (    pat_first ==    pat_last ) return corpus_first; // empty pattern matches at start
+
+        //  Do the search
+            return k_mismatches == 0 ? this->do_search ( corpus_first, corpus_last )
+                                     : this->do_search_mismatches ( corpus_first, corpus_last );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Forward Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( pat_first == pat_last )
+                return corpus_last;
+        //  An approximate match says nothing about the period of the pattern,
+        //  so start over at the next position.
+            std::advance ( match, mode == search_overlapping ? 1 : k_pattern_length );
+            return (*this) ( match, corpus_last );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        /// \param corpus_first The start of the data to search (Forward Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<shift_or, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<shift_or, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<shift_or, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+        const std::size_t k_mismatches;
+        mask_table masks_;
+        boost::uint64_t k_match_bit;    // set in the state when the whole pattern has matched
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for an exact match of the pattern
+        ///
+        /// \param corpus_first The start of the data to search (Forward Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last ) const {
+        //  A clear bit i in the state means that the pattern's first i+1
+        //  elements match the corpus, ending here. The shift brings in a
+        //  clear bit for the empty prefix; the all-ones start makes sure
+        //  that nothing matches before the corpus starts.
+            boost::uint64_t state = ~boost::uint64_t ( 0 );
+            corpusIter start = corpus_first;    // where a match ending here would start
+            difference_type seen = 0;
+            for ( corpusIter curPos = corpus_first; curPos != corpus_last; ++curPos ) {
+                state = ( state << 1 ) | masks_ [ *curPos ];
+                if ( seen < k_pattern_length )
+                    ++seen;
+                else
+                    ++start;
+                if (( state & k_match_bit ) == 0 )
+                    return start;
+                }
+            return corpus_last;     // We didn't find anything
+            }
+
+        /// \fn do_search_mismatches ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for a match of the pattern with at most k_mismatches differences
+        ///
+        /// \param corpus_first The start of the data to search (Forward Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter do_search_mismatches ( corpusIter corpus_first, corpusIter corpus_last ) const {
+        //  state [ j ] is the Shift-Or state for prefixes matching with at most j
+        //  mismatches. A prefix that matches with j mismatches here either extends
+        //  one that matched with j (if this element matches), or one that matched
+        //  with j - 1 (whether or not it does).
+            boost::uint64_t state [ max_pattern_length + 1 ];
+            for ( std::size_t j = 0; j <= k_mismatches; ++j )
+                state [ j ] = ~boost::uint64_t ( 0 );
+
+            corpusIter start = corpus_first;
+            difference_type seen = 0;
+            for ( corpusIter curPos = corpus_first; curPos != corpus_last; ++curPos ) {
+                const boost::uint64_t mask = masks_ [ *curPos ];
+                boost::uint64_t prev = state [ 0 ];
+                state [ 0 ] = ( prev << 1 ) | mask;
+                for ( std::size_t j = 1; j <= k_mismatches; ++j ) {
+                    const boost::uint64_t cur = state [ j ];
+                    state [ j ] = (( cur << 1 ) | mask ) & ( prev << 1 );
+                    prev = cur;
+                    }
+
+            //  Until a whole pattern length has been seen, a "match" would
+            //  count elements before the start of the corpus as mismatches.
+                if ( seen < k_pattern_length ) {
+                    if ( ++seen < k_pattern_length )
+                        continue;
+                    }
+                else
+                    ++start;
+                if (( state [ k_mismatches ] & k_match_bit ) == 0 )
+                    return start;
+                }
+            return corpus_last;     // We didn't find anything
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn shift_or_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for an exact match of the pattern.
+///
+/// \param corpus_first The start of the data to search (Forward Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter shift_or_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        shift_or<patIter> so ( pat_first, pat_last );
+        return so ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter shift_or_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        shift_or<pattern_iterator> so ( boost::begin(pattern), boost::end (pattern));
+        return so ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
+    ::type
+    shift_or_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        shift_or<patIter> so ( pat_first, pat_last );
+        return so (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    shift_or_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        shift_or<pattern_iterator> so ( boost::begin(pattern), boost::end (pattern));
+        return so (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::shift_or<typename boost::range_iterator<const Range>::type>
+    make_shift_or ( const Range &r, std::size_t max_mismatches = 0 ) {
+        return boost::algorithm::shift_or
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r), max_mismatches);
+        }
+
+    template <typename Range>
+    boost::algorithm::shift_or<typename boost::range_iterator<Range>::type>
+    make_shift_or ( Range &r, std::size_t max_mismatches = 0 ) {
+        return boost::algorithm::shift_or
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r), max_mismatches);
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_SHIFT_OR_SEARCH_HPP
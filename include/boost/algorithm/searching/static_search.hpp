@@ -0,0 +1,371 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_STATIC_SEARCH_HPP
+#define BOOST_ALGORITHM_STATIC_SEARCH_HPP
+
+#include <boost/config.hpp>
+
+/*! \file
+    Defines versions of the Boyer-Moore and Boyer-Moore-Horspool searchers
+    whose tables can be built at compile time from a string literal.
+    These need C++14 (relaxed) constexpr; without it, the header is empty.
+*/
+
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/cstdint.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/type_traits/remove_cv.hpp>
+
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+namespace boost { namespace algorithm {
+
+namespace detail {
+/// \cond DOXYGEN_HIDE
+
+//  The narrowest signed type that holds -1 .. Length
+    template <std::size_t Length>
+    struct static_offset {
+        typedef typename boost::mpl::if_c<( Length <= 0x7F ), boost::int8_t,
+                typename boost::mpl::if_c<( Length <= 0x7FFF ), boost::int16_t,
+                    boost::int32_t>::type>::type type;
+        };
+
+//  A fixed-size array that can be filled in by a constexpr constructor
+    template <typename T, std::size_t N>
+    struct static_table {
+        T elems [ N == 0 ? 1 : N ];
+
+        constexpr T       &operator [] ( std::size_t i )       { return elems [ i ]; }
+        constexpr const T &operator [] ( std::size_t i ) const { return elems [ i ]; }
+        };
+
+//  The Boyer-Moore prefix function of [ first, first + count )
+    template <typename charT, std::size_t N>
+    constexpr void static_bm_prefix ( const charT *first, std::size_t count, static_table<std::size_t, N> &prefix ) {
+        prefix [ 0 ] = 0;
+        std::size_t k = 0;
+        for ( std::size_t i = 1; i < count; ++i ) {
+            while ( k > 0 && first [ k ] != first [ i ] )
+                k = prefix [ k - 1 ];
+            if ( first [ k ] == first [ i ] )
+                k++;
+            prefix [ i ] = k;
+            }
+        }
+
+/// \endcond
+}
+
+/*
+    A Boyer-Moore-Horspool searcher whose pattern is a string literal.
+
+    The constructor is constexpr, so a searcher declared constexpr (or
+    static const, initialized with a constant) has its pattern and skip
+    table built by the compiler, and placed in read-only data. There is no
+    heap allocation, and nothing to do at run time before the first search.
+    The entries of the skip table are as narrow as the pattern length allows.
+
+    Requirements:
+        * The pattern is an array of one-byte integral type (a string
+            literal); its terminating null is not part of the pattern.
+        * Random access iterators for the corpus, which must "point to"
+            the same type as the pattern.
+*/
+
+    template <typename charT, std::size_t N>
+    class static_boyer_moore_horspool {
+        BOOST_STATIC_ASSERT (( boost::is_integral<charT>::value && sizeof ( charT ) == 1 ));
+        BOOST_STATIC_ASSERT (( N > 0 ));
+        typedef typename detail::static_offset<N>::type offset_type;
+        static constexpr std::ptrdiff_t k_pattern_length = N - 1;
+    public:
+        constexpr explicit static_boyer_moore_horspool ( const charT ( &pattern ) [ N ] )
+                : pat_ (), skip_ () {
+            for ( std::ptrdiff_t i = 0; i < k_pattern_length; ++i )
+                pat_ [ i ] = pattern [ i ];
+            for ( std::size_t i = 0; i < 256; ++i )
+                skip_ [ i ] = static_cast<offset_type> ( k_pattern_length );
+            for ( std::ptrdiff_t i = 0; i < k_pattern_length - 1; ++i )
+                skip_ [ static_cast<unsigned char> ( pattern [ i ] ) ] = static_cast<offset_type> ( k_pattern_length - 1 - i );
+            }
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        constexpr corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<charT,
+                typename boost::remove_cv<typename std::iterator_traits<corpusIter>::value_type>::type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if ( k_pattern_length == 0 )       return corpus_first; // empty pattern matches at start
+
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( corpus_last - corpus_first < k_pattern_length )
+                return corpus_last;
+
+            return this->do_search ( corpus_first, corpus_last );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        constexpr corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( k_pattern_length == 0 )
+                return corpus_last;
+            const std::ptrdiff_t shift = mode == search_overlapping ?
+                    skip_ [ static_cast<unsigned char> ( pat_ [ k_pattern_length - 1 ] ) ] : k_pattern_length;
+            if (( corpus_last - match ) - shift < k_pattern_length )
+                return corpus_last;
+            return this->do_search ( match + shift, corpus_last );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<static_boyer_moore_horspool, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<static_boyer_moore_horspool, corpusIter> iterator;
+            const corpusIter first_match = k_pattern_length == 0 ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<static_boyer_moore_horspool, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        detail::static_table<charT, N - 1> pat_;
+        detail::static_table<offset_type, 256> skip_;
+
+        template <typename corpusIter>
+        constexpr corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            corpusIter curPos = corpus_first;
+            const corpusIter lastPos = corpus_last - k_pattern_length;
+            while ( curPos <= lastPos ) {
+            //  Do we match right where we are?
+                std::ptrdiff_t j = k_pattern_length - 1;
+                while ( pat_ [ j ] == curPos [ j ] ) {
+                //  We matched - we're done!
+                    if ( j == 0 )
+                        return curPos;
+                    j--;
+                    }
+
+                curPos += skip_ [ static_cast<unsigned char> ( curPos [ k_pattern_length - 1 ] ) ];
+                }
+
+            return corpus_last;
+            }
+/// \endcond
+        };
+
+
+/*
+    A Boyer-Moore searcher whose pattern is a string literal; the skip
+    and suffix tables are both built at compile time. Same requirements
+    as static_boyer_moore_horspool.
+*/
+
+    template <typename charT, std::size_t N>
+    class static_boyer_moore {
+        BOOST_STATIC_ASSERT (( boost::is_integral<charT>::value && sizeof ( charT ) == 1 ));
+        BOOST_STATIC_ASSERT (( N > 0 ));
+        typedef typename detail::static_offset<N>::type offset_type;
+        static constexpr std::ptrdiff_t k_pattern_length = N - 1;
+    public:
+        constexpr explicit static_boyer_moore ( const charT ( &pattern ) [ N ] )
+                : pat_ (), skip_ (), suffix_ () {
+            for ( std::ptrdiff_t i = 0; i < k_pattern_length; ++i )
+                pat_ [ i ] = pattern [ i ];
+            for ( std::size_t i = 0; i < 256; ++i )
+                skip_ [ i ] = -1;
+            for ( std::ptrdiff_t i = 0; i < k_pattern_length; ++i )
+                skip_ [ static_cast<unsigned char> ( pattern [ i ] ) ] = static_cast<offset_type> ( i );
+            build_suffix_table ( pattern );
+            }
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        constexpr corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<charT,
+                typename boost::remove_cv<typename std::iterator_traits<corpusIter>::value_type>::type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if ( k_pattern_length == 0 )       return corpus_first; // empty pattern matches at start
+
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( corpus_last - corpus_first < k_pattern_length )
+                return corpus_last;
+
+            return this->do_search ( corpus_first, corpus_last, 0 );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        constexpr corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+        //  After a full match, suffix_ [ 0 ] is the period of the pattern
+            const std::ptrdiff_t shift = mode == search_overlapping ? suffix_ [ 0 ] : k_pattern_length;
+            if ( k_pattern_length == 0 || ( corpus_last - match ) - shift < k_pattern_length )
+                return corpus_last;
+        //  Galil's rule, as in boyer_moore::find_next
+            return this->do_search ( match + shift, corpus_last,
+                                     mode == search_overlapping ? k_pattern_length - shift : 0 );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<static_boyer_moore, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<static_boyer_moore, corpusIter> iterator;
+            const corpusIter first_match = k_pattern_length == 0 ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<static_boyer_moore, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        detail::static_table<charT, N - 1> pat_;
+        detail::static_table<offset_type, 256> skip_;
+        detail::static_table<offset_type, N> suffix_;
+
+        template <typename corpusIter>
+        constexpr corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, std::ptrdiff_t memory ) const {
+            corpusIter curPos = corpus_first;
+            const corpusIter lastPos = corpus_last - k_pattern_length;
+            std::ptrdiff_t j = 0, k = 0, m = 0;
+
+            while ( curPos <= lastPos ) {
+            //  Do we match right where we are?
+                j = k_pattern_length;
+                while ( pat_ [ j - 1 ] == curPos [ j - 1 ] ) {
+                    j--;
+                //  We matched - we're done!
+                    if ( j == memory )
+                        return curPos;
+                    }
+
+            //  Since we didn't match, figure out how far to skip forward
+                k = skip_ [ static_cast<unsigned char> ( curPos [ j - 1 ] ) ];
+                m = j - k - 1;
+                if ( k < j && m > suffix_ [ j ] )
+                    curPos += m;
+                else
+                    curPos += suffix_ [ j ];
+                memory = 0;
+                }
+
+            return corpus_last;     // We didn't find anything
+            }
+
+    //  The same construction as boyer_moore::build_suffix_table
+        constexpr void build_suffix_table ( const charT ( &pattern ) [ N ] ) {
+            const std::size_t count = N - 1;
+            if ( count > 0 ) {  // empty pattern
+                detail::static_table<charT, N - 1> reversed {};
+                for ( std::size_t i = 0; i < count; ++i )
+                    reversed [ i ] = pattern [ count - 1 - i ];
+
+                detail::static_table<std::size_t, N - 1> prefix {};
+                detail::static_bm_prefix ( pattern, count, prefix );
+
+                detail::static_table<std::size_t, N - 1> prefix_reversed {};
+                detail::static_bm_prefix ( reversed.elems, count, prefix_reversed );
+
+                for ( std::size_t i = 0; i <= count; i++ )
+                    suffix_ [ i ] = static_cast<offset_type> ( count - prefix [ count - 1 ] );
+
+                for ( std::size_t i = 0; i < count; i++ ) {
+                    const std::size_t    j = count - prefix_reversed [ i ];
+                    const std::ptrdiff_t k = i - prefix_reversed [ i ] + 1;
+
+                    if ( suffix_ [ j ] > k )
+                        suffix_ [ j ] = static_cast<offset_type> ( k );
+                    }
+                }
+            }
+/// \endcond
+        };
+
+
+    //  Creator functions -- take a string literal, return an object
+    template <typename charT, std::size_t N>
+    constexpr static_boyer_moore_horspool<charT, N>
+    make_static_boyer_moore_horspool ( const charT ( &pattern ) [ N ] ) {
+        return static_boyer_moore_horspool<charT, N> ( pattern );
+        }
+
+    template <typename charT, std::size_t N>
+    constexpr static_boyer_moore<charT, N>
+    make_static_boyer_moore ( const charT ( &pattern ) [ N ] ) {
+        return static_boyer_moore<charT, N> ( pattern );
+        }
+
+}}
+
+#endif  //  BOOST_NO_CXX14_CONSTEXPR
+
+#endif  //  BOOST_ALGORITHM_STATIC_SEARCH_HPP
@@ -0,0 +1,391 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_SUFFIX_ARRAY_INDEX_HPP
+#define BOOST_ALGORITHM_SUFFIX_ARRAY_INDEX_HPP
+
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstring>      // for std::memcmp, std::memcpy
+#include <stdexcept>    // for std::invalid_argument, std::length_error, std::runtime_error
+#include <algorithm>    // for std::min, std::min_element, std::sort
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/throw_exception.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <boost/type_traits/alignment_of.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/type_traits/is_unsigned.hpp>
+
+#include <boost/algorithm/searching/detail/suffix_array.hpp>
+
+/*
+    An index of a fixed corpus, for answering many different queries.
+
+    The searchers build tables from the pattern, and then scan the corpus;
+    each query costs time proportional to the corpus. When the corpus does
+    not change, and the patterns do, it is better to build a table from
+    the corpus once: the suffix array, which lists the starting position of
+    every suffix of the corpus in sorted order. All the matches of a pattern
+    are then a contiguous run of the suffix array, found by binary search.
+
+    The suffix array is built in linear time with SA-IS. Optionally, the
+    LCP array (the length of the common prefix of each suffix and the one
+    before it in the suffix array) is built too, in linear time.
+
+    The index can be saved to a stream, and used later either by reading
+    it back, or in place, from a memory-mapped image of the saved file.
+
+    Requirements:
+        * Random access iterators
+        * The corpus and the patterns must be of a one-byte integral type
+        * Index is an unsigned integral type, large enough for the
+            length of the corpus
+*/
+
+namespace boost { namespace algorithm {
+
+/// \cond DOXYGEN_HIDE
+namespace detail {
+//  The layout of a saved index; it is followed by the suffix array, then
+//  the LCP array (if there is one). Everything is in the native byte order.
+    struct suffix_array_header {
+        char magic [ 8 ];
+        boost::uint64_t byte_order;     // detects images from other machines
+        boost::uint32_t index_size;
+        boost::uint32_t flags;
+        boost::uint64_t length;         // of the corpus
+        };
+
+    const char suffix_array_magic [ 8 ] = { 'B', 'A', 'S', 'A', 'I', 'D', 'X', '1' };
+    const boost::uint64_t suffix_array_byte_order = 0x0102030405060708ULL;
+    const boost::uint32_t suffix_array_has_lcp = 1;
+    }
+/// \endcond
+
+    template <typename corpusIter, typename Index = boost::uint32_t>
+    class suffix_array_index : boost::noncopyable {
+        typedef typename std::iterator_traits<corpusIter>::value_type value_type;
+        BOOST_STATIC_ASSERT (( boost::is_integral<value_type>::value && sizeof ( value_type ) == 1 ));
+    //  The builder's buckets run over all 256 byte values, which need a wider Index
+        BOOST_STATIC_ASSERT (( boost::is_unsigned<Index>::value && sizeof ( Index ) >= 2 ));
+    public:
+        typedef Index index_type;
+        typedef boost::iterator_range<const Index *> position_range;
+
+        /// \param first     The start of the corpus (Random Access Iterator)
+        /// \param last      One past the end of the corpus
+        /// \param build_lcp Whether to build the LCP array too
+        ///
+        /// The corpus must outlive the index, and must not change.
+        suffix_array_index ( corpusIter first, corpusIter last, bool build_lcp = false )
+                : first_ ( first ), last_ ( last ), n_ ( checked_length ( first, last )),
+                  sa_ ( NULL ), lcp_ ( NULL ) {
+            if ( n_ == 0 ) return;
+            sa_storage_.resize ( n_ );
+            const detail::byte_symbols<Index, corpusIter> symbols ( first_ );
+            detail::sais_builder<Index, detail::byte_symbols<Index, corpusIter> >
+                ( symbols, n_, 255, &sa_storage_ [ 0 ] ).build ();
+            sa_ = &sa_storage_ [ 0 ];
+            if ( build_lcp ) {
+                lcp_storage_.resize ( n_ );
+                detail::build_lcp ( first_, n_, sa_, &lcp_storage_ [ 0 ] );
+                lcp_ = &lcp_storage_ [ 0 ];
+                }
+            }
+
+        /// Reads an index that was written by save ()
+        ///
+        /// \param first     The start of the corpus that was indexed
+        /// \param last      One past the end of the corpus
+        /// \param in        Where to read the index from
+        ///
+        suffix_array_index ( corpusIter first, corpusIter last, std::istream &in )
+                : first_ ( first ), last_ ( last ), n_ ( checked_length ( first, last )),
+                  sa_ ( NULL ), lcp_ ( NULL ) {
+            detail::suffix_array_header header;
+            if ( !in.read ( reinterpret_cast<char *> ( &header ), sizeof ( header )))
+                boost::throw_exception ( std::runtime_error ( "boost::algorithm::suffix_array_index: cannot read the index" ));
+            check_header ( header );
+            if ( n_ == 0 ) return;
+
+            sa_storage_.resize ( n_ );
+            read_table ( in, sa_storage_ );
+            sa_ = &sa_storage_ [ 0 ];
+            if ( header.flags & detail::suffix_array_has_lcp ) {
+                lcp_storage_.resize ( n_ );
+                read_table ( in, lcp_storage_ );
+                lcp_ = &lcp_storage_ [ 0 ];
+                }
+            }
+
+        /// Uses an index that was written by save () in place, without copying it;
+        /// typically, a memory-mapped file.
+        ///
+        /// \param first      The start of the corpus that was indexed
+        /// \param last       One past the end of the corpus
+        /// \param image      The saved index; it must outlive this object
+        /// \param image_size The size of the image, in bytes
+        ///
+        suffix_array_index ( corpusIter first, corpusIter last, const void *image, std::size_t image_size )
+                : first_ ( first ), last_ ( last ), n_ ( checked_length ( first, last )),
+                  sa_ ( NULL ), lcp_ ( NULL ) {
+            const char *bytes = static_cast<const char *> ( image );
+            if ( image_size < sizeof ( detail::suffix_array_header ) ||
+                    reinterpret_cast<std::size_t> ( bytes ) % boost::alignment_of<detail::suffix_array_header>::value != 0 )
+                boost::throw_exception ( std::invalid_argument ( "boost::algorithm::suffix_array_index: bad index image" ));
+            const detail::suffix_array_header &header = *reinterpret_cast<const detail::suffix_array_header *> ( bytes );
+            check_header ( header );
+            if ( n_ == 0 ) return;
+
+            const bool has_lcp = ( header.flags & detail::suffix_array_has_lcp ) != 0;
+            const std::size_t table_size = static_cast<std::size_t> ( n_ ) * sizeof ( Index );
+            if ( ( image_size - sizeof ( header )) / table_size < ( has_lcp ? 2U : 1U ))
+                boost::throw_exception ( std::invalid_argument ( "boost::algorithm::suffix_array_index: truncated index image" ));
+            sa_ = reinterpret_cast<const Index *> ( bytes + sizeof ( header ));
+            if ( has_lcp )
+                lcp_ = sa_ + n_;
+            }
+
+        ~suffix_array_index () {}
+
+        /// Writes the index (but not the corpus) to a stream; check the stream for errors.
+        void save ( std::ostream &out ) const {
+            detail::suffix_array_header header;
+            std::memcpy ( header.magic, detail::suffix_array_magic, sizeof ( header.magic ));
+            header.byte_order = detail::suffix_array_byte_order;
+            header.index_size = sizeof ( Index );
+            header.flags      = lcp_ != NULL ? detail::suffix_array_has_lcp : 0;
+            header.length     = n_;
+            out.write ( reinterpret_cast<const char *> ( &header ), sizeof ( header ));
+            if ( n_ == 0 ) return;
+            out.write ( reinterpret_cast<const char *> ( sa_ ), static_cast<std::streamsize> ( n_ * sizeof ( Index )));
+            if ( lcp_ != NULL )
+                out.write ( reinterpret_cast<const char *> ( lcp_ ), static_cast<std::streamsize> ( n_ * sizeof ( Index )));
+            }
+
+        /// \fn positions ( patIter pat_first, patIter pat_last )
+        /// \brief Returns the positions of all the matches of the pattern, in suffix array (not corpus) order.
+        ///     O(m log n), and does not allocate.
+        ///
+        /// \param pat_first    The start of the pattern (Random Access Iterator)
+        /// \param pat_last     One past the end of the pattern
+        ///
+        template <typename patIter>
+        position_range positions ( patIter pat_first, patIter pat_last ) const {
+            BOOST_STATIC_ASSERT (( sizeof ( typename std::iterator_traits<patIter>::value_type ) == 1 ));
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+        //  Compare the length before narrowing it, so a long pattern can't wrap.
+            const typename std::iterator_traits<patIter>::difference_type k_pattern_length = std::distance ( pat_first, pat_last );
+            if ( k_pattern_length <= 0 || static_cast<boost::uintmax_t> ( k_pattern_length ) > static_cast<boost::uintmax_t> ( n_ ))
+                return position_range ( sa_, sa_ );
+            const Index m = static_cast<Index> ( k_pattern_length );
+            const Index lo = this->lower_bound ( pat_first, m );
+            if ( lo == n_ || !this->starts_with ( lo, pat_first, m ))
+                return position_range ( sa_, sa_ );
+            return position_range ( sa_ + lo, sa_ + this->upper_bound ( pat_first, m, lo + 1 ));
+            }
+
+        template <typename Range>
+        position_range positions ( const Range &pattern ) const {
+            return this->positions ( boost::begin ( pattern ), boost::end ( pattern ));
+            }
+
+        /// The number of (possibly overlapping) matches of the pattern; O(m log n)
+        template <typename patIter>
+        std::size_t count ( patIter pat_first, patIter pat_last ) const {
+            return static_cast<std::size_t> ( this->positions ( pat_first, pat_last ).size ());
+            }
+
+        template <typename Range>
+        std::size_t count ( const Range &pattern ) const {
+            return this->count ( boost::begin ( pattern ), boost::end ( pattern ));
+            }
+
+        /// \fn find_first ( patIter pat_first, patIter pat_last )
+        /// \brief Returns the first match of the pattern in the corpus, or the end of the corpus.
+        ///     O(m log n), plus the number of matches.
+        ///
+        /// \param pat_first    The start of the pattern (Random Access Iterator)
+        /// \param pat_last     One past the end of the pattern
+        ///
+        template <typename patIter>
+        corpusIter find_first ( patIter pat_first, patIter pat_last ) const {
+            if ( pat_first == pat_last )
+                return n_ == 0 ? last_ : first_;    // empty pattern matches at start
+            const position_range found = this->positions ( pat_first, pat_last );
+            if ( found.empty ())
+                return last_;
+            return first_ + *std::min_element ( found.begin (), found.end ());
+            }
+
+        template <typename Range>
+        corpusIter find_first ( const Range &pattern ) const {
+            return this->find_first ( boost::begin ( pattern ), boost::end ( pattern ));
+            }
+
+        /// \fn find_all ( patIter pat_first, patIter pat_last )
+        /// \brief Returns the starts of all the (possibly overlapping) matches, in corpus order
+        ///
+        /// \param pat_first    The start of the pattern (Random Access Iterator)
+        /// \param pat_last     One past the end of the pattern
+        ///
+        template <typename patIter>
+        std::vector<corpusIter> find_all ( patIter pat_first, patIter pat_last ) const {
+            const position_range found = this->positions ( pat_first, pat_last );
+            std::vector<Index> sorted ( found.begin (), found.end ());
+            std::sort ( sorted.begin (), sorted.end ());
+            std::vector<corpusIter> retVal;
+            retVal.reserve ( sorted.size ());
+            for ( typename std::vector<Index>::const_iterator it = sorted.begin (); it != sorted.end (); ++it )
+                retVal.push_back ( first_ + *it );
+            return retVal;
+            }
+
+        template <typename Range>
+        std::vector<corpusIter> find_all ( const Range &pattern ) const {
+            return this->find_all ( boost::begin ( pattern ), boost::end ( pattern ));
+            }
+
+        /// The length of the corpus
+        std::size_t size () const { return n_; }
+
+        /// The suffix array: the starts of the suffixes of the corpus, in sorted order
+        const Index *suffix_array () const { return sa_; }
+
+        /// Whether there is an LCP array
+        bool has_lcp () const { return lcp_ != NULL; }
+
+        /// The LCP array: lcp () [i] is the length of the common prefix of the
+        /// suffixes at suffix_array () [i-1] and suffix_array () [i]; NULL if it was not built.
+        const Index *lcp () const { return lcp_; }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        corpusIter first_, last_;
+        const Index n_;
+        std::vector<Index> sa_storage_;     // empty when the index is used in place
+        std::vector<Index> lcp_storage_;
+        const Index *sa_;
+        const Index *lcp_;
+
+        static Index checked_length ( corpusIter first, corpusIter last ) {
+            const typename std::iterator_traits<corpusIter>::difference_type n = std::distance ( first, last );
+        //  The largest Index is reserved, for the construction
+            if ( static_cast<boost::uintmax_t> ( n ) >= static_cast<boost::uintmax_t> ( static_cast<Index> ( -1 )))
+                boost::throw_exception ( std::length_error ( "boost::algorithm::suffix_array_index: corpus too long for the index type" ));
+            return static_cast<Index> ( n );
+            }
+
+        void check_header ( const detail::suffix_array_header &header ) const {
+            if ( std::memcmp ( header.magic, detail::suffix_array_magic, sizeof ( header.magic )) != 0 ||
+                    header.byte_order != detail::suffix_array_byte_order ||
+                    header.index_size != sizeof ( Index ))
+                boost::throw_exception ( std::invalid_argument ( "boost::algorithm::suffix_array_index: not an index of this type" ));
+            if ( header.length != n_ )
+                boost::throw_exception ( std::invalid_argument ( "boost::algorithm::suffix_array_index: index is for a different corpus" ));
+            }
+
+        static void read_table ( std::istream &in, std::vector<Index> &table ) {
+            if ( !in.read ( reinterpret_cast<char *> ( &table [ 0 ] ), static_cast<std::streamsize> ( table.size () * sizeof ( Index ))))
+                boost::throw_exception ( std::runtime_error ( "boost::algorithm::suffix_array_index: cannot read the index" ));
+            }
+
+    //  Compares the suffix at pos with the pattern, starting 'start' elements in
+    //  (which are known to match). Returns <0, 0 or >0 as the suffix is less than,
+    //  starts with, or is greater than the pattern; 'matched' is set to the
+    //  length of the common prefix.
+        template <typename patIter>
+        int compare ( Index pos, patIter pat_first, Index m, Index start, Index &matched ) const {
+            const Index avail = n_ - pos;
+            for ( Index i = start; i < m; ++i ) {
+                if ( i == avail ) {     // the suffix is a proper prefix of the pattern
+                    matched = i;
+                    return -1;
+                    }
+                const unsigned char c = static_cast<unsigned char> ( first_ [ pos + i ] );
+                const unsigned char p = static_cast<unsigned char> ( pat_first [ i ] );
+                if ( c != p ) {
+                    matched = i;
+                    return c < p ? -1 : 1;
+                    }
+                }
+            matched = m;
+            return 0;
+            }
+
+    //  Binary search, skipping the prefix that is known to match both ends of
+    //  the range (Manber and Myers); the suffixes between two that share k
+    //  elements with the pattern also share those k elements.
+        template <typename patIter>
+        Index lower_bound ( patIter pat_first, Index m ) const {
+            Index lo = 0, hi = n_, lo_lcp = 0, hi_lcp = 0;
+            while ( lo < hi ) {
+                const Index mid = lo + ( hi - lo ) / 2;
+                Index matched;
+                if ( this->compare ( sa_ [ mid ], pat_first, m, (std::min) ( lo_lcp, hi_lcp ), matched ) < 0 ) {
+                    lo = mid + 1;
+                    lo_lcp = matched;
+                    }
+                else {
+                    hi = mid;
+                    hi_lcp = matched;
+                    }
+                }
+            return lo;
+            }
+
+    //  The end of the run of matches; the suffix before 'first' is known to
+    //  match. With the LCP array, short runs are found by walking it.
+        template <typename patIter>
+        Index upper_bound ( patIter pat_first, Index m, Index first ) const {
+            if ( lcp_ != NULL ) {
+                const Index walk_limit = 64;
+                const Index stop = n_ - first < walk_limit ? n_ : first + walk_limit;
+                while ( first < stop && lcp_ [ first ] >= m )
+                    ++first;
+                if ( first < n_ && lcp_ [ first ] < m )
+                    return first;
+                }
+
+            Index lo = first, hi = n_, lo_lcp = 0, hi_lcp = 0;
+            while ( lo < hi ) {
+                const Index mid = lo + ( hi - lo ) / 2;
+                Index matched;
+                if ( this->compare ( sa_ [ mid ], pat_first, m, (std::min) ( lo_lcp, hi_lcp ), matched ) <= 0 ) {
+                    lo = mid + 1;
+                    lo_lcp = matched;
+                    }
+                else {
+                    hi = mid;
+                    hi_lcp = matched;
+                    }
+                }
+            return lo;
+            }
+
+        template <typename patIter>
+        bool starts_with ( Index i, patIter pat_first, Index m ) const {
+            Index matched;
+            return this->compare ( sa_ [ i ], pat_first, m, 0, matched ) == 0;
+            }
+/// \endcond
+        };
+
+}}
+
+#endif  //  BOOST_ALGORITHM_SUFFIX_ARRAY_INDEX_HPP
@@ -0,0 +1,350 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef BOOST_ALGORITHM_TWO_WAY_SEARCH_HPP
+#define BOOST_ALGORITHM_TWO_WAY_SEARCH_HPP
+
+#include <algorithm>    // for std::max, std::equal
+#include <iterator>     // for std::iterator_traits
+
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/has_range_iterator.hpp>
+
+#include <boost/utility/enable_if.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+namespace boost { namespace algorithm {
+
+namespace detail {
+/// \cond DOXYGEN_HIDE
+
+//  Compute the maximal suffix of [ first, first + count ), for the ordering '<'
+//  (or the reversed ordering, if 'reversed' is true). Returns the position
+//  where the suffix starts; 'period' gets the period of the suffix.
+    template <typename Iter>
+    typename std::iterator_traits<Iter>::difference_type
+    maximal_suffix ( Iter first, typename std::iterator_traits<Iter>::difference_type count,
+                     bool reversed, typename std::iterator_traits<Iter>::difference_type &period ) {
+        typedef typename std::iterator_traits<Iter>::difference_type difference_type;
+        difference_type max_suffix = -1;    // the suffix starts at max_suffix + 1
+        difference_type j = 0;
+        difference_type k = 1;
+        period = 1;
+        while ( j + k < count ) {
+            const bool less    = reversed ? first [ max_suffix + k ] < first [ j + k ]
+                                          : first [ j + k ] < first [ max_suffix + k ];
+            const bool greater = reversed ? first [ j + k ] < first [ max_suffix + k ]
+                                          : first [ max_suffix + k ] < first [ j + k ];
+            if ( less ) {           // the suffix at j + k is smaller; extend the period
+                j += k;
+                k = 1;
+                period = j - max_suffix;
+                }
+            else if ( !greater ) {  // equal; keep going around the period
+                if ( k != period )
+                    ++k;
+                else {
+                    j += period;
+                    k = 1;
+                    }
+                }
+            else {                  // a new, larger, suffix starts here
+                max_suffix = j++;
+                k = period = 1;
+                }
+            }
+        return max_suffix + 1;
+        }
+
+//  The critical factorization of a pattern (Crochemore-Perrin): the later
+//  of the two maximal suffixes. Returns the length of the left part;
+//  'period' gets the period of the right part.
+    template <typename Iter>
+    typename std::iterator_traits<Iter>::difference_type
+    critical_factorization ( Iter first, typename std::iterator_traits<Iter>::difference_type count,
+                             typename std::iterator_traits<Iter>::difference_type &period ) {
+        typedef typename std::iterator_traits<Iter>::difference_type difference_type;
+        difference_type period_fwd, period_rev;
+        const difference_type suffix_fwd = maximal_suffix ( first, count, false, period_fwd );
+        const difference_type suffix_rev = maximal_suffix ( first, count, true,  period_rev );
+        if ( suffix_rev < suffix_fwd ) {
+            period = period_fwd;
+            return suffix_fwd;
+            }
+        period = period_rev;
+        return suffix_rev;
+        }
+
+//  Is 'period' (as found by critical_factorization) the period of the whole pattern?
+    template <typename Iter>
+    bool is_periodic ( Iter first, typename std::iterator_traits<Iter>::difference_type count,
+                       typename std::iterator_traits<Iter>::difference_type suffix,
+                       typename std::iterator_traits<Iter>::difference_type period ) {
+        return suffix + period <= count && std::equal ( first, first + suffix, first + period );
+        }
+
+/// \endcond
+}
+
+/*
+    A templated version of the Two-Way searching algorithm.
+
+    The pattern is split at a "critical factorization" into a left and a right
+    part. The right part is compared left to right, then the left part right
+    to left; the shifts come from the period of the pattern. No tables are
+    built: the searcher stores only the split point and the period.
+
+References:
+    http://monge.univ-mlv.fr/~mac/Articles-PDF/CP-1991-jacm.pdf
+
+Explanations:
+    http://www-igm.univ-mlv.fr/~lecroq/string/node26.html
+    http://en.wikipedia.org/wiki/Two-way_string-matching_algorithm
+
+Requirements:
+        * Random access iterators
+        * The two iterator types (patIter and corpusIter) must
+            "point to" the same underlying type and be comparable.
+        * The elements of the pattern must be LessThanComparable;
+          any strict weak ordering will do.
+*/
+
+    template <typename patIter>
+    class two_way {
+        typedef typename std::iterator_traits<patIter>::difference_type difference_type;
+    public:
+        two_way ( patIter first, patIter last )
+                : pat_first ( first ), pat_last ( last ),
+                  k_pattern_length ( std::distance ( pat_first, pat_last )),
+                  suffix_ ( 0 ), period_ ( 1 ), periodic_ ( false ) {
+            if ( k_pattern_length > 0 ) {
+                suffix_   = detail::critical_factorization ( pat_first, k_pattern_length, period_ );
+                periodic_ = detail::is_periodic ( pat_first, k_pattern_length, suffix_, period_ );
+            //  If the pattern is not periodic, any shift up to this one is safe
+                if ( !periodic_ )
+                    period_ = (std::max) ( suffix_, k_pattern_length - suffix_ ) + 1;
+                }
+            }
+
+        ~two_way () {}
+
+        /// \fn operator ( corpusIter corpus_first, corpusIter corpus_last )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        ///
+        template <typename corpusIter>
+        corpusIter operator () ( corpusIter corpus_first, corpusIter corpus_last ) const {
+            BOOST_STATIC_ASSERT (( boost::is_same<
+                                    typename std::iterator_traits<patIter>::value_type,
+                                    typename std::iterator_traits<corpusIter>::value_type>::value ));
+
+            if ( corpus_first == corpus_last ) return corpus_last;  // if nothing to search, we didn't find it!
+            if (    pat_first ==    pat_last ) return corpus_first; // empty pattern matches at start
+
+            const difference_type k_corpus_length  = std::distance ( corpus_first, corpus_last );
+        //  If the pattern is larger than the corpus, we can't find it!
+            if ( k_corpus_length < k_pattern_length )
+                return corpus_last;
+
+        //  Do the search
+            return this->do_search ( corpus_first, corpus_last, 0 );
+            }
+
+        template <typename Range>
+        typename boost::range_iterator<Range>::type operator () ( Range &r ) const {
+            return (*this) (boost::begin(r), boost::end(r));
+            }
+
+        /// \fn find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Searches for the next match after a match that has already been found
+        ///
+        /// \param match       The start of a match of the pattern (Random Access Iterator)
+        /// \param corpus_last One past the end of the data to search
+        /// \param mode        Whether the next match may overlap this one
+        ///
+        template <typename corpusIter>
+        corpusIter find_next ( corpusIter match, corpusIter corpus_last, search_overlap_mode mode ) const {
+            if ( pat_first == pat_last )
+                return corpus_last;
+            if ( mode == search_non_overlapping )
+                return this->do_search ( match + k_pattern_length, corpus_last, 0 );
+        //  For a periodic pattern, the first (length - period) elements
+        //  at the next position are already known to match.
+            return this->do_search ( match + period_, corpus_last, periodic_ ? k_pattern_length - period_ : 0 );
+            }
+
+        /// \fn find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode )
+        /// \brief Returns a range of all the matches of the pattern in the corpus
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param mode         Whether matches may overlap
+        ///
+        template <typename corpusIter>
+        boost::iterator_range<search_match_iterator<two_way, corpusIter> >
+        find_all ( corpusIter corpus_first, corpusIter corpus_last, search_overlap_mode mode = search_overlapping ) const {
+            typedef search_match_iterator<two_way, corpusIter> iterator;
+        //  An empty pattern matches everywhere; rather than report that, report nothing.
+            const corpusIter first_match = pat_first == pat_last ? corpus_last : (*this) ( corpus_first, corpus_last );
+            return boost::iterator_range<iterator> (
+                        iterator ( *this, first_match, corpus_last, mode ),
+                        iterator ( *this, corpus_last, corpus_last, mode ));
+            }
+
+        template <typename Range>
+        boost::iterator_range<search_match_iterator<two_way, typename boost::range_iterator<Range>::type> >
+        find_all ( Range &r, search_overlap_mode mode = search_overlapping ) const {
+            return this->find_all (boost::begin(r), boost::end(r), mode);
+            }
+
+    private:
+/// \cond DOXYGEN_HIDE
+        patIter pat_first, pat_last;
+        const difference_type k_pattern_length;
+        difference_type suffix_;    // the length of the left part of the critical factorization
+        difference_type period_;    // the shift after matching the right part
+        bool periodic_;             // is period_ the period of the whole pattern?
+
+        /// \fn do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory )
+        /// \brief Searches the corpus for the pattern that was passed into the constructor
+        ///
+        /// \param corpus_first The start of the data to search (Random Access Iterator)
+        /// \param corpus_last  One past the end of the data to search
+        /// \param memory       The number of pattern elements already known to
+        ///                     match at the start of the corpus (periodic patterns only)
+        ///
+        template <typename corpusIter>
+        corpusIter do_search ( corpusIter corpus_first, corpusIter corpus_last, difference_type memory ) const {
+            const difference_type last_match = std::distance ( corpus_first, corpus_last ) - k_pattern_length;
+            difference_type j = 0;      // the position in the corpus that we're matching
+            difference_type i;          // the position in the pattern that we're comparing
+
+            if ( periodic_ ) {
+            //  Remember how much of the pattern matched after a shift by the
+            //  period, so that nothing is compared twice.
+                while ( j <= last_match ) {
+                    i = (std::max) ( suffix_, memory );
+                    while ( i < k_pattern_length && pat_first [ i ] == corpus_first [ i + j ] )
+                        ++i;
+                    if ( i >= k_pattern_length ) {
+                        i = suffix_ - 1;
+                        while ( i >= memory && pat_first [ i ] == corpus_first [ i + j ] )
+                            --i;
+                        if ( i < memory )
+                            return corpus_first + j;
+                        j += period_;
+                        memory = k_pattern_length - period_;
+                        }
+                    else {
+                        j += i - suffix_ + 1;
+                        memory = 0;
+                        }
+                    }
+                }
+            else {
+                while ( j <= last_match ) {
+                    i = suffix_;
+                    while ( i < k_pattern_length && pat_first [ i ] == corpus_first [ i + j ] )
+                        ++i;
+                    if ( i >= k_pattern_length ) {
+                        i = suffix_ - 1;
+                        while ( i >= 0 && pat_first [ i ] == corpus_first [ i + j ] )
+                            --i;
+                        if ( i < 0 )
+                            return corpus_first + j;
+                        j += period_;
+                        }
+                    else
+                        j += i - suffix_ + 1;
+                    }
+                }
+
+            return corpus_last;     // We didn't find anything
+            }
+/// \endcond
+        };
+
+
+/*  Two ranges as inputs gives us four possibilities; with 2,3,3,4 parameters
+    Use a bit of TMP to disambiguate the 3-argument templates */
+
+/// \fn two_way_search ( corpusIter corpus_first, corpusIter corpus_last,
+///       patIter pat_first, patIter pat_last )
+/// \brief Searches the corpus for the pattern.
+///
+/// \param corpus_first The start of the data to search (Random Access Iterator)
+/// \param corpus_last  One past the end of the data to search
+/// \param pat_first    The start of the pattern to search for (Random Access Iterator)
+/// \param pat_last     One past the end of the data to search for
+///
+    template <typename patIter, typename corpusIter>
+    corpusIter two_way_search (
+                  corpusIter corpus_first, corpusIter corpus_last,
+                  patIter pat_first, patIter pat_last )
+    {
+        two_way<patIter> tw ( pat_first, pat_last );
+        return tw ( corpus_first, corpus_last );
+    }
+
+    template <typename PatternRange, typename corpusIter>
+    corpusIter two_way_search (
+        corpusIter corpus_first, corpusIter corpus_last, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        two_way<pattern_iterator> tw ( boost::begin(pattern), boost::end (pattern));
+        return tw ( corpus_first, corpus_last );
+    }
+
+    template <typename patIter, typename CorpusRange>
+    typename boost::lazy_disable_if_c<
+        boost::is_same<CorpusRange, patIter>::value || !boost::has_range_iterator<CorpusRange>::value,
+        typename boost::range_iterator<CorpusRange> >
+    ::type
+    two_way_search ( CorpusRange &corpus, patIter pat_first, patIter pat_last )
+    {
+        two_way<patIter> tw ( pat_first, pat_last );
+        return tw (boost::begin (corpus), boost::end (corpus));
+    }
+
+    template <typename PatternRange, typename CorpusRange>
+    typename boost::range_iterator<CorpusRange>::type
+    two_way_search ( CorpusRange &corpus, const PatternRange &pattern )
+    {
+        typedef typename boost::range_iterator<const PatternRange>::type pattern_iterator;
+        two_way<pattern_iterator> tw ( boost::begin(pattern), boost::end (pattern));
+        return tw (boost::begin (corpus), boost::end (corpus));
+    }
+
+
+    //  Creator functions -- take a pattern range, return an object
+    template <typename Range>
+    boost::algorithm::two_way<typename boost::range_iterator<const Range>::type>
+    make_two_way ( const Range &r ) {
+        return boost::algorithm::two_way
+            <typename boost::range_iterator<const Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+    template <typename Range>
+    boost::algorithm::two_way<typename boost::range_iterator<Range>::type>
+    make_two_way ( Range &r ) {
+        return boost::algorithm::two_way
+            <typename boost::range_iterator<Range>::type> (boost::begin(r), boost::end(r));
+        }
+
+}}
+
+#endif  //  BOOST_ALGORITHM_TWO_WAY_SEARCH_HPP
@@ -0,0 +1,95 @@
+//  Boost string_algo library count.hpp header file  ---------------------------//
+
+//  Copyright Pavol Droba 2002-2006.
+//
+// Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//          http://www.boost.org/LICENSE_1_0.txt)
+
+//  See http://www.boost.org/ for updates, documentation, and revision history.
+
+#ifndef BOOST_STRING_COUNT_DETAIL_HPP
+#define BOOST_STRING_COUNT_DETAIL_HPP
+
+#include <cstddef>
+#include <iterator>
+
+#include <boost/algorithm/string/config.hpp>
+#include <boost/algorithm/string/compare.hpp>
+#include <boost/algorithm/string/detail/finder.hpp>
+#include <boost/algorithm/searching/detail/match_count.hpp>
+#include <boost/range/iterator_range_core.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+
+namespace boost {
+    namespace algorithm {
+        namespace detail {
+
+//  count all  -------------------------------------------------------//
+
+            // count the non-overlapping matches, one finder step at a time
+            template<typename InputIteratorT, typename SearchIteratorT, typename PredicateT>
+            inline std::size_t count_all_finder(
+                InputIteratorT Begin,
+                InputIteratorT End,
+                SearchIteratorT SearchBegin,
+                SearchIteratorT SearchEnd,
+                PredicateT Comp )
+            {
+                first_finderF<SearchIteratorT, PredicateT> Finder( SearchBegin, SearchEnd, Comp );
+
+                std::size_t Count=0;
+                for( iterator_range<InputIteratorT> M=Finder( Begin, End );
+                    !M.empty();
+                    M=Finder( M.end(), End ) )
+                {
+                    ++Count;
+                }
+                return Count;
+            }
+
+            template<typename InputIteratorT, typename SearchIteratorT, typename PredicateT>
+            inline std::size_t count_all(
+                InputIteratorT Begin,
+                InputIteratorT End,
+                SearchIteratorT SearchBegin,
+                SearchIteratorT SearchEnd,
+                PredicateT Comp )
+            {
+                return ::boost::algorithm::detail::count_all_finder(
+                    Begin, End, SearchBegin, SearchEnd, Comp );
+            }
+
+            // a one-character search string is counted with std::count, or with
+            // the SSE2/AVX2 compare-and-count loop when both sides are bytes
+            // and the input is given as pointers
+            template<typename InputIteratorT, typename SearchIteratorT>
+            inline std::size_t count_all(
+                InputIteratorT Begin,
+                InputIteratorT End,
+                SearchIteratorT SearchBegin,
+                SearchIteratorT SearchEnd,
+                is_equal Comp )
+            {
+                SearchIteratorT Next=SearchBegin;
+                if( SearchBegin==SearchEnd || ++Next!=SearchEnd )
+                {
+                    return ::boost::algorithm::detail::count_all_finder(
+                        Begin, End, SearchBegin, SearchEnd, Comp );
+                }
+
+                typedef BOOST_STRING_TYPENAME
+                    std::iterator_traits<SearchIteratorT>::value_type search_value_type;
+                typedef ::boost::integral_constant<bool,
+                    ::boost::algorithm::detail::is_byte_pointer<InputIteratorT>::value &&
+                    sizeof(search_value_type)==1> use_bytes;
+
+                return ::boost::algorithm::detail::count_element(
+                    Begin, End, *SearchBegin, use_bytes() );
+            }
+
+        } // namespace detail
+    } // namespace algorithm
+} // namespace boost
+
+#endif  // BOOST_STRING_COUNT_DETAIL_HPP
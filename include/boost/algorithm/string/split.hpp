@@ -16,6 +16,11 @@
 #include <boost/algorithm/string/iter_find.hpp>
 #include <boost/algorithm/string/finder.hpp>
 #include <boost/algorithm/string/compare.hpp>
+#include <boost/algorithm/string/detail/count.hpp>
+
+#include <boost/range/iterator_range_core.hpp>
+#include <boost/range/iterator.hpp>
+#include <boost/range/as_literal.hpp>
 
 /*! \file
     Defines basic split algorithms. 
@@ -107,6 +112,74 @@ namespace boost {
         }
 
 
+//  count_all  -----------------------------------------------------------//
+
+        //! Count all algorithm
+        /*!
+            This algorithm counts the occurrences of the search string
+            in the input. The occurrences are the ones find_all would 
+            find, so they do not overlap, but nothing is copied.
+
+            A one-character search string is counted with \c std::count. If the
+            input is also given as pointers to bytes (a C string, or an
+            \c iterator_range over \c std::string::data()), the count uses the
+            SSE2/AVX2 loop of the searchers instead. Longer search strings
+            are found one match at a time.
+
+            \param Input A container which will be searched.
+            \param Search A substring to be searched for.
+            \return The number of occurrences of the search string
+
+            \note This function provides the strong exception-safety guarantee
+        */
+        template< typename Range1T, typename Range2T >
+        inline std::size_t count_all(
+            const Range1T& Input,
+            const Range2T& Search)
+        {
+            iterator_range<BOOST_STRING_TYPENAME range_iterator<const Range1T>::type> 
+                lit_input(::boost::as_literal(Input));
+            iterator_range<BOOST_STRING_TYPENAME range_iterator<const Range2T>::type> 
+                lit_search(::boost::as_literal(Search));
+
+            return ::boost::algorithm::detail::count_all(
+                ::boost::begin(lit_input), ::boost::end(lit_input),
+                ::boost::begin(lit_search), ::boost::end(lit_search),
+                is_equal() );
+        }
+
+        //! Count all algorithm ( case insensitive ) 
+        /*!
+            This algorithm counts the occurrences of the search string
+            in the input. The occurrences are the ones ifind_all would 
+            find, so they do not overlap, but nothing is copied.
+
+            Searching is case insensitive.
+
+            \param Input A container which will be searched.
+            \param Search A substring to be searched for.
+            \param Loc A locale used for case insensitive comparison
+            \return The number of occurrences of the search string
+
+            \note This function provides the strong exception-safety guarantee
+        */
+        template< typename Range1T, typename Range2T >
+        inline std::size_t icount_all(
+            const Range1T& Input,
+            const Range2T& Search,
+            const std::locale& Loc=std::locale() )
+        {
+            iterator_range<BOOST_STRING_TYPENAME range_iterator<const Range1T>::type> 
+                lit_input(::boost::as_literal(Input));
+            iterator_range<BOOST_STRING_TYPENAME range_iterator<const Range2T>::type> 
+                lit_search(::boost::as_literal(Search));
+
+            return ::boost::algorithm::detail::count_all(
+                ::boost::begin(lit_input), ::boost::end(lit_input),
+                ::boost::begin(lit_search), ::boost::end(lit_search),
+                is_iequal(Loc) );
+        }
+
 //  tokenize  -------------------------------------------------------------//
 
         //! Split algorithm
@@ -154,6 +227,8 @@ namespace boost {
     // pull names to the boost namespace
     using algorithm::find_all;
     using algorithm::ifind_all;
+    using algorithm::count_all;
+    using algorithm::icount_all;
     using algorithm::split;    
 
 } // namespace boost
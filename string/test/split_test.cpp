@@ -82,6 +82,30 @@ void iterator_test()
         string("xx") );
     deep_compare( tokens, vtokens );
 
+    // count_all tests
+    BOOST_CHECK( count_all( pch1, "xx" )==2 );
+    BOOST_CHECK( count_all( str1, string("xx") )==2 );
+    BOOST_CHECK( count_all( str2, "xx" )==1 );
+    BOOST_CHECK( icount_all( str2, "xx" )==3 );
+    BOOST_CHECK( count_all( str1, "-" )==4 );
+    BOOST_CHECK( count_all( str1, "yy" )==0 );
+    BOOST_CHECK( count_all( str1, strempty )==0 );
+    BOOST_CHECK( count_all( strempty, "xx" )==0 );
+    // matches do not overlap
+    BOOST_CHECK( count_all( "xxxxx", str3 )==2 );
+    BOOST_CHECK( icount_all( "xXxXx", str3 )==2 );
+    list<char> l2( str1.begin(), str1.end() );
+    BOOST_CHECK( count_all( l2, "xx" )==2 );
+    BOOST_CHECK( count_all( l2, "-" )==4 );
+    // one character over pointers takes the vectorized count
+    BOOST_CHECK( count_all( pch1, "-" )==4 );
+    BOOST_CHECK( count_all( pch1, "q" )==0 );
+    string strlong;
+    for( int i=0; i<1000; ++i ) strlong+=str2;
+    BOOST_CHECK( count_all( make_iterator_range( strlong.data(), strlong.data()+strlong.size() ), "-" )==5000 );
+    BOOST_CHECK( count_all( make_iterator_range( strlong.data(), strlong.data()+strlong.size() ), "x" )==4000 );
+    BOOST_CHECK( count_all( strlong, "x" )==4000 );
+
     // split tests
     split(
         tokens,
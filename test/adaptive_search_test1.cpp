@@ -0,0 +1,116 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the adaptive searcher
+*/
+
+#include <boost/algorithm/searching/adaptive_search.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        typedef std::string::const_iterator iter;
+        const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+
+    //  With and without a hint about the corpus length
+        ba::adaptive_searcher<iter> as1 ( pattern.begin (), pattern.end ());
+        ba::adaptive_searcher<iter> as2 ( pattern.begin (), pattern.end (), corpus.size ());
+        BOOST_CHECK ( as1 ( corpus.begin (), corpus.end ()) == expected );
+        BOOST_CHECK ( as2 ( corpus ) == expected );
+        BOOST_CHECK ( ba::adaptive_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::adaptive_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::make_searcher ( pattern ) ( corpus ) == expected );
+
+    //  Byte pointers get the memchr and word-load kernels
+        const char *cfirst = corpus.data ();
+        const char *clast  = cfirst + corpus.size ();
+        ba::adaptive_searcher<const char *> as3 ( pattern.data (), pattern.data () + pattern.size ());
+        BOOST_CHECK_EQUAL ( as3 ( cfirst, clast ) - cfirst, expected - corpus.begin ());
+        }
+
+    template <typename Range>
+    ba::search_kernel kernel_for ( const Range &pattern, std::size_t expected = 0 ) {
+        return ba::make_searcher ( pattern, expected ).kernel ();
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_choice )
+{
+    const std::string empty;
+    BOOST_CHECK_EQUAL ( kernel_for ( empty ),                       ba::kernel_naive );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "x" )),          ba::kernel_element );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "xy" )),         ba::kernel_word );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "wxyz" )),       ba::kernel_word );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "the quick" )),  ba::kernel_boyer_moore_horspool );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "the quick" ), 100 ), ba::kernel_naive );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "abcabcabcabc" )),    ba::kernel_knuth_morris_pratt );
+    BOOST_CHECK_EQUAL ( kernel_for ( std::string ( "ACGTTGCAACGGTACCA" )), ba::kernel_boyer_moore );
+
+//  Non-byte patterns: no word kernel, and no alphabet or period
+    std::vector<int> ints ( 3, 7 );
+    BOOST_CHECK_EQUAL ( kernel_for ( ints ), ba::kernel_boyer_moore_horspool );
+    ints.resize ( 100, 7 );
+    BOOST_CHECK_EQUAL ( kernel_for ( ints ), ba::kernel_boyer_moore );
+}
+
+BOOST_AUTO_TEST_CASE( test_search )
+{
+//  Doesn't clash with std::search in unqualified calls
+    {
+        using namespace std;
+        using namespace boost::algorithm;
+        const std::string s ( "abracadabra" ), p ( "cad" );
+        BOOST_CHECK ( search ( s.begin (), s.end (), p.begin (), p.end ()) == s.begin () + 4 );
+        BOOST_CHECK ( adaptive_search ( s.begin (), s.end (), p.begin (), p.end ()) == s.begin () + 4 );
+    }
+
+    check_one ( "abracadabra", "abra" );
+    check_one ( "abracadabra", "a" );
+    check_one ( "abracadabra", "z" );
+    check_one ( "abracadabra", "ra" );
+    check_one ( "abracadabra", "dab" );
+    check_one ( "abracadabra", "cada" );
+    check_one ( "abracadabra", "abracadabra" );
+    check_one ( "abracadabra", "" );
+    check_one ( "", "abra" );
+    check_one ( "ab", "abc" );
+    check_one ( "\xff\xfe\x80\x01", "\xfe\x80" );
+
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 24; ++pat_len )
+        for ( int alphabet = 1; alphabet <= 26; alphabet += 5 )
+            for ( int i = 0; i < 5; ++i ) {
+                const std::string corpus = random_string ( 1000, alphabet );
+                check_one ( corpus, random_string ( pat_len, alphabet ));
+                const std::size_t pos = std::rand () % ( corpus.size () - pat_len );
+                check_one ( corpus, corpus.substr ( pos, pat_len ));
+                }
+
+//  Non-character data
+    std::vector<int> corpus, pattern;
+    for ( int i = 0; i < 1000; ++i )
+        corpus.push_back ( i % 97 );
+    for ( int i = 90; i < 100; ++i )
+        pattern.push_back ( i % 97 );
+    BOOST_CHECK ( ba::adaptive_search ( corpus, pattern ) == corpus.begin () + 90 );
+    pattern.resize ( 1 );
+    BOOST_CHECK ( ba::adaptive_search ( corpus, pattern ) == corpus.begin () + 90 );
+}
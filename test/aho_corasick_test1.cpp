@@ -0,0 +1,134 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#include <boost/algorithm/searching/aho_corasick.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::pair<std::size_t, std::ptrdiff_t> match;     // ( pattern id, position )
+
+    template <typename Iter>
+    struct collect_matches {
+        collect_matches ( Iter first, std::vector<match> &out ) : first_ ( first ), out_ ( &out ) {}
+        void operator () ( std::size_t id, Iter pos ) { out_->push_back ( match ( id, pos - first_ )); }
+        Iter first_;
+        std::vector<match> *out_;
+        };
+
+//  Every occurrence of every (non-empty) pattern, the slow way
+    template <typename Container, typename Patterns>
+    std::vector<match> naive_matches ( const Container &corpus, const Patterns &patterns ) {
+        std::vector<match> retVal;
+        for ( std::size_t id = 0; id < patterns.size (); ++id ) {
+            if ( patterns [ id ].empty ()) continue;
+            typename Container::const_iterator it = corpus.begin ();
+            while (( it = std::search ( it, corpus.end (), patterns [ id ].begin (), patterns [ id ].end ())) != corpus.end ()) {
+                retVal.push_back ( match ( id, it - corpus.begin ()));
+                ++it;
+                }
+            }
+        std::sort ( retVal.begin (), retVal.end ());
+        return retVal;
+        }
+
+    template <typename Container, typename Patterns>
+    void check_one ( const Container &corpus, const Patterns &patterns ) {
+        typedef typename Container::const_iterator corpus_iter;
+        typedef typename Patterns::value_type::const_iterator pattern_iter;
+
+        ba::aho_corasick<pattern_iter> ac ( patterns.begin (), patterns.end ());
+        BOOST_CHECK_EQUAL ( ac.pattern_count (), patterns.size ());
+
+    //  All the matches
+        std::vector<match> found;
+        ac.for_each_match ( corpus.begin (), corpus.end (), collect_matches<corpus_iter> ( corpus.begin (), found ));
+        std::sort ( found.begin (), found.end ());
+        std::vector<match> expected = naive_matches ( corpus, patterns );
+        BOOST_CHECK ( found == expected );
+
+    //  The leftmost match
+        std::ptrdiff_t first_pos = -1;
+        for ( std::size_t i = 0; i < expected.size (); ++i )
+            if ( first_pos < 0 || expected [ i ].second < first_pos )
+                first_pos = expected [ i ].second;
+        std::pair<corpus_iter, std::size_t> res = ac ( corpus.begin (), corpus.end ());
+        if ( first_pos < 0 ) {
+            BOOST_CHECK ( res.first == corpus.end ());
+            BOOST_CHECK_EQUAL ( res.second, ba::aho_corasick<pattern_iter>::npos );
+            }
+        else {
+            BOOST_CHECK_EQUAL ( res.first - corpus.begin (), first_pos );
+            BOOST_REQUIRE ( res.second < patterns.size ());
+            BOOST_CHECK ( std::equal ( patterns [ res.second ].begin (), patterns [ res.second ].end (), res.first ));
+            }
+
+        std::pair<corpus_iter, std::size_t> res2 = ba::aho_corasick_search ( corpus, patterns );
+        BOOST_CHECK ( res == res2 );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    std::vector<std::string> keywords;
+    keywords.push_back ( "he" );
+    keywords.push_back ( "she" );
+    keywords.push_back ( "his" );
+    keywords.push_back ( "hers" );
+    keywords.push_back ( "" );
+    keywords.push_back ( "she" );       // duplicates are reported under both ids
+    check_one ( std::string ( "ushers" ), keywords );
+    check_one ( std::string ( "ahishers sheshe" ), keywords );
+    check_one ( std::string ( "nothing to see" ), keywords );
+    check_one ( std::string (), keywords );
+    check_one ( std::string ( "ushers" ), std::vector<std::string> ());
+
+//  Leftmost, not first to end: "abcdef" starts before "cd" but ends after it
+    std::vector<std::string> overlap;
+    overlap.push_back ( "cd" );
+    overlap.push_back ( "abcdef" );
+    std::string corpus ( "xxabcdefxx" );
+    std::pair<std::string::const_iterator, std::size_t> res = ba::make_aho_corasick ( overlap ) ( corpus );
+    BOOST_CHECK_EQUAL ( res.first - corpus.begin (), 2 );
+    BOOST_CHECK_EQUAL ( res.second, 1U );
+
+//  Lots of random patterns over a small alphabet; many overlapping matches
+    std::srand ( 1 );
+    for ( int alphabet = 2; alphabet <= 8; alphabet *= 2 ) {
+        std::vector<std::string> patterns;
+        for ( std::size_t i = 0; i < 50; ++i )
+            patterns.push_back ( random_string ( 1 + std::rand () % 8, alphabet ));
+        check_one ( random_string ( 2000, alphabet ), patterns );
+        }
+
+//  Non-byte data uses the map-based transition table
+    std::vector<std::vector<int> > int_patterns;
+    for ( std::size_t i = 0; i < 20; ++i ) {
+        std::vector<int> p;
+        for ( std::size_t j = 0, len = 1 + std::rand () % 5; j < len; ++j )
+            p.push_back ( 1000 + std::rand () % 3 );
+        int_patterns.push_back ( p );
+        }
+    std::vector<int> int_corpus;
+    for ( std::size_t i = 0; i < 1000; ++i )
+        int_corpus.push_back ( 1000 + std::rand () % 3 );
+    check_one ( int_corpus, int_patterns );
+}
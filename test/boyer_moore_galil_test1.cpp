@@ -0,0 +1,164 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing that Boyer-Moore does a linear number of comparisons,
+    even on periodic patterns with many matches
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/static_search.hpp>
+#include <boost/iterator/iterator_adaptor.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    std::size_t comparisons = 0;
+
+//  A character that counts how many times it is compared
+    struct counted {
+        unsigned char c;
+        };
+
+    bool operator == ( counted lhs, counted rhs ) { ++comparisons; return lhs.c == rhs.c; }
+    bool operator != ( counted lhs, counted rhs ) { return !( lhs == rhs ); }
+
+    typedef std::vector<counted>::const_iterator iter;
+
+//  A skip table for counted, indexed by the character; looking
+//  up the skip is not a comparison.
+    class counted_skip_table {
+    public:
+        counted_skip_table ( std::size_t /*patSize*/, std::ptrdiff_t default_value )
+            : skip_ ( 256, default_value ) {}
+
+        void insert ( counted key, std::ptrdiff_t val ) { skip_ [ key.c ] = val; }
+        std::ptrdiff_t operator [] ( counted key ) const { return skip_ [ key.c ]; }
+
+    private:
+        std::vector<std::ptrdiff_t> skip_;
+        };
+
+    struct counted_traits {
+        typedef counted_skip_table skip_table_t;
+        };
+
+    typedef ba::boyer_moore<iter, counted_traits> counted_bm;
+
+    std::vector<counted> make_counted ( const std::string &str ) {
+        std::vector<counted> retVal ( str.size ());
+        for ( std::size_t i = 0; i < str.size (); ++i )
+            retVal [ i ].c = static_cast<unsigned char> ( str [ i ] );
+        return retVal;
+        }
+
+    std::string repeat ( const std::string &str, std::size_t count ) {
+        std::string retVal;
+        for ( std::size_t i = 0; i < count; ++i )
+            retVal += str;
+        return retVal;
+        }
+
+//  Find every match, and check the number of comparisons
+    void check_linear ( const std::string &corpus_str, const std::string &pattern_str ) {
+        const std::vector<counted> corpus  = make_counted ( corpus_str );
+        const std::vector<counted> pattern = make_counted ( pattern_str );
+        const counted_bm bm ( pattern.begin (), pattern.end ());
+
+    //  The expected number of matches
+        std::size_t expected = 0;
+        for ( std::string::const_iterator it = corpus_str.begin ();
+                ( it = std::search ( it, corpus_str.end (), pattern_str.begin (), pattern_str.end ())) != corpus_str.end (); ++it )
+            ++expected;
+
+        for ( int m = 0; m < 2; ++m ) {
+            const ba::search_overlap_mode mode = m == 0 ? ba::search_overlapping : ba::search_non_overlapping;
+            comparisons = 0;
+            const std::size_t found = boost::distance ( bm.find_all ( corpus, mode ));
+            if ( mode == ba::search_overlapping )
+                BOOST_CHECK_EQUAL ( found, expected );
+            BOOST_CHECK_MESSAGE ( comparisons <= 3 * corpus.size (),
+                    "'" << pattern_str.substr ( 0, 20 ) << "...' (" << pattern_str.size () << " elements) in "
+                    << corpus.size () << " elements took " << comparisons << " comparisons" );
+            }
+        }
+
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+//  The static searchers only take char, so count the reads of the corpus instead
+    class counting_iter : public boost::iterator_adaptor<counting_iter, const char *> {
+    public:
+        counting_iter () {}
+        explicit counting_iter ( const char *p ) : counting_iter::iterator_adaptor_ ( p ) {}
+    private:
+        friend class boost::iterator_core_access;
+        const char &dereference () const { ++comparisons; return *this->base (); }
+        };
+
+    template <std::size_t N>
+    void check_static_linear ( const std::string &corpus_str, const std::string &pattern_str ) {
+        BOOST_REQUIRE_EQUAL ( pattern_str.size () + 1, N );
+        char pattern [ N ] = {};
+        std::copy ( pattern_str.begin (), pattern_str.end (), pattern );
+        const ba::static_boyer_moore<char, N> bm = ba::make_static_boyer_moore ( pattern );
+
+        const counting_iter first ( corpus_str.data ()), last ( corpus_str.data () + corpus_str.size ());
+        comparisons = 0;
+        const std::size_t found = boost::distance ( bm.find_all ( first, last ));
+        BOOST_CHECK ( found > 0 );
+        BOOST_CHECK_MESSAGE ( comparisons <= 3 * corpus_str.size (),
+                "static '" << pattern_str.substr ( 0, 20 ) << "...' (" << pattern_str.size () << " elements) in "
+                << corpus_str.size () << " elements took " << comparisons << " reads" );
+        }
+#endif
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    const std::size_t n = 20000;
+
+//  Without Galil's rule, every match compares the whole pattern
+    check_linear ( std::string ( n, 'a' ), std::string ( 100, 'a' ));
+    check_linear ( std::string ( n, 'a' ), std::string ( 1000, 'a' ));
+    check_linear ( repeat ( "ab", n / 2 ), repeat ( "ab", 200 ));
+    check_linear ( repeat ( "abc", n / 3 ), repeat ( "abc", 300 ));
+    check_linear ( repeat ( "aab", n / 3 ), repeat ( "aab", 100 ) + "aa" );
+
+//  Periodic patterns that almost match
+    check_linear ( std::string ( n, 'a' ), "b" + std::string ( 500, 'a' ));
+    check_linear ( std::string ( n, 'a' ), std::string ( 250, 'a' ) + "b" + std::string ( 250, 'a' ));
+    check_linear ( repeat ( "ab", n / 2 ), repeat ( "ab", 100 ) + "b" + repeat ( "ab", 100 ));
+
+//  The results are the same as before
+    const std::string corpus ( "abababababcababab" );
+    const std::string pattern ( "abab" );
+    ba::boyer_moore<std::string::const_iterator> bm ( pattern.begin (), pattern.end ());
+    typedef ba::search_match_iterator<ba::boyer_moore<std::string::const_iterator>, std::string::const_iterator> match_iter;
+    const boost::iterator_range<match_iter> matches = bm.find_all ( corpus );
+    std::vector<std::size_t> offsets;
+    for ( match_iter it = matches.begin (); it != matches.end (); ++it )
+        offsets.push_back ( *it - corpus.begin ());
+    const std::size_t expected [] = { 0, 2, 4, 6, 11, 13 };
+    BOOST_CHECK_EQUAL_COLLECTIONS ( offsets.begin (), offsets.end (), expected, expected + 6 );
+}
+
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+BOOST_AUTO_TEST_CASE( test_static )
+{
+    const std::size_t n = 20000;
+    check_static_linear<101> ( std::string ( n, 'a' ), std::string ( 100, 'a' ));
+    check_static_linear<401> ( repeat ( "ab", n / 2 ), repeat ( "ab", 200 ));
+    check_static_linear<901> ( repeat ( "abc", n / 3 ), repeat ( "abc", 300 ));
+}
+#endif
@@ -0,0 +1,115 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the case-insensitive searchers
+*/
+
+#include <boost/algorithm/searching/iboyer_moore.hpp>
+#include <boost/algorithm/searching/iboyer_moore_horspool.hpp>
+#include <boost/algorithm/string/find.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::string::const_iterator iter;
+
+//  The answer, from the string algorithms
+    iter expected_match ( const std::string &corpus, const std::string &pattern ) {
+        if ( pattern.empty ()) return corpus.begin ();
+        return ba::ifind_first ( corpus, pattern ).begin ();
+        }
+
+    std::size_t count_matches ( const std::string &corpus, const std::string &pattern ) {
+        std::size_t retVal = 0;
+        for ( std::size_t i = 0; i + pattern.size () <= corpus.size (); ++i )
+            if ( ba::iequals ( corpus.substr ( i, pattern.size ()), pattern ))
+                ++retVal;
+        return retVal;
+        }
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        const iter expected = expected_match ( corpus, pattern );
+        ba::iboyer_moore<iter>          ibm  ( pattern.begin (), pattern.end ());
+        ba::iboyer_moore_horspool<iter> ibmh ( pattern.begin (), pattern.end ());
+        BOOST_CHECK ( ibm  ( corpus.begin (), corpus.end ()) == expected );
+        BOOST_CHECK ( ibmh ( corpus.begin (), corpus.end ()) == expected );
+        BOOST_CHECK ( ibm  ( corpus ) == expected );
+        BOOST_CHECK ( ibmh ( corpus ) == expected );
+
+        BOOST_CHECK ( ba::iboyer_moore_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::iboyer_moore_search ( corpus.begin (), corpus.end (), pattern ) == expected );
+        BOOST_CHECK ( ba::iboyer_moore_search ( corpus, pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::iboyer_moore_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::iboyer_moore_horspool_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::iboyer_moore_horspool_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::make_iboyer_moore ( pattern ) ( corpus ) == expected );
+        BOOST_CHECK ( ba::make_iboyer_moore_horspool ( pattern ) ( corpus ) == expected );
+
+        if ( !pattern.empty ()) {
+            const std::size_t matches = count_matches ( corpus, pattern );
+            BOOST_CHECK_EQUAL ( static_cast<std::size_t> ( boost::distance ( ibm.find_all ( corpus ))),  matches );
+            BOOST_CHECK_EQUAL ( static_cast<std::size_t> ( boost::distance ( ibmh.find_all ( corpus ))), matches );
+            }
+        }
+
+//  Mixed case letters, and some punctuation
+    std::string random_mixed_case ( std::size_t len, int alphabet ) {
+        std::string retVal = random_string ( len, alphabet, '@' );
+        for ( std::size_t i = 0; i < len; ++i )
+            if ( retVal [ i ] == '@' )
+                retVal [ i ] = '-';
+            else if ( std::rand () % 2 )
+                retVal [ i ] = static_cast<char> ( retVal [ i ] - 'A' + 'a' );
+        return retVal;
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_one ( "The Quick Brown Fox", "quick" );
+    check_one ( "The Quick Brown Fox", "QUICK" );
+    check_one ( "The Quick Brown Fox", "fOx" );
+    check_one ( "The Quick Brown Fox", "the" );
+    check_one ( "The Quick Brown Fox", "foxes" );
+    check_one ( "The Quick Brown Fox", "" );
+    check_one ( "", "fox" );
+    check_one ( "AbRaCaDaBrA", "abra" );
+    check_one ( "aAaAaAaA", "AAA" );
+    check_one ( "[a]@[A]", "@[a" );     // '@' and '[' are next to 'A' and 'Z'
+
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 12; ++pat_len )
+        for ( int alphabet = 2; alphabet <= 6; ++alphabet )
+            for ( int i = 0; i < 5; ++i ) {
+                const std::string corpus = random_mixed_case ( 300, alphabet );
+                check_one ( corpus, random_mixed_case ( pat_len, alphabet ));
+                }
+
+//  A pattern long enough for two-byte table entries
+    std::string corpus = random_mixed_case ( 1000, 3 );
+    const std::string pattern = random_mixed_case ( 200, 3 );
+    corpus += pattern;
+    check_one ( corpus, pattern );
+
+//  With an explicit locale
+    const std::string text ( "Hello, World" );
+    const std::string world ( "WORLD" );
+    ba::iboyer_moore<iter> ibm ( world.begin (), world.end (), std::locale::classic ());
+    BOOST_CHECK ( ibm ( text ) == text.begin () + 7 );
+}
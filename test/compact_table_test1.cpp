@@ -0,0 +1,149 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the searchers with patterns on each side of the
+    boundaries between table entry widths
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  A skip table as traits classes wrote them before the tables were
+//  compacted: no view_tag, width () or view ().
+template <typename key_type, typename value_type>
+class map_skip_table {
+public:
+    map_skip_table ( std::size_t, value_type default_value ) : k_default_value ( default_value ) {}
+
+    void insert ( key_type key, value_type val ) { skip_ [ key ] = val; }
+
+    value_type operator [] ( key_type key ) const {
+        typename std::map<key_type, value_type>::const_iterator it = skip_.find ( key );
+        return it == skip_.end () ? k_default_value : it->second;
+        }
+
+    void PrintSkipTable () const {}
+
+private:
+    const value_type k_default_value;
+    std::map<key_type, value_type> skip_;
+    };
+
+template <typename Iter>
+struct map_traits {
+    typedef typename std::iterator_traits<Iter>::difference_type value_type;
+    typedef typename std::iterator_traits<Iter>::value_type key_type;
+    typedef map_skip_table<key_type, value_type> skip_table_t;
+    };
+
+template <typename T>
+void check_custom_traits ( std::size_t pat_len ) {
+    typedef typename std::vector<T>::const_iterator iter;
+    std::vector<T> data;
+    for ( std::size_t i = 0; i < 2000; ++i )
+        data.push_back ( static_cast<T> ( std::rand () % 5 ));
+    const std::vector<T> &corpus = data;
+    const std::vector<T> pattern ( corpus.begin () + 1000, corpus.begin () + 1000 + pat_len );
+
+    const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+    ba::boyer_moore<iter, map_traits<iter> >          bm  ( pattern.begin (), pattern.end ());
+    ba::boyer_moore_horspool<iter, map_traits<iter> > bmh ( pattern.begin (), pattern.end ());
+    BOOST_CHECK ( bm  ( corpus.begin (), corpus.end ()) == expected );
+    BOOST_CHECK ( bmh ( corpus.begin (), corpus.end ()) == expected );
+    }
+
+//  Plant the pattern (and some near misses) in the corpus, and look for it
+    void check_one ( std::size_t pat_len ) {
+        typedef std::string::const_iterator iter;
+        const std::string pattern = random_string ( pat_len, 2 );
+        std::string corpus = random_string ( 3 * pat_len, 2 );
+        corpus += pattern;
+        corpus += pattern.substr ( 0, pat_len / 2 );
+        corpus += pattern;
+        corpus += pattern.substr ( pat_len / 2 );
+
+        const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+        ba::boyer_moore<iter>          bm  ( pattern.begin (), pattern.end ());
+        ba::boyer_moore_horspool<iter> bmh ( pattern.begin (), pattern.end ());
+        ba::knuth_morris_pratt<iter>   kmp ( pattern.begin (), pattern.end ());
+        check_matches ( bm,  corpus, pattern );
+        check_matches ( bmh, corpus, pattern );
+        check_matches ( kmp, corpus, pattern );
+
+    //  Non-byte patterns use the map skip table, and a compact suffix table
+        const std::vector<int> ipattern ( pattern.begin (), pattern.end ());
+        const std::vector<int> icorpus  ( corpus.begin (),  corpus.end ());
+        BOOST_CHECK ( ba::boyer_moore_search ( icorpus, ipattern ) - icorpus.begin () == expected - corpus.begin ());
+        BOOST_CHECK ( ba::knuth_morris_pratt_search ( icorpus, ipattern ) - icorpus.begin () == expected - corpus.begin ());
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_widths )
+{
+    ba::detail::compact_table<std::ptrdiff_t> t8  ( 10, -1, 127 );
+    ba::detail::compact_table<std::ptrdiff_t> t16 ( 10, -1, 128 );
+    ba::detail::compact_table<std::ptrdiff_t> t32 ( 10, -1, 32768 );
+    BOOST_CHECK_EQUAL ( t8.width (),  1U );
+    BOOST_CHECK_EQUAL ( t16.width (), 2U );
+    BOOST_CHECK_EQUAL ( t32.width (), 4U );
+
+    t16.set ( 3, -1 );
+    t16.set ( 4, 128 );
+    BOOST_CHECK_EQUAL ( t16 [ 3 ], -1 );
+    BOOST_CHECK_EQUAL ( t16 [ 4 ], 128 );
+    BOOST_CHECK_EQUAL ( t16.view<boost::int16_t> () [ 4 ], 128 );
+}
+
+BOOST_AUTO_TEST_CASE( test_search )
+{
+    std::srand ( 1 );
+    const std::size_t lengths [] = { 1, 2, 126, 127, 128, 129, 32766, 32767, 32768, 32769 };
+    for ( std::size_t i = 0; i < sizeof ( lengths ) / sizeof ( lengths [ 0 ] ); ++i )
+        check_one ( lengths [ i ] );
+}
+
+BOOST_AUTO_TEST_CASE( test_custom_traits )
+{
+    typedef std::string::const_iterator iter;
+    const std::string corpus ( "The quick brown fox jumped over the lazy dog" );
+    const std::string lazy ( "lazy" ), lazier ( "lazier" );
+
+    ba::boyer_moore<iter, map_traits<iter> >          bm  ( lazy.begin (), lazy.end ());
+    ba::boyer_moore_horspool<iter, map_traits<iter> > bmh ( lazy.begin (), lazy.end ());
+    BOOST_CHECK ( bm  ( corpus.begin (), corpus.end ()) == corpus.begin () + 36 );
+    BOOST_CHECK ( bmh ( corpus.begin (), corpus.end ()) == corpus.begin () + 36 );
+
+    ba::boyer_moore<iter, map_traits<iter> >          bm2  ( lazier.begin (), lazier.end ());
+    ba::boyer_moore_horspool<iter, map_traits<iter> > bmh2 ( lazier.begin (), lazier.end ());
+    BOOST_CHECK ( bm2  ( corpus.begin (), corpus.end ()) == corpus.end ());
+    BOOST_CHECK ( bmh2 ( corpus.begin (), corpus.end ()) == corpus.end ());
+
+    std::srand ( 2 );
+    const std::size_t lengths [] = { 1, 2, 5, 40 };
+    for ( std::size_t i = 0; i < sizeof ( lengths ) / sizeof ( lengths [ 0 ] ); ++i ) {
+        check_custom_traits<int> ( lengths [ i ] );
+        check_custom_traits<boost::uint32_t> ( lengths [ i ] );
+        }
+}
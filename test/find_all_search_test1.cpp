@@ -0,0 +1,65 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the find_all match ranges of the searcher objects
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        typedef std::string::const_iterator iter;
+        ba::boyer_moore<iter>          bm  ( pattern.begin (), pattern.end ());
+        ba::boyer_moore_horspool<iter> bmh ( pattern.begin (), pattern.end ());
+        ba::knuth_morris_pratt<iter>   kmp ( pattern.begin (), pattern.end ());
+        check_matches ( bm,  corpus, pattern );
+        check_matches ( bmh, corpus, pattern );
+        check_matches ( kmp, corpus, pattern );
+
+    //  An empty pattern has no next match either
+        if ( pattern.empty ()) {
+            BOOST_CHECK ( bm.find_next  ( corpus.begin (), corpus.end (), ba::search_overlapping ) == corpus.end ());
+            BOOST_CHECK ( bmh.find_next ( corpus.begin (), corpus.end (), ba::search_overlapping ) == corpus.end ());
+            BOOST_CHECK ( kmp.find_next ( corpus.begin (), corpus.end (), ba::search_overlapping ) == corpus.end ());
+            }
+
+    //  The range interface, and the default (overlapping) mode
+        BOOST_CHECK_EQUAL ( boost::distance ( bm.find_all ( corpus )), naive_count ( corpus, pattern ));
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_one ( "abracadabra", "abra" );
+    check_one ( "abracadabra", "a" );
+    check_one ( "abracadabra", "" );
+    check_one ( "", "abra" );
+    check_one ( "aaaaaaaaaa", "aa" );
+    check_one ( "aaaaaaaaaa", "aaaaaaaaaa" );
+    check_one ( "abababababab", "abab" );
+    check_one ( "abcabcabcabcab", "abcab" );
+
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 10; ++pat_len )
+        for ( int alphabet = 1; alphabet <= 4; ++alphabet )
+            for ( int i = 0; i < 5; ++i )
+                check_one ( random_string ( 300, alphabet ), random_string ( pat_len, alphabet ));
+}
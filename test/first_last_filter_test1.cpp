@@ -0,0 +1,81 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#include <boost/algorithm/searching/first_last_filter.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  Compare against std::search, using pointers (vectorized) and iterators (portable)
+    void check_one ( const std::string &haystack, const std::string &needle ) {
+        const char *hBeg = haystack.data ();
+        const char *hEnd = hBeg + haystack.size ();
+        const char *nBeg = needle.data ();
+        const char *nEnd = nBeg + needle.size ();
+
+        const char *p0 = std::search ( hBeg, hEnd, nBeg, nEnd );
+        const char *p1 = ba::first_last_filter_search ( hBeg, hEnd, nBeg, nEnd );
+        BOOST_CHECK_EQUAL ( p0 - hBeg, p1 - hBeg );
+
+        std::string::const_iterator it0 = std::search ( haystack.begin (), haystack.end (), needle.begin (), needle.end ());
+        std::string::const_iterator it1 = ba::first_last_filter_search ( haystack.begin (), haystack.end (), needle );
+        BOOST_CHECK_EQUAL ( it0 - haystack.begin (), it1 - haystack.begin ());
+
+        const unsigned char *uBeg = reinterpret_cast<const unsigned char *> ( hBeg );
+        const unsigned char *uEnd = reinterpret_cast<const unsigned char *> ( hEnd );
+        const unsigned char *unBeg = reinterpret_cast<const unsigned char *> ( nBeg );
+        const unsigned char *unEnd = reinterpret_cast<const unsigned char *> ( nEnd );
+        ba::first_last_filter<const unsigned char *> flf ( unBeg, unEnd );
+        BOOST_CHECK_EQUAL ( flf ( uBeg, uEnd ) - uBeg, p0 - hBeg );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    std::string haystack1 ( "NOW AN FOWE\220ER ANNMAN THE ANPANMANEND" );
+    check_one ( haystack1, "ANPANMAN" );
+    check_one ( haystack1, "MAN THE" );
+    check_one ( haystack1, "WE\220ER" );
+    check_one ( haystack1, "NOW " );
+    check_one ( haystack1, "NEND" );
+    check_one ( haystack1, "NOT FOUND" );
+    check_one ( haystack1, "N" );
+    check_one ( haystack1, "" );
+    check_one ( "", "ANPANMAN" );
+    check_one ( "ANPANMAN", haystack1 );
+
+//  Put the matches on either side of the 16 and 32 byte block boundaries,
+//  and use a small alphabet so that the filter lets lots of candidates through.
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 70; ++pat_len ) {
+        for ( int alphabet = 2; alphabet <= 16; alphabet *= 2 ) {
+            const std::string needle = random_string ( pat_len, alphabet, '\xF0' );
+            for ( std::size_t corpus_len = 0; corpus_len < 200; corpus_len += 13 ) {
+                std::string haystack = random_string ( corpus_len, alphabet, '\xF0' );
+                check_one ( haystack, needle );
+                for ( std::size_t pos = 0; pos + pat_len <= corpus_len; pos += 7 ) {
+                    std::string planted = haystack;
+                    std::copy ( needle.begin (), needle.end (), planted.begin () + pos );
+                    check_one ( planted, needle );
+                    }
+                }
+            }
+        }
+}
@@ -0,0 +1,131 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the hashed Boyer-Moore-Horspool searcher, on tokens
+*/
+
+#include <boost/algorithm/searching/hashed_boyer_moore_horspool.hpp>
+#include <boost/functional/hash.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::vector<std::string> tokens;
+    typedef tokens::const_iterator iter;
+
+//  Counts the calls, per element, so that the test can check that no element is hashed twice
+    struct counting_hash {
+        explicit counting_hash ( std::vector<int> *calls = 0, const std::string *base = 0, bool collide = false )
+            : calls_ ( calls ), base_ ( base ), collide_ ( collide ) {}
+        std::size_t operator () ( const std::string &s ) const {
+            if ( calls_ != 0 && &s >= base_ && &s < base_ + calls_->size ())
+                ++(*calls_) [ &s - base_ ];
+            return collide_ ? 42 : boost::hash<std::string> () ( s );
+            }
+        std::vector<int> *calls_;
+        const std::string *base_;
+        bool collide_;
+        };
+
+    struct collect {
+        collect ( const tokens &corpus, std::vector<std::ptrdiff_t> &out ) : corpus_ ( &corpus ), out_ ( &out ) {}
+        void operator () ( iter pos ) const { out_->push_back ( pos - corpus_->begin ()); }
+        const tokens *corpus_;
+        std::vector<std::ptrdiff_t> *out_;
+        };
+
+    tokens random_tokens ( std::size_t len, int vocabulary ) {
+        static const char *words [] = { "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog" };
+        tokens retVal;
+        for ( std::size_t i = 0; i < len; ++i )
+            retVal.push_back ( words [ std::rand () % vocabulary ] );
+        return retVal;
+        }
+
+    std::vector<std::ptrdiff_t> expected_matches ( const tokens &corpus, const tokens &pattern, ba::search_overlap_mode mode ) {
+        std::vector<std::ptrdiff_t> retVal;
+        if ( pattern.empty ()) return retVal;
+        for ( iter it = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+                it != corpus.end ();
+                it = std::search ( it + ( mode == ba::search_overlapping ? 1 : pattern.size ()), corpus.end (), pattern.begin (), pattern.end ())) {
+            retVal.push_back ( it - corpus.begin ());
+            if ( static_cast<std::size_t> ( corpus.end () - it ) < pattern.size () + ( mode == ba::search_overlapping ? 1 : pattern.size ()))
+                break;
+            }
+        return retVal;
+        }
+
+    void check_one ( const tokens &corpus, const tokens &pattern, bool collide = false ) {
+        const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+        const iter expected_first = corpus.empty () ? corpus.end () : expected;
+
+        std::vector<int> calls ( corpus.size (), 0 );
+        const counting_hash hash ( &calls, corpus.empty () ? 0 : &corpus [ 0 ], collide );
+        const ba::hashed_boyer_moore_horspool<iter, counting_hash> hbmh ( pattern.begin (), pattern.end (), hash );
+        BOOST_CHECK ( hbmh ( corpus.begin (), corpus.end ()) == expected_first );
+        BOOST_CHECK ( calls.empty () || *std::max_element ( calls.begin (), calls.end ()) <= 1);
+        BOOST_CHECK ( hbmh ( corpus ) == expected_first );
+
+        if ( !collide ) {
+            BOOST_CHECK ( ba::hashed_boyer_moore_horspool_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected_first );
+            BOOST_CHECK ( ba::hashed_boyer_moore_horspool_search ( corpus.begin (), corpus.end (), pattern ) == expected_first );
+            BOOST_CHECK ( ba::hashed_boyer_moore_horspool_search ( corpus, pattern.begin (), pattern.end ()) == expected_first );
+            BOOST_CHECK ( ba::hashed_boyer_moore_horspool_search ( corpus, pattern ) == expected_first );
+            BOOST_CHECK ( ba::make_hashed_boyer_moore_horspool ( pattern ) ( corpus ) == expected_first );
+            }
+
+        for ( int m = 0; m < 2; ++m ) {
+            const ba::search_overlap_mode mode = m == 0 ? ba::search_overlapping : ba::search_non_overlapping;
+            const std::vector<std::ptrdiff_t> all = expected_matches ( corpus, pattern, mode );
+
+        //  One pass, each element hashed at most once
+            std::fill ( calls.begin (), calls.end (), 0 );
+            std::vector<std::ptrdiff_t> found;
+            hbmh.for_each_match ( corpus, collect ( corpus, found ), mode );
+            BOOST_CHECK ( found == all );
+            if ( !calls.empty ())
+                BOOST_CHECK ( *std::max_element ( calls.begin (), calls.end ()) <= 1 );
+
+            BOOST_CHECK_EQUAL ( static_cast<std::size_t> ( boost::distance ( hbmh.find_all ( corpus, mode ))), all.size ());
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    const tokens empty;
+    tokens one ( 1, "fox" );
+    check_one ( empty, empty );
+    check_one ( empty, one );
+    check_one ( one, empty );
+    check_one ( one, tokens ( one ));
+
+    std::srand ( 1 );
+    for ( int vocabulary = 2; vocabulary <= 8; vocabulary += 3 )
+        for ( std::size_t len = 1; len <= 20; len += 3 )
+            for ( int i = 0; i < 5; ++i ) {
+                const tokens corpus = random_tokens ( 1000, vocabulary );
+                check_one ( corpus, random_tokens ( len, vocabulary ));
+                const std::size_t start = std::rand () % ( corpus.size () - len );
+                check_one ( corpus, tokens ( corpus.begin () + start, corpus.begin () + start + len ));
+                }
+
+//  Every hash the same: the shifts are all 1, but the answers are still right
+    const tokens corpus = random_tokens ( 300, 3 );
+    check_one ( corpus, tokens ( corpus.begin () + 100, corpus.begin () + 105 ), true );
+    check_one ( corpus, random_tokens ( 4, 3 ), true );
+}
@@ -0,0 +1,102 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the Knuth-Morris-Pratt searcher compiled to an automaton
+*/
+
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt_dfa.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::string::const_iterator iter;
+    typedef std::vector<boost::uintmax_t> offsets;
+
+    struct collect_offsets {
+        explicit collect_offsets ( offsets &out ) : out_ ( &out ) {}
+        void operator () ( boost::uintmax_t off ) { out_->push_back ( off ); }
+        offsets *out_;
+        };
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+        ba::knuth_morris_pratt<iter>     kmp ( pattern.begin (), pattern.end ());
+        ba::knuth_morris_pratt_dfa<iter> dfa ( pattern.begin (), pattern.end ());
+
+        check_matches ( dfa, corpus, pattern );
+        BOOST_CHECK ( ba::knuth_morris_pratt_dfa_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::knuth_morris_pratt_dfa_search ( corpus.begin (), corpus.end (), pattern ) == expected );
+        BOOST_CHECK ( ba::knuth_morris_pratt_dfa_search ( corpus, pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::knuth_morris_pratt_dfa_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::make_knuth_morris_pratt_dfa ( pattern ) ( corpus ) == expected );
+
+    //  The same matches as the table-driven searcher, in both modes
+        for ( int m = 0; m < 2; ++m ) {
+            const ba::search_overlap_mode mode = m == 0 ? ba::search_overlapping : ba::search_non_overlapping;
+            BOOST_CHECK ( match_positions ( corpus, dfa.find_all ( corpus, mode )) ==
+                          match_positions ( corpus, kmp.find_all ( corpus, mode )));
+            }
+
+    //  Push the corpus in random pieces, read through input iterators
+        if ( !pattern.empty ()) {
+            ba::knuth_morris_pratt_dfa_session<iter> session ( dfa );
+            offsets found;
+            std::size_t start = 0;
+            while ( start < corpus.size ()) {
+                const std::size_t stop = (std::min) ( corpus.size (), start + std::rand () % 7 );
+                std::istringstream chunk ( corpus.substr ( start, stop - start ));
+                session.push ( std::istreambuf_iterator<char> ( chunk ), std::istreambuf_iterator<char> (),
+                               collect_offsets ( found ));
+                start = stop;
+                }
+            const positions from_kmp = match_positions ( corpus, kmp.find_all ( corpus ));
+            BOOST_CHECK ( found == offsets ( from_kmp.begin (), from_kmp.end ()));
+            BOOST_CHECK_EQUAL ( session.offset (), corpus.size ());
+            session.reset ();
+            BOOST_CHECK_EQUAL ( session.offset (), 0U );
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_one ( "abracadabra", "abra" );
+    check_one ( "abracadabra", "cad" );
+    check_one ( "abracadabra", "cat" );
+    check_one ( "abracadabra", "" );
+    check_one ( "", "abra" );
+    check_one ( "aaaaaaaaaaaaaaaaaaaaaaaaaaaab", "aaaab" );
+    check_one ( "abababababababababc", "ababc" );
+
+//  Bytes outside of the ASCII range
+    check_one ( std::string ( "\x01\xff\x80\xff\x80\x7f", 6 ), std::string ( "\xff\x80\x7f", 3 ));
+
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 20; ++pat_len )
+        for ( int alphabet = 1; alphabet <= 4; ++alphabet )
+            for ( int i = 0; i < 5; ++i )
+                check_one ( random_string ( 300, alphabet ), random_string ( pat_len, alphabet ));
+
+//  Long enough for two-byte states
+    const std::string pattern = random_string ( 300, 2 );
+    check_one ( random_string ( 2000, 2 ) + pattern + pattern.substr ( 0, 150 ) + pattern, pattern );
+}
@@ -0,0 +1,217 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the searchers for masked (wildcard) byte patterns
+*/
+
+#include <boost/algorithm/searching/masked_search.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <boost/range/size.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::vector<std::pair<std::size_t, std::size_t> > match_list;
+
+    std::vector<unsigned char> random_bytes ( std::size_t len, int alphabet ) {
+        std::vector<unsigned char> retVal ( len );
+        for ( std::size_t i = 0; i < len; ++i )
+            retVal [ i ] = static_cast<unsigned char> ( 0x40 + std::rand () % alphabet );
+        return retVal;
+        }
+
+//  A pattern cut from the corpus, with some bits or bytes masked out
+    ba::masked_pattern random_pattern ( const std::vector<unsigned char> &corpus, std::size_t len ) {
+        static const unsigned char masks [] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xF0, 0x0F, 0x00 };
+        const std::size_t start = std::rand () % ( corpus.size () - len + 1 );
+        ba::masked_pattern retVal;
+        for ( std::size_t j = 0; j < len; ++j )
+            retVal.push_back ( corpus [ start + j ], masks [ std::rand () % 7 ] );
+        return retVal;
+        }
+
+    bool matches_at ( const std::vector<unsigned char> &corpus, std::size_t pos, const ba::masked_pattern &p ) {
+        if ( pos + p.size () > corpus.size ()) return false;
+        for ( std::size_t j = 0; j < p.size (); ++j )
+            if ( !p.matches ( j, corpus [ pos + j ] ))
+                return false;
+        return true;
+        }
+
+    std::size_t naive_search ( const std::vector<unsigned char> &corpus, const ba::masked_pattern &p ) {
+        for ( std::size_t pos = 0; pos + p.size () <= corpus.size (); ++pos )
+            if ( matches_at ( corpus, pos, p ))
+                return pos;
+        return corpus.size ();
+        }
+
+    struct collect {
+        collect ( const unsigned char *base, match_list &out ) : base_ ( base ), out_ ( &out ) {}
+        template <typename Iter>
+        void operator () ( std::size_t id, Iter pos ) const {
+            out_->push_back ( std::make_pair ( static_cast<std::size_t> ( &*pos - base_ ), id ));
+            }
+        const unsigned char *base_;
+        match_list *out_;
+        };
+
+    struct count_matches {
+        count_matches ( std::size_t &count ) : count_ ( &count ) {}
+        template <typename Iter>
+        void operator () ( std::size_t, Iter ) const { ++*count_; }
+        std::size_t *count_;
+        };
+
+    void check_one ( const std::vector<unsigned char> &corpus, const ba::masked_pattern &p ) {
+        const std::size_t expected = naive_search ( corpus, p );
+        const ba::masked_searcher ms ( p );
+        const unsigned char *first = corpus.empty () ? 0 : &corpus [ 0 ];
+        const unsigned char *last  = first + corpus.size ();
+
+    //  Pointers take the vectorized path; iterators don't
+        BOOST_CHECK_EQUAL ( ms ( first, last ) - first, static_cast<std::ptrdiff_t> ( expected ));
+        BOOST_CHECK_EQUAL ( ms ( corpus.begin (), corpus.end ()) - corpus.begin (), static_cast<std::ptrdiff_t> ( expected ));
+        BOOST_CHECK_EQUAL ( ba::masked_search ( corpus, p ) - corpus.begin (), static_cast<std::ptrdiff_t> ( expected ));
+
+        std::size_t count = 0;
+        for ( std::size_t pos = 0; pos < corpus.size (); ++pos )
+            count += matches_at ( corpus, pos, p ) ? 1 : 0;
+        BOOST_CHECK_EQUAL ( static_cast<std::size_t> ( boost::size ( ms.find_all ( first, last ))), count );
+        }
+
+    void check_set ( const std::vector<unsigned char> &corpus, const std::vector<ba::masked_pattern> &patterns ) {
+        match_list expected;
+        for ( std::size_t pos = 0; pos < corpus.size (); ++pos )
+            for ( std::size_t id = 0; id < patterns.size (); ++id )
+                if ( matches_at ( corpus, pos, patterns [ id ] ))
+                    expected.push_back ( std::make_pair ( pos, id ));
+
+        const ba::masked_multi_searcher mms = ba::make_masked_multi_searcher ( patterns );
+        BOOST_CHECK_EQUAL ( mms.pattern_count (), patterns.size ());
+        const unsigned char *first = &corpus [ 0 ];
+        const unsigned char *last  = first + corpus.size ();
+
+        match_list found;
+        mms.for_each_match ( first, last, collect ( first, found ));
+        BOOST_CHECK ( found == expected );
+
+        match_list found_iter;
+        mms.for_each_match ( corpus, collect ( first, found_iter ));
+        BOOST_CHECK ( found_iter == expected );
+
+        const std::pair<const unsigned char *, std::size_t> leftmost = mms ( first, last );
+        if ( expected.empty ()) {
+            BOOST_CHECK ( leftmost.first == last );
+            BOOST_CHECK_EQUAL ( leftmost.second, ba::masked_multi_searcher::npos );
+            }
+        else {
+            BOOST_CHECK_EQUAL ( static_cast<std::size_t> ( leftmost.first - first ), expected [ 0 ].first );
+            BOOST_CHECK_EQUAL ( leftmost.second, expected [ 0 ].second );
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_parse )
+{
+    const ba::masked_pattern p ( "4D 5A ?? ? 5? ?E" );
+    BOOST_CHECK_EQUAL ( p.size (), 6U );
+    BOOST_CHECK_EQUAL ( p.value ( 0 ), 0x4D ); BOOST_CHECK_EQUAL ( p.mask ( 0 ), 0xFF );
+    BOOST_CHECK_EQUAL ( p.value ( 1 ), 0x5A ); BOOST_CHECK_EQUAL ( p.mask ( 1 ), 0xFF );
+    BOOST_CHECK_EQUAL ( p.mask ( 2 ), 0x00 );
+    BOOST_CHECK_EQUAL ( p.mask ( 3 ), 0x00 );
+    BOOST_CHECK_EQUAL ( p.value ( 4 ), 0x50 ); BOOST_CHECK_EQUAL ( p.mask ( 4 ), 0xF0 );
+    BOOST_CHECK_EQUAL ( p.value ( 5 ), 0x0E ); BOOST_CHECK_EQUAL ( p.mask ( 5 ), 0x0F );
+
+    BOOST_CHECK_EQUAL ( ba::masked_pattern ( std::string ( "4d5a??50" )).size (), 4U );
+    BOOST_CHECK ( ba::masked_pattern ( "" ).empty ());
+    BOOST_CHECK_THROW ( ba::masked_pattern ( "4D 5" ),  std::invalid_argument );
+    BOOST_CHECK_THROW ( ba::masked_pattern ( "4G" ),    std::invalid_argument );
+    BOOST_CHECK_THROW ( ba::masked_pattern ( "4D5A5" ), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( test_signatures )
+{
+    const std::string file ( "junk MZ\x90\x00\x03\x00PE more junk PE\x00\x00", 28 );
+    const ba::masked_pattern mz ( "4D 5A ?? ?? 03 ?? 50 45" );
+    BOOST_CHECK_EQUAL ( ba::masked_search ( file, mz ) - file.begin (), 5 );
+    BOOST_CHECK ( ba::masked_search ( file, ba::masked_pattern ( "4D 5A ?? ?? 04" )) == file.end ());
+    BOOST_CHECK ( ba::masked_search ( file, ba::masked_pattern ()) == file.begin ());
+
+//  A trailing wildcard doesn't reach past the end of the corpus
+    BOOST_CHECK_EQUAL ( ba::masked_search ( file, ba::masked_pattern ( "50 45 ?? 00" )) - file.begin (), 24 );
+    BOOST_CHECK ( ba::masked_search ( file, ba::masked_pattern ( "50 45 00 00 ??" )) == file.end ());
+
+    std::vector<ba::masked_pattern> sigs;
+    sigs.push_back ( ba::masked_pattern ( "50 45 00 00" ));     // 0
+    sigs.push_back ( mz );                                      // 1
+    sigs.push_back ( ba::masked_pattern ( "6? 6F" ));           // 2 -- one concrete byte
+    sigs.push_back ( ba::masked_pattern ( "?? 4? ?A" ));        // 3 -- no concrete bytes
+    const std::pair<std::string::const_iterator, std::size_t> first = ba::masked_multi_search ( file, sigs );
+    BOOST_CHECK_EQUAL ( first.first - file.begin (), 4 );
+    BOOST_CHECK_EQUAL ( first.second, 3U );
+
+    std::vector<unsigned char> bytes ( file.begin (), file.end ());
+    check_set ( bytes, sigs );
+
+    sigs.push_back ( ba::masked_pattern ());
+    BOOST_CHECK_THROW ( ba::masked_multi_searcher ( sigs.begin (), sigs.end ()), std::invalid_argument );
+}
+
+BOOST_AUTO_TEST_CASE( test_random )
+{
+    std::srand ( 1234 );
+    for ( int round = 0; round < 200; ++round ) {
+        const std::vector<unsigned char> corpus = random_bytes ( 1 + std::rand () % 2000, 1 + std::rand () % 16 );
+        const std::size_t len = 1 + std::rand () % ( std::min ) ( corpus.size (), std::size_t ( 70 ));
+        check_one ( corpus, random_pattern ( corpus, len ));
+    //  And one that is (probably) not there
+        ba::masked_pattern absent = random_pattern ( corpus, len );
+        absent.push_back ( 0x3F );
+        check_one ( corpus, absent );
+        }
+
+    for ( int round = 0; round < 50; ++round ) {
+        const std::vector<unsigned char> corpus = random_bytes ( 100 + std::rand () % 5000, 2 + std::rand () % 8 );
+        std::vector<ba::masked_pattern> patterns;
+        const int count = 1 + std::rand () % 40;
+        for ( int i = 0; i < count; ++i )
+            patterns.push_back ( random_pattern ( corpus, 1 + std::rand () % 40 ));
+        check_set ( corpus, patterns );
+        }
+}
+
+BOOST_AUTO_TEST_CASE( test_dense_matches )
+{
+//  Every position matches; the pending matches must not pile up
+    const std::vector<unsigned char> corpus ( 1 << 20, 0x41 );
+    std::vector<ba::masked_pattern> sigs;
+    sigs.push_back ( ba::masked_pattern ( "?? ?? ?? 41 41" ));
+    sigs.push_back ( ba::masked_pattern ( "??" ));
+    const ba::masked_multi_searcher mms = ba::make_masked_multi_searcher ( sigs );
+
+    std::size_t count = 0;
+    ba::masked_multi_searcher::pending_matches pending;
+    mms.for_each_match ( &corpus [ 0 ], &corpus [ 0 ] + corpus.size (), count_matches ( count ), pending );
+    BOOST_CHECK_EQUAL ( count, 2 * corpus.size () - 4 );
+    BOOST_CHECK_LT ( pending.capacity (), 64U );
+
+//  The buffer is reused
+    count = 0;
+    mms.for_each_match ( &corpus [ 0 ], &corpus [ 0 ] + corpus.size (), count_matches ( count ), pending );
+    BOOST_CHECK_EQUAL ( count, 2 * corpus.size () - 4 );
+}
@@ -0,0 +1,110 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the searcher for 2-bit packed DNA
+*/
+
+#include <boost/algorithm/searching/packed_dna_search.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <cctype>
+#include <string>
+#include <vector>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    std::string random_dna ( std::size_t len, int alphabet = 4 ) {
+        std::string retVal ( len, 'A' );
+        for ( std::size_t i = 0; i < len; ++i )
+            retVal [ i ] = "ACGT" [ std::rand () % alphabet ];
+        return retVal;
+        }
+
+    std::vector<std::size_t> expected_matches ( const std::string &corpus, const std::string &pattern ) {
+        std::vector<std::size_t> retVal;
+        if ( pattern.empty ()) return retVal;
+        for ( std::size_t pos = corpus.find ( pattern ); pos != std::string::npos; pos = corpus.find ( pattern, pos + 1 ))
+            retVal.push_back ( pos );
+        return retVal;
+        }
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        const ba::packed_dna_sequence packed ( corpus.begin (), corpus.end ());
+        const std::vector<std::size_t> expected = expected_matches ( corpus, pattern );
+        const std::size_t first = pattern.empty () ? 0
+                                : ( expected.empty () ? corpus.size () : expected [ 0 ] );
+
+        const ba::packed_dna_searcher pds ( pattern.begin (), pattern.end ());
+        BOOST_CHECK_EQUAL ( pds ( packed.begin (), packed.end ()).position (), first );
+        BOOST_CHECK_EQUAL ( pds ( packed ).position (), first );
+        BOOST_CHECK_EQUAL ( ba::packed_dna_search ( packed.begin (), packed.end (), pattern.begin (), pattern.end ()).position (), first );
+        BOOST_CHECK_EQUAL ( ba::packed_dna_search ( packed, pattern ).position (), first );
+
+    //  A packed pattern
+        const ba::packed_dna_sequence packed_pattern ( pattern.begin (), pattern.end ());
+        BOOST_CHECK_EQUAL ( ba::make_packed_dna_searcher ( packed_pattern ) ( packed ).position (), first );
+
+        std::vector<std::size_t> found;
+        typedef boost::iterator_range<ba::search_match_iterator<ba::packed_dna_searcher, ba::packed_dna_iterator> > matches;
+        const matches all = pds.find_all ( packed );
+        for ( matches::iterator it = all.begin (); it != all.end (); ++it )
+            found.push_back ( it->position ());
+        BOOST_CHECK ( found == expected );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+//  Packing and unpacking
+    const std::string text ( "ACGTacgtTTGCA" );
+    const ba::packed_dna_sequence seq ( text.begin (), text.end ());
+    BOOST_CHECK_EQUAL ( seq.size (), text.size ());
+    BOOST_CHECK_EQUAL ( seq.word_count (), 1U );
+    for ( std::size_t i = 0; i < text.size (); ++i )
+        BOOST_CHECK_EQUAL ( ba::dna_letter ( seq [ i ] ), std::toupper ( text [ i ] ));
+    BOOST_CHECK_EQUAL ( seq.end () - seq.begin (), 13 );
+    BOOST_CHECK_EQUAL ( seq.data () [ 0 ], 0x1E4E4U | ( 3U << 16 ) | ( 3U << 18 ) | ( 2U << 20 ) | ( 1U << 22 ));
+    const std::string bad ( "ACGN" );
+    BOOST_CHECK_THROW ( ba::packed_dna_sequence ( bad.begin (), bad.end ()), std::invalid_argument );
+
+    check_one ( "", "" );
+    check_one ( "", "ACG" );
+    check_one ( "ACGT", "" );
+    check_one ( "ACGT", "ACGT" );
+    check_one ( "ACGT", "ACGTA" );
+    check_one ( "AAAAAAAAAA", "AAA" );
+    check_one ( "GATTACAGATTACA", "TTACA" );
+    check_one ( "GATTACAGATTACA", "T" );
+
+    std::srand ( 1 );
+    const std::size_t lengths [] = { 1, 2, 3, 5, 8, 16, 31, 32, 33, 63, 64, 65, 100, 200 };
+    for ( std::size_t l = 0; l < sizeof ( lengths ) / sizeof ( lengths [ 0 ] ); ++l )
+        for ( int alphabet = 2; alphabet <= 4; ++alphabet )
+            for ( int i = 0; i < 3; ++i ) {
+                const std::string corpus = random_dna ( 3000, alphabet );
+                check_one ( corpus, random_dna ( lengths [ l ], alphabet ));
+                check_one ( corpus, corpus.substr ( std::rand () % ( corpus.size () - lengths [ l ] ), lengths [ l ] ));
+                check_one ( corpus + random_dna ( lengths [ l ] % 7 ), corpus.substr ( corpus.size () - lengths [ l ] ));
+                }
+
+//  Words that someone else packed, and a range that starts in the middle of a word
+    const std::string corpus = random_dna ( 1000 );
+    const ba::packed_dna_sequence packed ( corpus.begin (), corpus.end ());
+    const ba::packed_dna_range range = ba::make_packed_dna_range ( packed.data (), packed.size ());
+    const std::string pattern = corpus.substr ( 517, 40 );
+    BOOST_CHECK_EQUAL ( ba::packed_dna_search ( range, pattern ).position (), corpus.find ( pattern ));
+    const ba::packed_dna_iterator middle ( packed.data (), 301 );
+    BOOST_CHECK_EQUAL ( ba::packed_dna_search ( middle, range.end (), pattern.begin (), pattern.end ()).position (), corpus.find ( pattern, 301 ));
+    BOOST_CHECK ( ba::packed_dna_search ( middle, ba::packed_dna_iterator ( packed.data (), 550 ), pattern.begin (), pattern.end ())
+                    == ba::packed_dna_iterator ( packed.data (), 550 ));
+}
@@ -0,0 +1,76 @@
+/* 
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the parallel searching interfaces
+*/
+
+#include <boost/algorithm/searching/parallel_search.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    void check_one ( const std::string &haystack, const std::string &needle, const ba::parallel_search_policy &policy ) {
+        typedef std::string::const_iterator iter;
+        const iter hBeg = haystack.begin (), hEnd = haystack.end ();
+        const iter nBeg = needle.begin (),   nEnd = needle.end ();
+        const std::ptrdiff_t expected = std::search ( hBeg, hEnd, nBeg, nEnd ) - hBeg;
+
+        BOOST_CHECK_EQUAL ( ba::boyer_moore_search          ( policy, hBeg, hEnd, nBeg, nEnd ) - hBeg, expected );
+        BOOST_CHECK_EQUAL ( ba::boyer_moore_horspool_search ( policy, hBeg, hEnd, nBeg, nEnd ) - hBeg, expected );
+        BOOST_CHECK_EQUAL ( ba::knuth_morris_pratt_search   ( policy, hBeg, hEnd, nBeg, nEnd ) - hBeg, expected );
+        BOOST_CHECK_EQUAL ( ba::boyer_moore_search          ( policy, haystack, needle ) - hBeg, expected );
+        BOOST_CHECK_EQUAL ( ba::boyer_moore_horspool_search ( policy, haystack, needle ) - hBeg, expected );
+        BOOST_CHECK_EQUAL ( ba::knuth_morris_pratt_search   ( policy, haystack, needle ) - hBeg, expected );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+//  Tiny slices and blocks, so that every boundary case gets exercised
+    const ba::parallel_search_policy policy ( 4, 16, 8 );
+
+    std::string haystack ( 1000, 'a' );
+    check_one ( haystack, "b", policy );
+    check_one ( haystack, "aaa", policy );
+    check_one ( haystack, "", policy );
+    check_one ( "", "aaa", policy );
+    check_one ( haystack, haystack, policy );
+    check_one ( haystack, haystack + "a", policy );
+
+//  A match at every place, including straddling each slice boundary
+    const std::string needle ( "abcdefg" );
+    for ( std::size_t pos = 0; pos + needle.size () <= haystack.size (); ++pos ) {
+        std::string planted = haystack;
+        std::copy ( needle.begin (), needle.end (), planted.begin () + pos );
+        check_one ( planted, needle, policy );
+        }
+
+//  Several matches; the leftmost one has to win, whichever thread finds its match first
+    std::srand ( 1 );
+    for ( int i = 0; i < 200; ++i ) {
+        std::string planted = haystack;
+        for ( int j = 0; j < 3; ++j ) {
+            const std::size_t pos = std::rand () % ( haystack.size () - needle.size ());
+            std::copy ( needle.begin (), needle.end (), planted.begin () + pos );
+            }
+        check_one ( planted, needle, policy );
+        check_one ( planted, needle, ba::parallel_search_policy ( 3, 100, 1000 ));
+        }
+
+//  The default policy; a corpus this size is searched sequentially
+    check_one ( haystack + needle, needle, ba::parallel_search_policy ());
+}
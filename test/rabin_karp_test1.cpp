@@ -0,0 +1,210 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the Rabin-Karp searcher, and content-defined chunking
+*/
+
+#include <boost/algorithm/searching/rabin_karp.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::string::const_iterator iter;
+    typedef std::vector<std::pair<std::size_t, std::ptrdiff_t> > match_list;
+
+    struct collect {
+        collect ( const std::string &corpus, match_list &out ) : corpus_ ( &corpus ), out_ ( &out ) {}
+        void operator () ( std::size_t id, iter pos ) const {
+            out_->push_back ( std::make_pair ( id, pos - corpus_->begin ()));
+            }
+        const std::string *corpus_;
+        match_list *out_;
+        };
+
+//  The answer, by brute force: by position, then by id
+    match_list expected_matches ( const std::string &corpus, const std::vector<std::string> &patterns ) {
+        match_list retVal;
+        if ( patterns.empty () || patterns [ 0 ].empty ()) return retVal;
+        const std::size_t m = patterns [ 0 ].size ();
+        for ( std::size_t pos = 0; pos + m <= corpus.size (); ++pos )
+            for ( std::size_t id = 0; id < patterns.size (); ++id )
+                if ( corpus.compare ( pos, m, patterns [ id ] ) == 0 )
+                    retVal.push_back ( std::make_pair ( id, static_cast<std::ptrdiff_t> ( pos )));
+        return retVal;
+        }
+
+    void check_one ( const std::string &corpus, const std::vector<std::string> &patterns ) {
+        const match_list expected = expected_matches ( corpus, patterns );
+        const ba::rabin_karp<iter> rk = ba::make_rabin_karp ( patterns );
+        BOOST_CHECK_EQUAL ( rk.pattern_count (), patterns.size ());
+
+        match_list found;
+        rk.for_each_match ( corpus.begin (), corpus.end (), collect ( corpus, found ));
+        BOOST_CHECK ( found == expected );
+
+        const std::pair<iter, std::size_t> first = rk ( corpus );
+        const std::pair<iter, std::size_t> first2 = ba::rabin_karp_search ( corpus.begin (), corpus.end (), patterns );
+        BOOST_CHECK ( first == first2 );
+        BOOST_CHECK ( ba::rabin_karp_search ( corpus, patterns ) == first );
+        if ( expected.empty ()) {
+            BOOST_CHECK ( first.first == corpus.end ());
+            BOOST_CHECK_EQUAL ( first.second, ba::rabin_karp<iter>::npos );
+            }
+        else {
+            BOOST_CHECK_EQUAL ( first.first - corpus.begin (), expected [ 0 ].second );
+            BOOST_CHECK_EQUAL ( first.second, expected [ 0 ].first );
+            }
+        }
+
+    struct chunk_list {
+        explicit chunk_list ( std::vector<std::pair<std::string, boost::uint64_t> > &out ) : out_ ( &out ) {}
+        void operator () ( iter first, iter last, boost::uint64_t fingerprint ) const {
+            out_->push_back ( std::make_pair ( std::string ( first, last ), fingerprint ));
+            }
+        std::vector<std::pair<std::string, boost::uint64_t> > *out_;
+        };
+
+    void check_chunks () {
+        typedef std::vector<std::pair<std::string, boost::uint64_t> > chunks;
+        const ba::rabin_karp_chunking params ( 16, 256, 64, 1024 );
+        const std::string data = random_string ( 100000, 26 );
+        chunks before;
+        ba::rabin_karp_chunks ( data, params, chunk_list ( before ));
+
+    //  The chunks cover the data, within the size limits, with the right fingerprints
+        std::string joined;
+        for ( std::size_t i = 0; i < before.size (); ++i ) {
+            joined += before [ i ].first;
+            BOOST_CHECK ( before [ i ].first.size () <= params.max_size );
+            if ( i + 1 < before.size ())
+                BOOST_CHECK ( before [ i ].first.size () >= params.min_size );
+            BOOST_CHECK_EQUAL ( before [ i ].second, ba::rabin_karp_fingerprint ( before [ i ].first.begin (), before [ i ].first.end ()));
+            }
+        BOOST_CHECK ( joined == data );
+    //  About the right number of chunks (average of 64 + 256)
+        BOOST_CHECK ( before.size () > 100000 / 1024 && before.size () < 100000 / 128 );
+
+    //  An insertion near the start changes only the chunks near it
+        chunks after;
+        ba::rabin_karp_chunks ( data.substr ( 0, 500 ) + "INSERTED" + data.substr ( 500 ), params, chunk_list ( after ));
+        std::size_t same = 0;
+        for ( std::size_t i = 0; i < after.size (); ++i )
+            for ( std::size_t j = 0; j < before.size (); ++j )
+                if ( after [ i ] == before [ j ] ) {
+                    ++same;
+                    break;
+                    }
+        BOOST_CHECK ( same + 4 >= before.size ());
+
+    //  Fixed-size chunks, when no cut point is ever found
+        const std::string same_bytes ( 5000, 'x' );
+        chunks fixed;
+        ba::rabin_karp_chunks ( same_bytes.begin (), same_bytes.end (), params, chunk_list ( fixed ));
+        BOOST_CHECK_EQUAL ( fixed.size (), 5U );
+        BOOST_CHECK_EQUAL ( fixed.back ().first.size (), 5000U - 4 * 1024 );
+
+        chunks none;
+        ba::rabin_karp_chunks ( std::string (), params, chunk_list ( none ));
+        BOOST_CHECK ( none.empty ());
+
+        BOOST_CHECK_THROW ( ba::rabin_karp_chunks ( data, ba::rabin_karp_chunking ( 16, 100 ), chunk_list ( none )), std::invalid_argument );
+        BOOST_CHECK_THROW ( ba::rabin_karp_chunks ( data, ba::rabin_karp_chunking ( 0 ), chunk_list ( none )), std::invalid_argument );
+        BOOST_CHECK_THROW ( ba::rabin_karp_chunks ( data, ba::rabin_karp_chunking ( 16, 256, 512, 256 ), chunk_list ( none )), std::invalid_argument );
+        BOOST_CHECK_THROW ( ba::rabin_karp_chunks ( data, ba::rabin_karp_chunking ( 16, 1 ), chunk_list ( none )), std::invalid_argument );
+        const std::size_t huge = ~std::size_t ( 0 );
+        BOOST_CHECK_THROW ( ba::rabin_karp_chunks ( data, ba::rabin_karp_chunking ( 16, huge, 0, huge ), chunk_list ( none )), std::invalid_argument );
+    //  The largest power of two is accepted (and so never cuts on the hash)
+        chunks one;
+        ba::rabin_karp_chunks ( data, ba::rabin_karp_chunking ( 16, huge / 2 + 1, 0, huge ), chunk_list ( one ));
+        BOOST_CHECK_EQUAL ( one.size (), 1U );
+
+    //  The seed changes the fingerprints, but not the cut points
+        const ba::rabin_karp_chunking seeded ( 16, 256, 64, 1024, 12345 );
+        chunks reseeded;
+        ba::rabin_karp_chunks ( data, seeded, chunk_list ( reseeded ));
+        BOOST_REQUIRE_EQUAL ( reseeded.size (), before.size ());
+        for ( std::size_t i = 0; i < before.size (); ++i ) {
+            BOOST_CHECK ( reseeded [ i ].first == before [ i ].first );
+            BOOST_CHECK_EQUAL ( reseeded [ i ].second, ba::rabin_karp_fingerprint ( before [ i ].first.begin (), before [ i ].first.end (), seeded.seed ));
+            }
+        BOOST_CHECK ( reseeded [ 0 ].second != before [ 0 ].second );
+
+    //  Thue-Morse strings and their complements collide for any odd base
+    //  modulo 2^64 (once they are 2^11 long); the fingerprints tell them apart
+        std::string thue_morse, complement;
+        for ( std::size_t i = 0; i < 4096; ++i ) {
+            std::size_t bits = 0;
+            for ( std::size_t j = i; j != 0; j >>= 1 )
+                bits += j & 1;
+            thue_morse += static_cast<char> ( 'a' + bits % 2 );
+            complement += static_cast<char> ( 'b' - bits % 2 );
+            }
+        BOOST_CHECK_EQUAL ( ba::rabin_karp_hash ( thue_morse.begin (), thue_morse.end ()),
+                            ba::rabin_karp_hash ( complement.begin (), complement.end ()));
+        BOOST_CHECK ( ba::rabin_karp_fingerprint ( thue_morse.begin (), thue_morse.end ()) !=
+                      ba::rabin_karp_fingerprint ( complement.begin (), complement.end ()));
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    std::vector<std::string> patterns;
+    check_one ( "abc", patterns );
+
+    patterns.push_back ( "abc" );
+    check_one ( "", patterns );
+    check_one ( "ab", patterns );
+    check_one ( "abc", patterns );
+    check_one ( "xxabcabcxx", patterns );
+
+    patterns.push_back ( "bca" );
+    patterns.push_back ( "abc" );       // a duplicate is reported with its own id
+    check_one ( "xxabcabcxx", patterns );
+
+    std::vector<std::string> empties ( 2 );
+    check_one ( "abc", empties );
+
+    std::vector<std::string> mixed ( 1, "ab" );
+    mixed.push_back ( "abc" );
+    BOOST_CHECK_THROW ( ba::make_rabin_karp ( mixed ), std::invalid_argument );
+
+//  Many fixed-length fingerprints, some of which occur
+    std::srand ( 1 );
+    for ( int alphabet = 2; alphabet <= 26; alphabet += 8 )
+        for ( std::size_t len = 1; len <= 32; len *= 2 ) {
+            const std::string corpus = random_string ( 2000, alphabet );
+            std::vector<std::string> fingerprints;
+            for ( int i = 0; i < 50; ++i )
+                fingerprints.push_back ( random_string ( len, alphabet ));
+            for ( int i = 0; i < 5; ++i )
+                fingerprints.push_back ( corpus.substr ( std::rand () % ( corpus.size () - len ), len ));
+            check_one ( corpus, fingerprints );
+            }
+
+//  Other integral types
+    std::vector<int> icorpus;
+    for ( int i = 0; i < 100; ++i )
+        icorpus.push_back ( i % 7 - 3 );
+    std::vector<std::vector<int> > ipatterns ( 1, std::vector<int> ( icorpus.begin () + 10, icorpus.begin () + 13 ));
+    const std::pair<std::vector<int>::iterator, std::size_t> found = ba::rabin_karp_search ( icorpus, ipatterns );
+    BOOST_CHECK ( found.first == icorpus.begin () + 3 );
+    BOOST_CHECK_EQUAL ( found.second, 0U );
+
+    check_chunks ();
+}
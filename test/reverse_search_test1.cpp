@@ -0,0 +1,119 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the reverse (last occurrence) searchers
+*/
+
+#include <boost/algorithm/searching/reverse_boyer_moore.hpp>
+#include <boost/algorithm/searching/reverse_boyer_moore_horspool.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  Every match, from the last to the first, the slow way
+    positions naive_reverse_positions ( const std::string &corpus, const std::string &pattern, ba::search_overlap_mode mode ) {
+        positions retVal;
+        if ( pattern.empty () || pattern.size () > corpus.size ()) return retVal;
+        std::ptrdiff_t limit = static_cast<std::ptrdiff_t> ( corpus.size () - pattern.size ());
+        for ( std::ptrdiff_t pos = limit; pos >= 0; --pos )
+            if ( corpus.compare ( pos, pattern.size (), pattern ) == 0 ) {
+                retVal.push_back ( pos );
+                if ( mode == ba::search_non_overlapping )
+                    pos -= static_cast<std::ptrdiff_t> ( pattern.size ()) - 1;
+                }
+        return retVal;
+        }
+
+    template <typename Searcher>
+    positions found_positions ( const Searcher &s, const std::string &corpus, ba::search_overlap_mode mode ) {
+        typedef std::string::const_iterator iter;
+        positions retVal;
+        const iter first = corpus.begin (), last = corpus.end ();
+        for ( iter it = s ( first, last ); it != last; it = s.find_previous ( first, it, last, mode ))
+            retVal.push_back ( it - first );
+        return retVal;
+        }
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        typedef std::string::const_iterator iter;
+        const ba::reverse_boyer_moore<iter>          rbm  ( pattern.begin (), pattern.end ());
+        const ba::reverse_boyer_moore_horspool<iter> rbmh ( pattern.begin (), pattern.end ());
+
+        const iter expected = std::find_end ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+        BOOST_CHECK ( rbm  ( corpus.begin (), corpus.end ()) == expected );
+        BOOST_CHECK ( rbmh ( corpus.begin (), corpus.end ()) == expected );
+        BOOST_CHECK ( ba::reverse_boyer_moore_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::reverse_boyer_moore_horspool_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::reverse_boyer_moore_search ( corpus.begin (), corpus.end (), pattern ) == expected );
+        BOOST_CHECK ( ba::reverse_boyer_moore_horspool_search ( corpus, pattern.begin (), pattern.end ()) == expected );
+
+    //  Pointers, too
+        if ( !corpus.empty () && !pattern.empty ()) {
+            const char *first = corpus.data ();
+            const char *last  = first + corpus.size ();
+            const ba::reverse_boyer_moore_horspool<const char *> p ( pattern.data (), pattern.data () + pattern.size ());
+            BOOST_CHECK_EQUAL ( p ( first, last ) - first, expected - corpus.begin ());
+            }
+
+        if ( !pattern.empty ())
+            for ( int m = 0; m < 2; ++m ) {
+                const ba::search_overlap_mode mode = m == 0 ? ba::search_overlapping : ba::search_non_overlapping;
+                const positions want = naive_reverse_positions ( corpus, pattern, mode );
+                BOOST_CHECK ( found_positions ( rbm,  corpus, mode ) == want );
+                BOOST_CHECK ( found_positions ( rbmh, corpus, mode ) == want );
+                }
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    const std::string log ( "GET /a 200\nGET /b 404\nGET /a 500\nGET /c 200\n" );
+    BOOST_CHECK_EQUAL ( ba::reverse_boyer_moore_search ( log, std::string ( "GET /a" )) - log.begin (), 22 );
+    BOOST_CHECK_EQUAL ( ba::reverse_boyer_moore_horspool_search ( log, std::string ( " 200" )) - log.begin (), 39 );
+    BOOST_CHECK ( ba::reverse_boyer_moore_search ( log, std::string ( "PUT" )) == log.end ());
+
+//  An empty pattern matches at the end; nothing matches in an empty corpus
+    BOOST_CHECK ( ba::reverse_boyer_moore_search ( log, std::string ()) == log.end ());
+    const std::string empty;
+    BOOST_CHECK ( ba::reverse_boyer_moore_horspool_search ( empty, std::string ( "a" )) == empty.end ());
+    BOOST_CHECK ( ba::reverse_boyer_moore_horspool_search ( empty, empty ) == empty.end ());
+
+    check_one ( "aaaaaaa", "aa" );
+    check_one ( "abababab", "abab" );
+    check_one ( "abc", "abcd" );
+    check_one ( "abc", "" );
+    check_one ( "", "" );
+
+    std::srand ( 42 );
+    for ( int i = 0; i < 500; ++i ) {
+        const int alphabet = 1 + std::rand () % 4;
+        const std::string corpus = random_string ( std::rand () % 300, alphabet );
+        check_one ( corpus, random_string ( 1 + std::rand () % 8, alphabet ));
+        if ( corpus.size () > 10 ) {
+            const std::size_t start = std::rand () % ( corpus.size () - 10 );
+            check_one ( corpus, corpus.substr ( start, 1 + std::rand () % 10 ));
+            }
+        }
+
+//  The same, with a creator function
+    const std::string pattern ( "abab" );
+    BOOST_CHECK_EQUAL ( ba::make_reverse_boyer_moore ( pattern ) ( log ) - log.begin (), static_cast<std::ptrdiff_t> ( log.size ()));
+    const std::vector<char> v ( log.begin (), log.end ());
+    BOOST_CHECK ( ba::make_reverse_boyer_moore_horspool ( pattern ) ( v ) == v.end ());
+}
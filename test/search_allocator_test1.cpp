@@ -0,0 +1,172 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the searchers with user-supplied allocators and scratch memory
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt_dfa.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if !defined(BOOST_NO_CXX17_HDR_MEMORY_RESOURCE) && __cplusplus >= 201703L
+#define TEST_MEMORY_RESOURCE
+#include <memory_resource>
+#endif
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  Counts the allocations made through it (and its rebound copies)
+    struct allocation_counts {
+        allocation_counts () : allocations ( 0 ), live ( 0 ) {}
+        std::size_t allocations;
+        std::size_t live;
+        };
+
+    template <typename T>
+    class counting_allocator {
+    public:
+        typedef T value_type;
+        typedef T *pointer;
+        typedef const T *const_pointer;
+        typedef T &reference;
+        typedef const T &const_reference;
+        typedef std::size_t size_type;
+        typedef std::ptrdiff_t difference_type;
+        template <typename U> struct rebind { typedef counting_allocator<U> other; };
+
+        explicit counting_allocator ( allocation_counts &counts ) : counts_ ( &counts ) {}
+        template <typename U>
+        counting_allocator ( const counting_allocator<U> &other ) : counts_ ( other.counts_ ) {}
+
+        T *allocate ( std::size_t n ) {
+            ++counts_->allocations;
+            ++counts_->live;
+            return std::allocator<T> ().allocate ( n );
+            }
+
+        void deallocate ( T *p, std::size_t n ) {
+            --counts_->live;
+            std::allocator<T> ().deallocate ( p, n );
+            }
+
+        std::size_t max_size () const { return std::size_t ( -1 ) / sizeof ( T ); }
+
+        allocation_counts *counts_;
+        };
+
+    template <typename T, typename U>
+    bool operator == ( const counting_allocator<T> &a, const counting_allocator<U> &b ) { return a.counts_ == b.counts_; }
+    template <typename T, typename U>
+    bool operator != ( const counting_allocator<T> &a, const counting_allocator<U> &b ) { return a.counts_ != b.counts_; }
+
+    typedef std::string::const_iterator iter;
+    typedef counting_allocator<char> char_allocator;
+
+    const std::string corpus ( "Now is the time for all good men to come to the aid of their party" );
+    const std::string pattern ( "to the aid" );
+    const std::ptrdiff_t expected = static_cast<std::ptrdiff_t> ( corpus.find ( pattern ));
+
+    void check_counting_allocator () {
+        allocation_counts counts;
+        const char_allocator alloc ( counts );
+        {
+            ba::boyer_moore<iter, ba::detail::BM_traits<iter, char_allocator> > bm ( pattern.begin (), pattern.end (), alloc );
+            BOOST_CHECK_EQUAL ( bm ( corpus ) - corpus.begin (), expected );
+        //  The skip table, the suffix table, and the scratch space
+            BOOST_CHECK_EQUAL ( counts.allocations, 3U );
+            BOOST_CHECK_EQUAL ( counts.live, 2U );
+        }
+        BOOST_CHECK_EQUAL ( counts.live, 0U );
+
+    //  With the scratch space from the caller
+        std::vector<std::ptrdiff_t> scratch ( ba::boyer_moore<iter>::scratch_size ( pattern.size ()));
+        counts = allocation_counts ();
+        {
+            ba::boyer_moore<iter, ba::detail::BM_traits<iter, char_allocator> >
+                bm ( pattern.begin (), pattern.end (), &scratch [ 0 ], alloc );
+            BOOST_CHECK_EQUAL ( bm ( corpus ) - corpus.begin (), expected );
+            BOOST_CHECK_EQUAL ( counts.allocations, 2U );
+        }
+        BOOST_CHECK_EQUAL ( counts.live, 0U );
+
+        counts = allocation_counts ();
+        {
+            const ba::boyer_moore_horspool<iter, ba::detail::BM_traits<iter, char_allocator> > bmh
+                = ba::make_boyer_moore_horspool ( pattern, alloc );
+            const ba::knuth_morris_pratt<iter, char_allocator> kmp = ba::make_knuth_morris_pratt ( pattern, alloc );
+            const ba::knuth_morris_pratt_dfa<iter, char_allocator> dfa = ba::make_knuth_morris_pratt_dfa ( pattern, alloc );
+            BOOST_CHECK_EQUAL ( bmh ( corpus ) - corpus.begin (), expected );
+            BOOST_CHECK_EQUAL ( kmp ( corpus ) - corpus.begin (), expected );
+            BOOST_CHECK_EQUAL ( dfa ( corpus ) - corpus.begin (), expected );
+            BOOST_CHECK_EQUAL ( counts.live, 3U );
+
+        //  Copies get their tables from the same allocator
+            const ba::knuth_morris_pratt<iter, char_allocator> kmp2 ( kmp );
+            BOOST_CHECK_EQUAL ( kmp2 ( corpus ) - corpus.begin (), expected );
+            BOOST_CHECK_EQUAL ( counts.live, 4U );
+        }
+        BOOST_CHECK_EQUAL ( counts.live, 0U );
+
+    //  Non-byte patterns: the paged, flat and map skip tables
+        std::vector<short> spat ( 5, 1000 ), scorpus ( 100, 999 );
+        std::vector<int>   ipat ( 5, 100000 ), icorpus ( 100, 99999 );
+        std::vector<std::string> strpat ( 2, "x" ), strcorpus ( 10, "y" );
+        counts = allocation_counts ();
+        {
+            BOOST_CHECK ( ba::make_boyer_moore ( spat, alloc ) ( scorpus ) == scorpus.end ());
+            BOOST_CHECK ( ba::make_boyer_moore_horspool ( ipat, alloc ) ( icorpus ) == icorpus.end ());
+            BOOST_CHECK ( ba::make_boyer_moore ( strpat, alloc ) ( strcorpus ) == strcorpus.end ());
+        }
+        BOOST_CHECK ( counts.allocations > 0 );
+        BOOST_CHECK_EQUAL ( counts.live, 0U );
+        }
+
+#ifdef TEST_MEMORY_RESOURCE
+//  Everything from an arena; nothing from the heap
+    void check_pmr () {
+        char buffer [ 4096 ];
+        std::pmr::monotonic_buffer_resource arena ( buffer, sizeof ( buffer ), std::pmr::null_memory_resource ());
+        const std::pmr::polymorphic_allocator<char> alloc ( &arena );
+        std::ptrdiff_t scratch [ 64 ];
+
+        const auto bm   = ba::make_boyer_moore ( pattern, alloc );
+        const auto bmh  = ba::make_boyer_moore_horspool ( pattern, alloc );
+        const auto kmp  = ba::make_knuth_morris_pratt ( pattern, alloc );
+        ba::boyer_moore<iter, ba::detail::BM_traits<iter, std::pmr::polymorphic_allocator<char> > >
+            bm2 ( pattern.begin (), pattern.end (), scratch, alloc );
+        BOOST_CHECK_EQUAL ( bm   ( corpus ) - corpus.begin (), expected );
+        BOOST_CHECK_EQUAL ( bmh  ( corpus ) - corpus.begin (), expected );
+        BOOST_CHECK_EQUAL ( kmp  ( corpus ) - corpus.begin (), expected );
+        BOOST_CHECK_EQUAL ( bm2  ( corpus ) - corpus.begin (), expected );
+
+    //  A full arena fails, rather than going to the heap
+        char tiny_buffer [ 16 ];
+        std::pmr::monotonic_buffer_resource tiny ( tiny_buffer, sizeof ( tiny_buffer ), std::pmr::null_memory_resource ());
+        BOOST_CHECK_THROW ( ba::make_boyer_moore ( pattern, std::pmr::polymorphic_allocator<char> ( &tiny )), std::bad_alloc );
+        }
+#endif
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_counting_allocator ();
+#ifdef TEST_MEMORY_RESOURCE
+    check_pmr ();
+#endif
+}
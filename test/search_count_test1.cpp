@@ -0,0 +1,101 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the occurrence counts of the searcher objects
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt_dfa.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    template <typename Searcher>
+    void check_searcher ( const Searcher &s, const std::string &corpus, const std::string &pattern ) {
+        for ( int m = 0; m < 2; ++m ) {
+            const ba::search_overlap_mode mode = m == 0 ? ba::search_overlapping : ba::search_non_overlapping;
+            const std::size_t expected = naive_count ( corpus, pattern, mode );
+            BOOST_CHECK_EQUAL ( s.count ( corpus.begin (), corpus.end (), mode ), expected );
+            BOOST_CHECK_EQUAL ( s.count ( corpus, mode ), expected );
+            }
+        BOOST_CHECK_EQUAL ( s.count ( corpus ), naive_count ( corpus, pattern, ba::search_overlapping ));
+        }
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        typedef std::string::const_iterator iter;
+        check_searcher ( ba::boyer_moore<iter>            ( pattern.begin (), pattern.end ()), corpus, pattern );
+        check_searcher ( ba::boyer_moore_horspool<iter>   ( pattern.begin (), pattern.end ()), corpus, pattern );
+        check_searcher ( ba::knuth_morris_pratt<iter>     ( pattern.begin (), pattern.end ()), corpus, pattern );
+        check_searcher ( ba::knuth_morris_pratt_dfa<iter> ( pattern.begin (), pattern.end ()), corpus, pattern );
+
+    //  Pointers into the corpus take the vectorized path for single elements
+        const char *first = corpus.data ();
+        const char *last  = first + corpus.size ();
+        const ba::boyer_moore_horspool<const char *> p ( pattern.data (), pattern.data () + pattern.size ());
+        BOOST_CHECK_EQUAL ( p.count ( first, last ), naive_count ( corpus, pattern, ba::search_overlapping ));
+        BOOST_CHECK_EQUAL ( p.count ( first, last, ba::search_non_overlapping ),
+                            naive_count ( corpus, pattern, ba::search_non_overlapping ));
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    const std::string text ( "the cat sat on the mat; the end" );
+    BOOST_CHECK_EQUAL ( ba::make_boyer_moore ( std::string ( "the" )).count ( text ), 3U );
+    BOOST_CHECK_EQUAL ( ba::make_knuth_morris_pratt ( std::string ( "at" )).count ( text ), 3U );
+    BOOST_CHECK_EQUAL ( ba::make_boyer_moore_horspool ( std::string ( " " )).count ( text ), 7U );
+    BOOST_CHECK_EQUAL ( ba::make_boyer_moore_horspool ( std::string ( "dog" )).count ( text ), 0U );
+
+//  Periodic patterns: overlapping matches are a period apart
+    check_one ( "aaaaaaa", "aa" );
+    check_one ( "abababab", "abab" );
+    check_one ( "abaababaab", "abaab" );
+    check_one ( "abc", "abcd" );
+    check_one ( "abc", "" );
+    check_one ( "", "a" );
+    check_one ( "", "" );
+
+    std::srand ( 7 );
+    for ( int i = 0; i < 300; ++i ) {
+        const int alphabet = 1 + std::rand () % 4;
+        const std::string corpus = random_string ( std::rand () % 300, alphabet );
+        check_one ( corpus, random_string ( 1 + std::rand () % 6, alphabet ));
+        }
+
+//  Long enough to go through the vector loops, with a ragged tail
+    for ( std::size_t len = 0; len < 200; len += 13 )
+        check_one ( random_string ( 1000 + len, 3 ), std::string ( 1, 'b' ));
+//  and through more blocks than a lane's byte counter can hold
+    check_one ( random_string ( 20000, 2 ), std::string ( 1, 'a' ));
+    check_one ( std::string ( 20000, 'a' ), std::string ( 1, 'a' ));
+
+//  Non-character data
+    std::vector<int> ints;
+    for ( int i = 0; i < 1000; ++i )
+        ints.push_back ( i % 7 );
+    const std::vector<int> three ( 1, 3 );
+    BOOST_CHECK_EQUAL ( ba::make_boyer_moore ( three ).count ( ints ),
+                        static_cast<std::size_t> ( std::count ( ints.begin (), ints.end (), 3 )));
+    std::vector<int> run;
+    run.push_back ( 5 ); run.push_back ( 6 ); run.push_back ( 0 );
+    BOOST_CHECK_EQUAL ( ba::make_knuth_morris_pratt ( run ).count ( ints ), 142U );
+    BOOST_CHECK_EQUAL ( ba::make_boyer_moore_horspool ( run ).count ( ints, ba::search_non_overlapping ), 142U );
+}
@@ -0,0 +1,20 @@
+/* 
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#include <string>
+#include <boost/algorithm/searching/suffix_array_index.hpp>
+
+int main( int , char* [] )
+{
+//  Should fail to compile because a one-byte Index can't hold the 256 byte buckets
+    const std::string corpus ( "abracadabra" );
+    boost::algorithm::suffix_array_index<std::string::const_iterator, unsigned char> sa ( corpus.begin (), corpus.end ());
+   
+   return 0;
+}
@@ -0,0 +1,115 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the chunked (push-mode) search sessions
+*/
+
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::vector<boost::uintmax_t> offsets;
+
+    struct collect_offsets {
+        explicit collect_offsets ( offsets &out ) : out_ ( &out ) {}
+        void operator () ( boost::uintmax_t off ) { out_->push_back ( off ); }
+        offsets *out_;
+        };
+
+//  Split 'corpus' at the given cut points, and push the pieces one after another
+    void check_one ( const std::string &corpus, const std::string &pattern, const std::vector<std::size_t> &cuts ) {
+        typedef std::string::const_iterator iter;
+        const positions matches = naive_positions ( corpus, pattern );
+        const offsets expected ( matches.begin (), matches.end ());
+
+        ba::boyer_moore_horspool<iter> bmh ( pattern.begin (), pattern.end ());
+        ba::knuth_morris_pratt<iter>   kmp ( pattern.begin (), pattern.end ());
+        ba::boyer_moore_horspool_session<iter> bmh_session ( bmh );
+        ba::knuth_morris_pratt_session<iter>   kmp_session ( kmp );
+
+        offsets bmh_found, kmp_found;
+        std::size_t start = 0;
+        for ( std::size_t i = 0; i <= cuts.size (); ++i ) {
+            const std::size_t stop = i < cuts.size () ? cuts [ i ] : corpus.size ();
+        //  Copy the chunk, so that nothing can peek at the previous ones
+            const std::string chunk ( corpus.begin () + start, corpus.begin () + stop );
+            bmh_session.push ( chunk.begin (), chunk.end (), collect_offsets ( bmh_found ));
+            kmp_session.push ( chunk.begin (), chunk.end (), collect_offsets ( kmp_found ));
+            start = stop;
+            }
+
+        BOOST_CHECK ( bmh_found == expected );
+        BOOST_CHECK ( kmp_found == expected );
+        BOOST_CHECK_EQUAL ( bmh_session.offset (), corpus.size ());
+        BOOST_CHECK_EQUAL ( kmp_session.offset (), corpus.size ());
+        }
+
+    std::vector<std::size_t> random_cuts ( std::size_t len, std::size_t max_chunk ) {
+        std::vector<std::size_t> retVal;
+        for ( std::size_t pos = std::rand () % ( max_chunk + 1 ); pos < len; pos += std::rand () % ( max_chunk + 1 ))
+            retVal.push_back ( pos );
+        return retVal;
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    std::vector<std::size_t> cuts;
+    check_one ( "abracadabra", "abra", cuts );
+    check_one ( "abracadabra", "", cuts );
+    check_one ( "", "abra", cuts );
+
+//  A match split across chunks, and chunks shorter than the pattern
+    cuts.push_back ( 2 );
+    cuts.push_back ( 3 );
+    cuts.push_back ( 3 );   // an empty chunk
+    cuts.push_back ( 9 );
+    check_one ( "abracadabra", "abra", cuts );
+    check_one ( "abracadabra", "a", cuts );
+    check_one ( "abracadabra", "abracadabra", cuts );
+    check_one ( "aaaaaaaaaaa", "aaa", cuts );
+
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 12; ++pat_len )
+        for ( int alphabet = 2; alphabet <= 4; ++alphabet )
+            for ( std::size_t max_chunk = 1; max_chunk <= 20; max_chunk += 3 ) {
+                const std::string corpus  = random_string ( 500, alphabet );
+                const std::string pattern = random_string ( pat_len, alphabet );
+                check_one ( corpus, pattern, random_cuts ( corpus.size (), max_chunk ));
+                }
+
+//  The KMP session only needs input iterators
+    std::istringstream in ( "the cat sat on the mat with the hat" );
+    const std::string the ( "the" );
+    ba::knuth_morris_pratt<std::string::const_iterator> kmp ( the.begin (), the.end ());
+    ba::knuth_morris_pratt_session<std::string::const_iterator> session ( kmp );
+    offsets found;
+    session.push ( std::istreambuf_iterator<char> ( in ), std::istreambuf_iterator<char> (), collect_offsets ( found ));
+    BOOST_REQUIRE_EQUAL ( found.size (), 3U );
+    BOOST_CHECK_EQUAL ( found [ 0 ],  0U );
+    BOOST_CHECK_EQUAL ( found [ 1 ], 15U );
+    BOOST_CHECK_EQUAL ( found [ 2 ], 28U );
+
+    session.reset ();
+    BOOST_CHECK_EQUAL ( session.offset (), 0U );
+}
@@ -0,0 +1,88 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+*/
+
+#ifndef SEARCH_TEST_H
+#define SEARCH_TEST_H
+
+/*
+    Helpers shared by the searcher tests: random corpora and patterns,
+    the matches of a pattern found the slow way, and a check of a
+    searcher's first match and find_all against them.
+*/
+
+#include <cstdlib>
+#include <cstddef>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/range/begin.hpp>
+#include <boost/range/end.hpp>
+#include <boost/range/iterator.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <boost/algorithm/searching/match_iterator.hpp>
+
+typedef std::vector<std::ptrdiff_t> positions;
+
+//  'len' random characters, from the 'alphabet' characters starting at 'first'
+inline std::string random_string ( std::size_t len, int alphabet, char first = 'a' ) {
+    std::string retVal ( len, ' ' );
+    for ( std::size_t i = 0; i < len; ++i )
+        retVal [ i ] = static_cast<char> ( first + std::rand () % alphabet );
+    return retVal;
+    }
+
+//  Every match, the slow way; an empty pattern has none
+inline positions naive_positions ( const std::string &corpus, const std::string &pattern,
+                                   boost::algorithm::search_overlap_mode mode = boost::algorithm::search_overlapping ) {
+    positions retVal;
+    if ( pattern.empty ()) return retVal;
+    std::string::const_iterator it = corpus.begin ();
+    while (( it = std::search ( it, corpus.end (), pattern.begin (), pattern.end ())) != corpus.end ()) {
+        retVal.push_back ( it - corpus.begin ());
+        if ( mode == boost::algorithm::search_overlapping )
+            ++it;
+        else
+            it += pattern.size ();
+        }
+    return retVal;
+    }
+
+inline std::size_t naive_count ( const std::string &corpus, const std::string &pattern,
+                                 boost::algorithm::search_overlap_mode mode = boost::algorithm::search_overlapping ) {
+    return naive_positions ( corpus, pattern, mode ).size ();
+    }
+
+//  The positions in the corpus of a range of matches
+template <typename Range>
+positions match_positions ( const std::string &corpus, const Range &matches ) {
+    positions retVal;
+    for ( typename boost::range_iterator<const Range>::type it = boost::begin ( matches ); it != boost::end ( matches ); ++it )
+        retVal.push_back ( *it - corpus.begin ());
+    return retVal;
+    }
+
+//  The first match agrees with std::search, and find_all with
+//  naive_positions, in both modes
+template <typename Searcher>
+void check_matches ( const Searcher &s, const std::string &corpus, const std::string &pattern ) {
+    const std::string::const_iterator expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+    BOOST_CHECK ( s ( corpus.begin (), corpus.end ()) == expected );
+    BOOST_CHECK ( s ( corpus ) == expected );
+
+    for ( int m = 0; m < 2; ++m ) {
+        const boost::algorithm::search_overlap_mode mode =
+                m == 0 ? boost::algorithm::search_overlapping : boost::algorithm::search_non_overlapping;
+        BOOST_CHECK ( match_positions ( corpus, s.find_all ( corpus.begin (), corpus.end (), mode )) ==
+                      naive_positions ( corpus, pattern, mode ));
+        }
+    }
+
+#endif  // SEARCH_TEST_H
@@ -0,0 +1,125 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the searcher cache
+*/
+
+#include <boost/algorithm/searching/searcher_cache.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_NO_CXX11_LAMBDAS)
+#define TEST_THREADS
+#include <thread>
+#include <atomic>
+#endif
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    const std::string corpus ( "The quick brown fox jumps over the lazy dog; the quick brown fox is quick." );
+
+    void check_hits_and_misses () {
+        ba::searcher_cache<char> cache ( 2 );
+        const std::string quick ( "quick" ), fox ( "fox" ), dog ( "dog" );
+
+        BOOST_CHECK ( ba::cached_search ( corpus, quick, cache ) == ba::boyer_moore_search ( corpus, quick ));
+        BOOST_CHECK ( ba::cached_search ( corpus, quick, cache ) == ba::boyer_moore_search ( corpus, quick ));
+        BOOST_CHECK_EQUAL ( cache.misses (), 1U );
+        BOOST_CHECK_EQUAL ( cache.hits (),   1U );
+
+    //  The pattern is compared by contents, not by address
+        const std::vector<char> quick_copy ( quick.begin (), quick.end ());
+        BOOST_CHECK ( ba::cached_search ( corpus.begin (), corpus.end (), quick_copy.begin (), quick_copy.end (), cache )
+                      == corpus.begin () + 4 );
+        BOOST_CHECK_EQUAL ( cache.hits (), 2U );
+
+    //  Least recently used goes first: 'quick' was just used, so 'fox' is evicted
+        ba::cached_search ( corpus, fox, cache );
+        ba::cached_search ( corpus, quick, cache );
+        BOOST_CHECK ( ba::cached_search ( corpus, dog, cache ) == corpus.begin () + 40 );
+        BOOST_CHECK_EQUAL ( cache.size (), 2U );
+        BOOST_CHECK_EQUAL ( cache.misses (), 3U );
+        ba::cached_search ( corpus, quick, cache );
+        BOOST_CHECK_EQUAL ( cache.misses (), 3U );
+        ba::cached_search ( corpus, fox, cache );
+        BOOST_CHECK_EQUAL ( cache.misses (), 4U );
+
+    //  A searcher outlives its eviction, while it is being used
+        ba::searcher_cache<char>::searcher_ptr held = cache.get ( std::string ( "lazy" ));
+        cache.clear ();
+        BOOST_CHECK_EQUAL ( cache.size (), 0U );
+        BOOST_CHECK ( (*held) ( corpus ) == corpus.begin () + 35 );
+
+    //  Not found, and empty patterns
+        BOOST_CHECK ( ba::cached_search ( corpus, std::string ( "cat" ), cache ) == corpus.end ());
+        BOOST_CHECK ( ba::cached_search ( corpus, std::string (), cache ) == corpus.begin ());
+        }
+
+    void check_other_searchers () {
+        typedef ba::boyer_moore_horspool<std::vector<char>::const_iterator> bmh;
+        ba::searcher_cache<char, bmh> cache ( 4 );
+        BOOST_CHECK ( ba::cached_search ( corpus, std::string ( "over" ), cache ) == corpus.begin () + 26 );
+        BOOST_CHECK ( ba::cached_search ( corpus, std::string ( "over" ), cache ) == corpus.begin () + 26 );
+        BOOST_CHECK_EQUAL ( cache.hits (), 1U );
+
+    //  With no capacity, nothing is kept
+        ba::searcher_cache<char> none ( 0 );
+        BOOST_CHECK ( ba::cached_search ( corpus, std::string ( "over" ), none ) == corpus.begin () + 26 );
+        BOOST_CHECK ( ba::cached_search ( corpus, std::string ( "over" ), none ) == corpus.begin () + 26 );
+        BOOST_CHECK_EQUAL ( none.misses (), 2U );
+        BOOST_CHECK_EQUAL ( none.size (), 0U );
+
+    //  Non-byte patterns
+        std::vector<int> ints;
+        for ( int i = 0; i < 100; ++i ) ints.push_back ( i * i );
+        std::vector<int> pattern ( ints.begin () + 40, ints.begin () + 45 );
+        ba::searcher_cache<int> icache ( 1 );
+        BOOST_CHECK ( ba::cached_search ( ints, pattern, icache ) == ints.begin () + 40 );
+        }
+
+#ifdef TEST_THREADS
+//  Many threads, a few patterns, a cache too small for all of them
+    void check_threads () {
+        ba::searcher_cache<char> cache ( 3 );
+        const char *patterns [] = { "quick", "fox", "lazy", "dog", "the", "brown" };
+        const std::size_t expected [] = { 4, 16, 35, 40, 31, 10 };
+        std::atomic<int> errors ( 0 );
+        std::vector<std::thread> threads;
+        for ( int t = 0; t < 8; ++t )
+            threads.push_back ( std::thread ( [&, t] () {
+                for ( int i = 0; i < 2000; ++i ) {
+                    const std::size_t p = ( i * 7 + t ) % ( i % 2 ? 6 : 3 );
+                    if ( ba::cached_search ( corpus, std::string ( patterns [ p ] ), cache )
+                            != corpus.begin () + expected [ p ] )
+                        ++errors;
+                    }
+                }));
+        for ( std::size_t i = 0; i < threads.size (); ++i )
+            threads [ i ].join ();
+        BOOST_CHECK_EQUAL ( errors.load (), 0 );
+        BOOST_CHECK_EQUAL ( cache.hits () + cache.misses (), 16000U );
+        BOOST_CHECK ( cache.size () <= 3 );
+        }
+#endif
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_hits_and_misses ();
+    check_other_searchers ();
+#ifdef TEST_THREADS
+    check_threads ();
+#endif
+}
@@ -0,0 +1,139 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the search of segmented corpora
+*/
+
+#include <boost/algorithm/searching/segmented_search.hpp>
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/knuth_morris_pratt.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <boost/next_prior.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <cstdlib>
+#include <list>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::vector<boost::uintmax_t> offsets;
+    typedef std::vector<std::vector<char> > chain;
+
+//  Cut the corpus into segments of random sizes (some of them empty)
+    chain cut ( const std::string &corpus, std::size_t max_size ) {
+        chain retVal;
+        std::size_t pos = 0;
+        while ( pos < corpus.size ()) {
+            const std::size_t len = std::min<std::size_t> ( std::rand () % ( max_size + 1 ), corpus.size () - pos );
+            retVal.push_back ( std::vector<char> ( corpus.begin () + pos, corpus.begin () + pos + len ));
+            pos += len;
+            }
+        return retVal;
+        }
+
+//  Check that the position and the offset agree, and collect the offsets
+    struct collect {
+        collect ( const chain &segments, offsets &out ) : segments_ ( &segments ), out_ ( &out ) {}
+        void operator () ( const ba::segmented_position<chain::const_iterator> &pos ) const {
+            boost::uintmax_t off = 0;
+            for ( chain::const_iterator it = segments_->begin (); it != pos.segment; ++it )
+                off += it->size ();
+            BOOST_CHECK_EQUAL ( off + ( pos.position - pos.segment->begin ()), pos.offset );
+            out_->push_back ( pos.offset );
+            }
+        const chain *segments_;
+        offsets *out_;
+        };
+
+    template <typename Searcher>
+    void check_searcher ( const Searcher &s, const std::string &corpus, const chain &segments, const std::string &pattern ) {
+        for ( int m = 0; m < 2; ++m ) {
+            const ba::search_overlap_mode mode = m == 0 ? ba::search_overlapping : ba::search_non_overlapping;
+            offsets found;
+            s.for_each_match ( segments, collect ( segments, found ), mode );
+            const positions matches = naive_positions ( corpus, pattern, mode );
+            BOOST_CHECK ( found == offsets ( matches.begin (), matches.end ()));
+            }
+
+        const ba::segmented_position<chain::const_iterator> first = s ( segments );
+        const std::size_t expected = corpus.find ( pattern );
+        if ( expected == std::string::npos ) {
+            BOOST_CHECK ( first.segment == segments.end ());
+            BOOST_CHECK_EQUAL ( first.offset, corpus.size ());
+            }
+        else
+            BOOST_CHECK_EQUAL ( first.offset, expected );
+        }
+
+    void check_one ( const std::string &corpus, const std::string &pattern, std::size_t max_size ) {
+        typedef std::string::const_iterator iter;
+        const chain segments = cut ( corpus, max_size );
+        check_searcher ( ba::make_segmented_searcher ( pattern ), corpus, segments, pattern );
+        check_searcher ( ba::segmented_searcher<iter, ba::boyer_moore<iter> > ( pattern.begin (), pattern.end ()),
+                         corpus, segments, pattern );
+        check_searcher ( ba::segmented_searcher<iter, ba::knuth_morris_pratt<iter> > ( pattern.begin (), pattern.end ()),
+                         corpus, segments, pattern );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+//  A match that spans three segments
+    std::list<std::string> buffers;
+    buffers.push_back ( "GET /index.ht" );
+    buffers.push_back ( "ml HTTP/1" );
+    buffers.push_back ( "" );
+    buffers.push_back ( ".1\r" );
+    buffers.push_back ( "\n" );
+    buffers.push_back ( "\r\n" );
+    const ba::segmented_position<std::list<std::string>::const_iterator> end_of_headers =
+        ba::segmented_search ( buffers, std::string ( "\r\n\r\n" ));
+    BOOST_CHECK_EQUAL ( end_of_headers.offset, 24U );
+    BOOST_CHECK ( end_of_headers.segment == boost::next ( buffers.begin (), 3 ));
+    BOOST_CHECK_EQUAL ( *end_of_headers.position, '\r' );
+    const ba::segmented_position<std::list<std::string>::iterator> version =
+        ba::segmented_search ( buffers.begin (), buffers.end (), std::string ( "HTTP/1.1" ));
+    BOOST_CHECK_EQUAL ( version.offset, 16U );
+    BOOST_CHECK ( version.segment == ++buffers.begin ());
+    BOOST_CHECK_EQUAL ( version.position - version.segment->begin (), 3 );
+
+//  Segments that are ranges of pointers
+    const char *text = "abcabcabc";
+    std::vector<boost::iterator_range<const char *> > pieces;
+    pieces.push_back ( boost::iterator_range<const char *> ( text, text + 4 ));
+    pieces.push_back ( boost::iterator_range<const char *> ( text + 4, text + 9 ));
+    const std::string cab ( "cab" );
+    const ba::segmented_position<std::vector<boost::iterator_range<const char *> >::const_iterator> p =
+        ba::segmented_search ( pieces, cab );
+    BOOST_CHECK_EQUAL ( p.offset, 2U );
+    BOOST_CHECK ( p.position == text + 2 );
+
+//  Empty patterns and corpora
+    const chain none;
+    BOOST_CHECK ( ba::segmented_search ( none, cab ).segment == none.end ());
+    BOOST_CHECK_EQUAL ( ba::segmented_search ( buffers, std::string ()).offset, 0U );
+
+    std::srand ( 7 );
+    for ( int i = 0; i < 300; ++i ) {
+        const int alphabet = 1 + std::rand () % 4;
+        const std::string corpus = random_string ( std::rand () % 400, alphabet );
+        const std::size_t max_size = 1 + std::rand () % 20;
+        check_one ( corpus, random_string ( 1 + std::rand () % 10, alphabet ), max_size );
+        if ( corpus.size () > 12 )
+            check_one ( corpus, corpus.substr ( std::rand () % ( corpus.size () - 12 ), 1 + std::rand () % 12 ), max_size );
+        }
+}
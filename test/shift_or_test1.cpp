@@ -0,0 +1,117 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the Shift-Or searcher, exact and with mismatches
+*/
+
+#include <boost/algorithm/searching/shift_or.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  The first position where the pattern matches with at most k mismatches
+    template <typename Iter>
+    Iter naive_search ( Iter corpus_first, Iter corpus_last, Iter pat_first, Iter pat_last, std::size_t k ) {
+        const std::ptrdiff_t m = std::distance ( pat_first, pat_last );
+        for ( Iter start = corpus_first; std::distance ( start, corpus_last ) >= m; ++start ) {
+            std::size_t mismatches = 0;
+            for ( std::ptrdiff_t i = 0; i < m; ++i )
+                if ( start [ i ] != pat_first [ i ] )
+                    ++mismatches;
+            if ( mismatches <= k )
+                return start;
+            }
+        return corpus_last;
+        }
+
+    void check_one ( const std::string &corpus, const std::string &pattern, std::size_t k ) {
+        typedef std::string::const_iterator iter;
+        const iter expected = pattern.empty () ? corpus.begin ()
+                    : naive_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end (), k );
+        ba::shift_or<iter> so ( pattern.begin (), pattern.end (), k );
+        BOOST_CHECK ( so ( corpus.begin (), corpus.end ()) == expected );
+        BOOST_CHECK ( so ( corpus ) == expected );
+        BOOST_CHECK ( ba::make_shift_or ( pattern, k ) ( corpus ) == expected );
+        if ( k == 0 ) {
+            BOOST_CHECK ( ba::shift_or_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected );
+            BOOST_CHECK ( ba::shift_or_search ( corpus.begin (), corpus.end (), pattern ) == expected );
+            BOOST_CHECK ( ba::shift_or_search ( corpus, pattern.begin (), pattern.end ()) == expected );
+            BOOST_CHECK ( ba::shift_or_search ( corpus, pattern ) == expected );
+            }
+
+    //  find_all should find every position that the naive search does
+        if ( !pattern.empty ()) {
+            std::vector<iter> all;
+            for ( iter it = corpus.begin (); ; ++it ) {
+                it = naive_search ( it, corpus.end (), pattern.begin (), pattern.end (), k );
+                if ( it == corpus.end ()) break;
+                all.push_back ( it );
+                }
+            BOOST_CHECK_EQUAL ( static_cast<std::size_t> ( boost::distance ( so.find_all ( corpus ))), all.size ());
+            BOOST_CHECK ( std::equal ( all.begin (), all.end (), so.find_all ( corpus ).begin ()));
+            }
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_one ( "abracadabra", "abra", 0 );
+    check_one ( "abracadabra", "cad", 0 );
+    check_one ( "abracadabra", "cat", 0 );
+    check_one ( "abracadabra", "cat", 1 );
+    check_one ( "abracadabra", "zzz", 2 );
+    check_one ( "abracadabra", "zzz", 3 );
+    check_one ( "abracadabra", "abracadabrax", 1 );
+    check_one ( "abracadabra", "", 0 );
+    check_one ( "", "abra", 1 );
+
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 64; pat_len += ( pat_len < 8 ? 1 : 7 ))
+        for ( std::size_t k = 0; k <= 3; ++k )
+            for ( int i = 0; i < 5; ++i ) {
+                std::string corpus = random_string ( 400, 2 + i );
+                const std::string pattern = random_string ( pat_len, 2 + i );
+            //  Plant a copy of the pattern with a few changes
+                std::string variant = pattern;
+                for ( std::size_t j = 0; j < k && j < variant.size (); ++j )
+                    variant [ std::rand () % variant.size () ] = 'z';
+                corpus.insert ( std::rand () % corpus.size (), variant );
+                check_one ( corpus, pattern, k );
+                }
+
+//  The longest pattern fits exactly; one more is too long
+    const std::string sixty_four ( 64, 'x' );
+    const std::string corpus = "yyy" + sixty_four + "yyy";
+    BOOST_CHECK ( ba::shift_or_search ( corpus, sixty_four ) == corpus.begin () + 3 );
+    BOOST_CHECK_THROW ( ba::make_shift_or ( sixty_four + "x" ), std::length_error );
+
+//  Other value types, and forward iterators for the corpus
+    std::vector<int> ipat;
+    ipat.push_back ( 1000 ); ipat.push_back ( -2 ); ipat.push_back ( 7 );
+    std::list<int> icorpus;
+    for ( int i = 0; i < 20; ++i ) icorpus.push_back ( i );
+    icorpus.push_back ( 1000 ); icorpus.push_back ( -2 ); icorpus.push_back ( 8 );
+    BOOST_CHECK ( ba::make_shift_or ( ipat ) ( icorpus ) == icorpus.end ());
+    std::list<int>::iterator found = ba::make_shift_or ( ipat, 1 ) ( icorpus );
+    BOOST_CHECK ( found != icorpus.end () && *found == 1000 );
+    BOOST_CHECK_EQUAL ( ba::make_shift_or ( ipat, 1 ).max_mismatches (), 1U );
+    BOOST_CHECK_EQUAL ( ba::make_shift_or ( ipat, 10 ).max_mismatches (), 3U );
+}
@@ -0,0 +1,113 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the skip tables for keys wider than a byte
+*/
+
+#include <boost/algorithm/searching/boyer_moore.hpp>
+#include <boost/algorithm/searching/boyer_moore_horspool.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_same.hpp>
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    template <typename Iter>
+    struct skip_table_of {
+        typedef typename ba::detail::BM_traits<Iter>::skip_table_t type;
+        };
+
+//  Random values, with the given number of distinct values, spread over
+//  the whole range of T (so that several pages, or hash chains, are used).
+    template <typename T>
+    std::vector<T> random_vec ( std::size_t len, int alphabet ) {
+        std::vector<T> retVal ( len );
+        for ( std::size_t i = 0; i < len; ++i )
+            retVal [ i ] = static_cast<T> ( ( std::rand () % alphabet ) * 40503U + 7U );
+        return retVal;
+        }
+
+    template <typename T>
+    void check_one ( const std::vector<T> &corpus, const std::vector<T> &pattern ) {
+        typedef typename std::vector<T>::const_iterator iter;
+        const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+        BOOST_CHECK ( ba::boyer_moore_search          ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::boyer_moore_horspool_search ( corpus, pattern ) == expected );
+        }
+
+    template <typename T>
+    void check_type () {
+        for ( std::size_t pat_len = 1; pat_len <= 40; pat_len += 3 )
+            for ( int alphabet = 2; alphabet <= 2000; alphabet *= 5 ) {
+                const std::vector<T> corpus = random_vec<T> ( 2000, alphabet );
+                check_one ( corpus, random_vec<T> ( pat_len, alphabet ));
+                const std::size_t pos = std::rand () % ( corpus.size () - pat_len );
+                check_one ( corpus, std::vector<T> ( corpus.begin () + pos, corpus.begin () + pos + pat_len ));
+                }
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_selection )
+{
+    BOOST_CHECK (( boost::is_same<skip_table_of<const char *>::type,
+                        ba::detail::skip_table<char, std::ptrdiff_t, true> >::value ));
+    BOOST_CHECK (( boost::is_same<skip_table_of<const boost::uint16_t *>::type,
+                        ba::detail::paged_skip_table<boost::uint16_t, std::ptrdiff_t> >::value ));
+    BOOST_CHECK (( boost::is_same<skip_table_of<const boost::int32_t *>::type,
+                        ba::detail::flat_skip_table<boost::int32_t, std::ptrdiff_t> >::value ));
+    BOOST_CHECK (( boost::is_same<skip_table_of<const double *>::type,
+                        ba::detail::skip_table<double, std::ptrdiff_t, false> >::value ));
+}
+
+BOOST_AUTO_TEST_CASE( test_tables )
+{
+    ba::detail::paged_skip_table<boost::int16_t, std::ptrdiff_t> paged ( 4, 4 );
+    paged.insert ( -1, 1 );
+    paged.insert ( 0x1234, 2 );
+    paged.insert ( 0x12FF, 3 );
+    BOOST_CHECK_EQUAL ( paged [ -1 ],     1 );
+    BOOST_CHECK_EQUAL ( paged [ 0x1234 ], 2 );
+    BOOST_CHECK_EQUAL ( paged [ 0x12FF ], 3 );
+    BOOST_CHECK_EQUAL ( paged [ 0x1235 ], 4 );
+    BOOST_CHECK_EQUAL ( paged [ 0x0034 ], 4 );
+
+//  Enough keys to fill several chains
+    ba::detail::flat_skip_table<boost::uint32_t, std::ptrdiff_t> flat ( 100, -1 );
+    for ( boost::uint32_t k = 0; k < 100; ++k )
+        flat.insert ( k * 1024, k );
+    flat.insert ( 5 * 1024, 1000 );     // replace a value
+    for ( boost::uint32_t k = 0; k < 100; ++k ) {
+        BOOST_CHECK_EQUAL ( flat [ k * 1024 ], k == 5 ? 1000 : std::ptrdiff_t ( k ));
+        BOOST_CHECK_EQUAL ( flat [ k * 1024 + 1 ], -1 );
+        }
+}
+
+BOOST_AUTO_TEST_CASE( test_search )
+{
+    std::srand ( 1 );
+    check_type<boost::uint16_t> ();
+    check_type<boost::int16_t> ();
+    check_type<wchar_t> ();
+    check_type<boost::uint32_t> ();
+    check_type<boost::int64_t> ();
+
+    const std::wstring corpus ( L"The quick brown fox jumped over the lazy dog" );
+    const std::wstring pattern ( L"lazy" );
+    BOOST_CHECK ( ba::boyer_moore_search ( corpus, pattern ) == corpus.begin () + 36 );
+    BOOST_CHECK ( ba::boyer_moore_horspool_search ( corpus, pattern ) == corpus.begin () + 36 );
+}
@@ -0,0 +1,89 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the searchers built at compile time
+*/
+
+#include <boost/algorithm/searching/static_search.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+
+#include "search_test.hpp"
+
+#ifndef BOOST_NO_CXX14_CONSTEXPR
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+//  Built by the compiler; nothing happens at run time
+    constexpr auto bmh_abra = ba::make_static_boyer_moore_horspool ( "abra" );
+    constexpr auto bm_abra  = ba::make_static_boyer_moore ( "abra" );
+    constexpr char k_corpus [] = "abracadabra";
+
+    static_assert ( bmh_abra ( k_corpus, k_corpus + 11 ) == k_corpus, "" );
+    static_assert ( bm_abra  ( k_corpus, k_corpus + 11 ) == k_corpus, "" );
+    static_assert ( bmh_abra.find_next ( k_corpus, k_corpus + 11, ba::search_overlapping ) == k_corpus + 7, "" );
+    static_assert ( bm_abra.find_next  ( k_corpus, k_corpus + 11, ba::search_overlapping ) == k_corpus + 7, "" );
+    static_assert ( ba::make_static_boyer_moore ( "cad" ) ( k_corpus, k_corpus + 11 ) == k_corpus + 4, "" );
+    static_assert ( ba::make_static_boyer_moore ( "dabrx" ) ( k_corpus, k_corpus + 11 ) == k_corpus + 11, "" );
+    static_assert ( ba::make_static_boyer_moore_horspool ( "" ).find_next ( k_corpus, k_corpus + 11, ba::search_overlapping ) == k_corpus + 11, "" );
+    static_assert ( ba::make_static_boyer_moore ( "" ).find_next ( k_corpus, k_corpus + 11, ba::search_overlapping ) == k_corpus + 11, "" );
+
+    template <std::size_t N>
+    void check_pattern ( const char ( &pattern ) [ N ] ) {
+        const ba::static_boyer_moore_horspool<char, N> bmh ( pattern );
+        const ba::static_boyer_moore<char, N>          bm  ( pattern );
+        const std::string pat ( pattern );
+
+        std::string corpus;
+        for ( int i = 0; i < 50; ++i ) {
+            corpus += static_cast<char> ( 'a' + std::rand () % 3 );
+            if ( std::rand () % 10 == 0 )
+                corpus += pat;
+            }
+        check_matches ( bmh, corpus, pat );
+        check_matches ( bm,  corpus, pat );
+        check_matches ( bmh, std::string (), pat );
+        check_matches ( bm,  pat.substr ( 0, pat.size () / 2 ), pat );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    std::srand ( 1 );
+    check_pattern ( "" );
+    check_pattern ( "a" );
+    check_pattern ( "ab" );
+    check_pattern ( "aaa" );
+    check_pattern ( "abab" );
+    check_pattern ( "abcab" );
+    check_pattern ( "cabbage" );
+    check_pattern ( "bacabacabacab" );
+
+//  Long enough for two-byte table entries
+    check_pattern ( "abcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcab"
+                    "cabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabcabc" );
+
+//  The tables are in the object; no allocation
+    BOOST_CHECK ( sizeof ( bmh_abra ) <= 4 + 256 );
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    BOOST_TEST_MESSAGE ( "No C++14 constexpr; static searchers not tested" );
+}
+
+#endif
@@ -0,0 +1,178 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the suffix array index
+*/
+
+#include <boost/algorithm/searching/suffix_array_index.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <cstring>
+#include <algorithm>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    typedef std::string::const_iterator iter;
+    typedef ba::suffix_array_index<iter> index_type;
+
+//  The suffix array and LCP array, the slow way
+    void check_tables ( const std::string &corpus, const index_type &index ) {
+        const std::size_t n = corpus.size ();
+        std::vector<std::string> suffixes;
+        for ( std::size_t i = 0; i < n; ++i )
+            suffixes.push_back ( corpus.substr ( i ));
+        std::sort ( suffixes.begin (), suffixes.end ());
+        for ( std::size_t i = 0; i < n; ++i ) {
+            BOOST_CHECK_EQUAL ( corpus.substr ( index.suffix_array () [ i ] ), suffixes [ i ] );
+            if ( index.has_lcp ()) {
+                std::size_t expected = 0;
+                if ( i > 0 )
+                    while ( expected < suffixes [ i ].size () && suffixes [ i - 1 ][ expected ] == suffixes [ i ][ expected ] )
+                        ++expected;
+                BOOST_CHECK_EQUAL ( index.lcp () [ i ], expected );
+                }
+            }
+        }
+
+    void check_query ( const std::string &corpus, const index_type &index, const std::string &pattern ) {
+        std::vector<iter> expected;
+        const positions matches = naive_positions ( corpus, pattern );
+        for ( std::size_t i = 0; i < matches.size (); ++i )
+            expected.push_back ( corpus.begin () + matches [ i ] );
+        const iter first = pattern.empty () ? ( corpus.empty () ? corpus.end () : corpus.begin ())
+                         : ( expected.empty () ? corpus.end () : expected [ 0 ] );
+        BOOST_CHECK ( index.find_first ( pattern ) == first );
+        BOOST_CHECK ( index.find_first ( pattern.begin (), pattern.end ()) == first );
+        BOOST_CHECK_EQUAL ( index.count ( pattern ), expected.size ());
+        BOOST_CHECK_EQUAL ( index.positions ( pattern ).size (), expected.size ());
+        BOOST_CHECK ( index.find_all ( pattern ) == expected );
+        }
+
+    void check_corpus ( const std::string &corpus, int alphabet ) {
+        const index_type plain ( corpus.begin (), corpus.end ());
+        const index_type with_lcp ( corpus.begin (), corpus.end (), true );
+        BOOST_CHECK_EQUAL ( plain.size (), corpus.size ());
+        BOOST_CHECK ( !plain.has_lcp ());
+        BOOST_CHECK ( with_lcp.has_lcp () || corpus.empty ());
+        check_tables ( corpus, plain );
+        check_tables ( corpus, with_lcp );
+
+        check_query ( corpus, plain, "" );
+        for ( std::size_t len = 1; len <= 6; ++len )
+            for ( int i = 0; i < 5; ++i ) {
+                const std::string pattern = random_string ( len, alphabet );
+                check_query ( corpus, plain, pattern );
+                check_query ( corpus, with_lcp, pattern );
+                }
+        if ( corpus.size () > 10 ) {
+            const std::string inside = corpus.substr ( corpus.size () / 3, 7 );
+            check_query ( corpus, plain, inside );
+            check_query ( corpus, with_lcp, inside );
+            }
+        check_query ( corpus, with_lcp, corpus );
+        check_query ( corpus, with_lcp, corpus + "a" );
+        }
+
+    void check_save_and_load ( const std::string &corpus, bool lcp ) {
+        const index_type built ( corpus.begin (), corpus.end (), lcp );
+        std::stringstream saved;
+        built.save ( saved );
+        BOOST_CHECK ( saved );
+
+    //  Read back in
+        const index_type loaded ( corpus.begin (), corpus.end (), saved );
+        BOOST_CHECK_EQUAL ( loaded.has_lcp (), lcp );
+        BOOST_CHECK ( std::equal ( built.suffix_array (), built.suffix_array () + corpus.size (), loaded.suffix_array ()));
+        check_query ( corpus, loaded, corpus.substr ( 5, 3 ));
+
+    //  Used in place, as if it had been memory-mapped (a vector of uint64_t, for the alignment)
+        const std::string bytes = saved.str ();
+        std::vector<boost::uint64_t> image ( bytes.size () / 8 + 1 );
+        std::memcpy ( &image [ 0 ], bytes.data (), bytes.size ());
+        const index_type mapped ( corpus.begin (), corpus.end (), &image [ 0 ], bytes.size ());
+        BOOST_CHECK ( mapped.suffix_array () == reinterpret_cast<const boost::uint32_t *> ( &image [ 0 ] + 4 ));
+        BOOST_CHECK_EQUAL ( mapped.has_lcp (), lcp );
+        check_query ( corpus, mapped, corpus.substr ( 5, 3 ));
+        check_query ( corpus, mapped, "abc" );
+
+    //  Images that do not fit
+        BOOST_CHECK_THROW ( index_type ( corpus.begin (), corpus.end (), &image [ 0 ], bytes.size () - 1 ), std::invalid_argument );
+        BOOST_CHECK_THROW ( index_type ( corpus.begin (), corpus.end (), &image [ 0 ], 16 ), std::invalid_argument );
+        BOOST_CHECK_THROW ( index_type ( corpus.begin (), corpus.end () - 1, &image [ 0 ], bytes.size ()), std::invalid_argument );
+        BOOST_CHECK_THROW (( ba::suffix_array_index<iter, boost::uint64_t> ( corpus.begin (), corpus.end (), &image [ 0 ], bytes.size ())), std::invalid_argument );
+        image [ 0 ] ^= 1;
+        BOOST_CHECK_THROW ( index_type ( corpus.begin (), corpus.end (), &image [ 0 ], bytes.size ()), std::invalid_argument );
+
+        std::istringstream truncated ( bytes.substr ( 0, bytes.size () - 1 ));
+        BOOST_CHECK_THROW ( index_type ( corpus.begin (), corpus.end (), truncated ), std::runtime_error );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_corpus ( "", 2 );
+    check_corpus ( "a", 2 );
+    check_corpus ( "ab", 2 );
+    check_corpus ( "ba", 2 );
+    check_corpus ( "aaaaaaaaaaaa", 2 );
+    check_corpus ( "mississippi", 4 );
+    check_corpus ( "abracadabra", 5 );
+    check_corpus ( "abababababababab", 2 );
+
+    std::srand ( 1 );
+    for ( int alphabet = 1; alphabet <= 5; ++alphabet )
+        for ( std::size_t len = 3; len <= 300; len *= 3 )
+            check_corpus ( random_string ( len, alphabet ), alphabet );
+
+//  Bytes across the whole range, including the "negative" chars
+    std::string bytes;
+    for ( int i = 0; i < 1000; ++i )
+        bytes += static_cast<char> ( std::rand () % 256 );
+    const index_type binary ( bytes.begin (), bytes.end (), true );
+    check_tables ( bytes, binary );
+    check_query ( bytes, binary, bytes.substr ( 500, 2 ));
+    check_query ( bytes, binary, std::string ( 1, '\xff' ));
+
+//  Long runs, which the LCP walk gives up on
+    const std::string runs = std::string ( 500, 'a' ) + "b" + std::string ( 500, 'a' );
+    const index_type runs_index ( runs.begin (), runs.end (), true );
+    check_query ( runs, runs_index, "aa" );
+    check_query ( runs, runs_index, "aab" );
+
+    check_save_and_load ( random_string ( 200, 3 ), false );
+    check_save_and_load ( random_string ( 200, 3 ), true );
+
+//  The corpus must fit the index type
+    const std::string too_long ( 70000, 'a' );
+    BOOST_CHECK_THROW (( ba::suffix_array_index<iter, boost::uint16_t> ( too_long.begin (), too_long.end ())), std::length_error );
+    const ba::suffix_array_index<iter, boost::uint16_t> small ( too_long.begin (), too_long.begin () + 1000 );
+    BOOST_CHECK_EQUAL ( small.count ( std::string ( 10, 'a' )), 991U );
+
+//  uint16_t is the narrowest Index (unsigned char does not compile); it
+//  still covers all 256 byte values
+    const ba::suffix_array_index<iter, boost::uint16_t> narrow ( bytes.begin (), bytes.end ());
+    BOOST_CHECK_EQUAL ( narrow.count ( bytes.substr ( 500, 2 )), binary.count ( bytes.substr ( 500, 2 )));
+    BOOST_CHECK_EQUAL ( narrow.count ( std::string ( 1, '\xff' )), binary.count ( std::string ( 1, '\xff' )));
+    BOOST_CHECK ( std::equal ( narrow.suffix_array (), narrow.suffix_array () + bytes.size (), binary.suffix_array ()));
+
+//  A pattern longer than Index can hold is not truncated into a short one
+    const std::string too_long_pattern ( 65537, 'a' );
+    BOOST_CHECK_EQUAL ( small.count ( too_long_pattern ), 0U );
+    BOOST_CHECK ( small.find_first ( too_long_pattern ) == too_long.begin () + 1000 );
+    BOOST_CHECK ( small.find_all ( too_long_pattern ).empty ());
+}
@@ -0,0 +1,76 @@
+/*
+   Copyright (c) Marshall Clow 2010-2012.
+
+   Distributed under the Boost Software License, Version 1.0. (See accompanying
+   file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+    For more information, see http://www.boost.org
+
+    Testing the Two-Way searcher
+*/
+
+#include <boost/algorithm/searching/two_way.hpp>
+
+#define BOOST_TEST_MAIN
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+
+#include "search_test.hpp"
+
+namespace ba = boost::algorithm;
+
+namespace {
+
+    void check_one ( const std::string &corpus, const std::string &pattern ) {
+        typedef std::string::const_iterator iter;
+        const iter expected = std::search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ());
+
+        ba::two_way<iter> tw ( pattern.begin (), pattern.end ());
+        check_matches ( tw, corpus, pattern );
+        BOOST_CHECK ( ba::two_way_search ( corpus.begin (), corpus.end (), pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::two_way_search ( corpus.begin (), corpus.end (), pattern ) == expected );
+        BOOST_CHECK ( ba::two_way_search ( corpus, pattern.begin (), pattern.end ()) == expected );
+        BOOST_CHECK ( ba::two_way_search ( corpus, pattern ) == expected );
+        BOOST_CHECK ( ba::make_two_way ( pattern ) ( corpus ) == expected );
+        }
+    }
+
+BOOST_AUTO_TEST_CASE( test_main )
+{
+    check_one ( "abracadabra", "abra" );
+    check_one ( "abracadabra", "cad" );
+    check_one ( "abracadabra", "abracadabra" );
+    check_one ( "abracadabra", "abracadabrax" );
+    check_one ( "abracadabra", "" );
+    check_one ( "", "abra" );
+    check_one ( "", "" );
+    check_one ( "aaaaaaaaaa", "aa" );
+    check_one ( "aaaaaaaaab", "aab" );
+    check_one ( "abababababab", "abab" );
+    check_one ( "abcabcabcabcab", "abcab" );
+    check_one ( "zzzzzzzazzzzzzzz", "zzzzza" );
+
+//  Periodic and non-periodic patterns over small alphabets
+    std::srand ( 1 );
+    for ( std::size_t pat_len = 1; pat_len <= 16; ++pat_len )
+        for ( int alphabet = 1; alphabet <= 4; ++alphabet )
+            for ( int i = 0; i < 10; ++i ) {
+                const std::string corpus = random_string ( 400, alphabet );
+                check_one ( corpus, random_string ( pat_len, alphabet ));
+            //  ... and a pattern that is certain to be in there
+                const std::size_t pos = std::rand () % ( corpus.size () - pat_len );
+                check_one ( corpus, corpus.substr ( pos, pat_len ));
+                }
+
+//  Non-character data
+    std::vector<int> corpus, pattern;
+    for ( int i = 0; i < 100; ++i )
+        corpus.push_back ( i % 7 );
+    pattern.push_back ( 5 );
+    pattern.push_back ( 6 );
+    pattern.push_back ( 0 );
+    BOOST_CHECK ( ba::two_way_search ( corpus, pattern ) == corpus.begin () + 5 );
+}